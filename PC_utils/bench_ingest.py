@@ -0,0 +1,191 @@
+"""
+Ingest benchmark: replays device traffic through a pseudo-terminal and compares the legacy
+per-line reader (readline + json.loads + lock per line) with the block-based IngestEngine.
+
+    python bench_ingest.py                         # synthetic traffic, 16 channels, 50000 frames
+    python bench_ingest.py --channels 64 --frames 20000
+    python bench_ingest.py --replay capture.bin    # raw bytes recorded from the port
+
+POSIX only (os.openpty). Uses pyserial on the pty slave when it is installed, so both readers see
+the same driver as on a real port; otherwise falls back to plain file descriptor reads.
+"""
+
+import argparse
+import base64
+import fcntl
+import json
+import os
+import random
+import struct
+import termios
+import threading
+import time
+import tty
+
+from ingest import FdSource, IngestEngine, SerialSource
+
+try:
+    import serial
+except ImportError:
+    serial = None
+
+
+def synthetic_traffic(channels, frames, seed=1):
+    """Heartbeats with partial frames, binary log records and console text mixed in, as the firmware sends them."""
+    rng = random.Random(seed)
+    names = [f"T{i + 1}" for i in range(channels)]
+    temps = [25.0 + i for i in range(channels)]
+    out = []
+    seq = 0
+    for n in range(frames):
+        temps = [round(t + rng.uniform(-0.05, 0.05), 2) for t in temps]
+        if n % 10 == 0:
+            out.append(json.dumps({"names": names, "temperatures": temps}, separators=(",", ":")))
+        else:
+            picked = sorted(rng.sample(range(channels), max(1, channels // 4)))
+            out.append(json.dumps({"names": [names[i] for i in picked], "temperatures": [temps[i] for i in picked], "partial": True},
+                                  separators=(",", ":")))
+        if n % 50 == 0:
+            words = struct.pack("<iiiff", 1, 2048, 1650, 10000.0, temps[0])
+            record = struct.pack("<BBHI", 1, 5, seq & 0xFFFF, n * 1000) + words + bytes(4)
+            out.append("$L" + base64.b64encode(record).decode())
+            seq += 1
+        if n % 500 == 0:
+            out.append(f"I ({n}) temp_comp: measurement cycle {n}")
+    return ("\n".join(out) + "\n").encode()
+
+
+def open_pty():
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    if serial is not None:
+        port = serial.Serial(os.ttyname(slave), timeout=0.05)
+        os.close(slave)
+        return master, port
+    return master, slave
+
+
+def writer(master, traffic, chunk=4096):
+    view = memoryview(traffic)
+    for offset in range(0, len(view), chunk):
+        data = view[offset:offset + chunk]
+        while data:
+            written = os.write(master, data)
+            data = data[written:]
+
+
+class FdLinePort:
+    """Minimal stand-in for pyserial's in_waiting / readline() (which reads one byte at a time)."""
+
+    def __init__(self, fd):
+        self.fd = fd
+
+    @property
+    def in_waiting(self):
+        return struct.unpack("i", fcntl.ioctl(self.fd, termios.FIONREAD, b"\0\0\0\0"))[0]
+
+    def readline(self):
+        line = bytearray()
+        while True:
+            c = os.read(self.fd, 1)
+            line += c
+            if not c or c == b"\n":
+                return bytes(line)
+
+
+def run_legacy(port, expected_lines):
+    """The reader loop py_serial_comm_v2.py used before the ingest engine."""
+    lock = threading.Lock()
+    data, config = [], []
+    lines = 0
+    while lines < expected_lines:
+        if port.in_waiting > 0:
+            line_bytes = port.readline()
+            lines += 1
+            line_str = line_bytes.decode("utf-8").strip()
+            if line_str.startswith("$L"):
+                continue
+            try:
+                data_point = json.loads(line_str)
+            except json.JSONDecodeError:
+                continue
+            with lock:
+                data_point["timestamp_ms"] = time.time_ns() // 1_000_000
+                (data if "temperatures" in data_point else config).append(data_point)
+        else:
+            time.sleep(0.01)
+    return len(data)
+
+
+def run_engine(source, expected_lines):
+    engine = IngestEngine()
+    data = []
+    lock = threading.Lock()
+    done = threading.Event()
+
+    def consume():
+        while not done.is_set() or not engine.batches.empty():
+            try:
+                batch = engine.batches.get(timeout=0.05)
+            except Exception:
+                continue
+            with lock:
+                data.extend(batch.samples)
+
+    consumer = threading.Thread(target=consume)
+    consumer.start()
+    while engine.stats["lines"] < expected_lines:
+        block = source.read()
+        if block:
+            engine.feed(block)
+    done.set()
+    consumer.join()
+    return len(data)
+
+
+def bench(name, traffic, reader):
+    master, port = open_pty()
+    expected_lines = traffic.count(b"\n")
+    feeder = threading.Thread(target=writer, args=(master, traffic))
+    start = time.perf_counter()
+    feeder.start()
+    samples = reader(port, expected_lines)
+    elapsed = time.perf_counter() - start
+    feeder.join()
+    os.close(master)
+    if serial is not None:
+        port.close()
+    else:
+        os.close(port)
+    print(f"{name:8s} {elapsed:7.3f} s  {expected_lines / elapsed:10.0f} lines/s  {len(traffic) / elapsed / 1e6:7.2f} MB/s  {samples} samples")
+    return elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--replay", help="raw capture of the device stream")
+    parser.add_argument("--channels", type=int, default=16)
+    parser.add_argument("--frames", type=int, default=50000)
+    args = parser.parse_args()
+
+    if args.replay:
+        with open(args.replay, "rb") as f:
+            traffic = f.read()
+        if not traffic.endswith(b"\n"):
+            traffic = traffic[:traffic.rfind(b"\n") + 1]
+    else:
+        traffic = synthetic_traffic(args.channels, args.frames)
+    lines = traffic.count(b"\n")
+    print(f"{len(traffic) / 1e6:.2f} MB, {lines} lines, reader: {'pyserial' if serial else 'fd'}")
+
+    if serial is not None:
+        legacy = bench("legacy", traffic, run_legacy)
+        engine = bench("engine", traffic, lambda port, n: run_engine(SerialSource(port), n))
+    else:
+        legacy = bench("legacy", traffic, lambda fd, n: run_legacy(FdLinePort(fd), n))
+        engine = bench("engine", traffic, lambda fd, n: run_engine(FdSource(fd), n))
+    print(f"speedup  {legacy / engine:.1f}x")
+
+
+if __name__ == "__main__":
+    main()
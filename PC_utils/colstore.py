@@ -0,0 +1,195 @@
+"""
+Append-only columnar storage for temperature samples.
+
+A store is a directory of segments. Each segment holds one fixed-width file per column:
+timestamp.i64 (int64 ms since the epoch) and cNNN.f32 (float32 per channel, NaN when a channel
+is missing from a frame), plus meta.json with the channel names, row count and first/last
+timestamp. meta.json doubles as the segment index: a time-range read skips segments by their
+bounds and bisects the sorted timestamp column of the rest, so nothing has to be loaded whole.
+
+Rows are buffered in memory and appended with one write per column every flush_rows rows (or
+on flush()). A new segment starts after rows_per_segment rows or when the channel set changes.
+The files are plain little-endian arrays, so numpy.memmap(path, dtype='<f4') reads them directly.
+"""
+
+import bisect
+import json
+import math
+import mmap
+import os
+import struct
+import sys
+import time
+from array import array
+
+ROWS_PER_SEGMENT = 1_000_000
+FLUSH_ROWS = 256
+FLUSH_INTERVAL_S = 2.0
+
+_NATIVE_LE = sys.byteorder == "little"
+
+
+def _append_column(path, values):
+    if not _NATIVE_LE:
+        values = array(values.typecode, values)
+        values.byteswap()
+    with open(path, "ab") as f:
+        values.tofile(f)
+
+
+def _read_column(path, typecode, start, stop):
+    width = array(typecode).itemsize
+    values = array(typecode)
+    with open(path, "rb") as f:
+        f.seek(start * width)
+        values.frombytes(f.read((stop - start) * width))
+    if not _NATIVE_LE:
+        values.byteswap()
+    return values
+
+
+def _column_name(index):
+    return f"c{index:03d}.f32"
+
+
+class _TimestampColumn:
+    """Sequence view over a timestamp.i64 file, so bisect can search it without loading it."""
+
+    def __init__(self, path, rows):
+        self.rows = rows
+        self._file = open(path, "rb")
+        self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ) if rows else None
+
+    def __len__(self):
+        return self.rows
+
+    def __getitem__(self, i):
+        return struct.unpack_from("<q", self._map, i * 8)[0]
+
+    def close(self):
+        if self._map is not None:
+            self._map.close()
+        self._file.close()
+
+
+class ColumnStore:
+    def __init__(self, directory, rows_per_segment=ROWS_PER_SEGMENT, flush_rows=FLUSH_ROWS, flush_interval_s=FLUSH_INTERVAL_S):
+        self.directory = directory
+        self.rows_per_segment = rows_per_segment
+        self.flush_rows = flush_rows
+        self.flush_interval_s = flush_interval_s
+        os.makedirs(directory, exist_ok=True)
+        self.segments = self._load_index()
+        self.session_start = len(self.segments)   # Segments from index session_start on were written by this instance
+        self._segment = None        # meta dict of the segment being appended to
+        self._timestamps = array("q")
+        self._columns = []
+        self._last_flush = time.monotonic()
+
+    def _load_index(self):
+        segments = []
+        for entry in sorted(os.listdir(self.directory)):
+            meta_path = os.path.join(self.directory, entry, "meta.json")
+            if entry.startswith("seg_") and os.path.isfile(meta_path):
+                with open(meta_path, encoding="utf-8") as f:
+                    meta = json.load(f)
+                meta["path"] = os.path.join(self.directory, entry)
+                segments.append(meta)
+        return segments
+
+    def _write_meta(self, meta):
+        tmp = os.path.join(meta["path"], "meta.json.tmp")
+        with open(tmp, "w", encoding="utf-8") as f:
+            json.dump({k: v for k, v in meta.items() if k != "path"}, f)
+        os.replace(tmp, os.path.join(meta["path"], "meta.json"))   # Readers never see a half-written index
+
+    def _open_segment(self, names):
+        number = int(os.path.basename(self.segments[-1]["path"])[4:]) + 1 if self.segments else 1
+        path = os.path.join(self.directory, f"seg_{number:06d}")
+        os.makedirs(path)
+        meta = {"names": list(names), "rows": 0, "first_ms": None, "last_ms": None, "path": path}
+        self._write_meta(meta)
+        self.segments.append(meta)
+        self._segment = meta
+        self._columns = [array("f") for _ in names]
+
+    def append(self, samples):
+        """Append full frames ({'names', 'temperatures', 'timestamp_ms'}), in arrival order."""
+        for sample in samples:
+            names = sample["names"]
+            segment = self._segment
+            if (segment is None or names != segment["names"]
+                    or segment["rows"] + len(self._timestamps) >= self.rows_per_segment):
+                self.flush()
+                self._open_segment(names)
+            self._timestamps.append(sample["timestamp_ms"])
+            for column, value in zip(self._columns, sample["temperatures"]):
+                column.append(math.nan if value is None else value)
+        if len(self._timestamps) >= self.flush_rows or time.monotonic() - self._last_flush >= self.flush_interval_s:
+            self.flush()
+
+    def flush(self):
+        """Write buffered rows to the current segment and update its index entry."""
+        self._last_flush = time.monotonic()
+        if not self._timestamps:
+            return
+        meta = self._segment
+        _append_column(os.path.join(meta["path"], "timestamp.i64"), self._timestamps)
+        for index, column in enumerate(self._columns):
+            _append_column(os.path.join(meta["path"], _column_name(index)), column)
+        if meta["first_ms"] is None:
+            meta["first_ms"] = self._timestamps[0]
+        meta["last_ms"] = self._timestamps[-1]
+        meta["rows"] += len(self._timestamps)
+        self._write_meta(meta)
+        self._timestamps = array("q")
+        self._columns = [array("f") for _ in self._columns]
+
+    def close(self):
+        self.flush()
+        self._segment = None
+
+    def read_range(self, start_ms, end_ms):
+        """
+        Yields (names, timestamps, columns) per segment overlapping [start_ms, end_ms], with
+        timestamps an array('q') and columns one array('f') per channel. Only flushed rows are visible.
+        """
+        for meta in self.segments:
+            if not meta["rows"] or meta["last_ms"] < start_ms or meta["first_ms"] > end_ms:
+                continue
+            timestamps = _TimestampColumn(os.path.join(meta["path"], "timestamp.i64"), meta["rows"])
+            try:
+                lo = bisect.bisect_left(timestamps, start_ms)
+                hi = bisect.bisect_right(timestamps, end_ms)
+            finally:
+                timestamps.close()
+            if lo >= hi:
+                continue
+            columns = [_read_column(os.path.join(meta["path"], _column_name(i)), "f", lo, hi) for i in range(len(meta["names"]))]
+            yield meta["names"], _read_column(os.path.join(meta["path"], "timestamp.i64"), "q", lo, hi), columns
+
+    def read_since(self, cursor=None):
+        """
+        Incremental read for live consumers: returns ([(names, timestamps, columns), ...], new_cursor)
+        with the rows flushed since cursor. Pass None to start at the first segment of this session.
+        Safe to call from another thread than the writer, since row counts are published after the data.
+        """
+        segment_index, row = cursor if cursor is not None else (self.session_start, 0)
+        chunks = []
+        while segment_index < len(self.segments):
+            meta = self.segments[segment_index]
+            rows = meta["rows"]
+            if rows > row:
+                columns = [_read_column(os.path.join(meta["path"], _column_name(i)), "f", row, rows) for i in range(len(meta["names"]))]
+                chunks.append((meta["names"], _read_column(os.path.join(meta["path"], "timestamp.i64"), "q", row, rows), columns))
+                row = rows
+            if segment_index + 1 >= len(self.segments):
+                break
+            segment_index, row = segment_index + 1, 0
+        return chunks, (segment_index, row)
+
+    def summary(self):
+        rows = sum(meta["rows"] for meta in self.segments) + len(self._timestamps)
+        spans = [(meta["first_ms"], meta["last_ms"]) for meta in self.segments if meta["rows"]]
+        return {"directory": self.directory, "segments": len(self.segments), "rows": rows,
+                "first_ms": spans[0][0] if spans else None, "last_ms": spans[-1][1] if spans else None}
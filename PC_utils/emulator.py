@@ -0,0 +1,1252 @@
+"""
+Thermistron device emulator: speaks the serial_comp command set and stream formats on a
+pseudo-terminal, so the host tools can be exercised and load-tested without a board.
+
+    python emulator.py                                  # prints the pty path to open, e.g. /dev/pts/5
+    python emulator.py --slots 64 --channels 64 --min-interval-ms 0 --stream
+    python emulator.py --drop-bytes 0.001 --garbage 0.01 --stall-every 30 --stall-ms 2000 --fault open:2:20
+
+The replies are formatted like the firmware's snprintf calls (same keys, spacing and precision),
+commands are echoed byte by byte and console log lines ("I (ms) tag: ...") are interleaved as on
+the USB Serial/JTAG port. Each channel follows a realistic thermistor curve (slow drift, heating
+ramps with exponential cool-down, noise), converted to a 12-bit divider code and back through the
+slot's configured divider, calibration offset and model, so quantization and mis-configuration
+show up as on hardware. Simplifications: the filter chain and the adaptive controller only
+store and report their configuration (samples pass through unfiltered at the fixed interval),
+power statistics report zeros, raw subscriptions describe uncalibrated ADC units (no "$C" tables), and burst and noise captures sample the true temperature of the
+last measurement tick plus code noise and a 50 Hz pickup, at a fixed rate without scheduler gaps.
+
+Faults: --drop-bytes (per-byte probability), --garbage (per-line probability of a junk line),
+--stall-every/--stall-ms (output pauses), --fault open|short:<index>:<after_s> (probe failure).
+--min-interval-ms below the firmware's 100 ms (0: back to back) and --link-bps drive the link
+up to saturation.
+"""
+
+import argparse
+import base64
+import cmath
+import math
+import os
+import random
+import select
+import struct
+import sys
+import time
+import tty
+
+MIN_SAMPLING_INTERVAL_MS = 100
+MAX_SAMPLING_INTERVAL_MS = 3600000
+MAX_ADC = 4095
+DEFAULT_CAL_R_STEP = 50
+MAX_CAL_R_OFFSET = 5000
+MAX_CAL_POINTS = 3
+MAX_FILTER_MEDIAN_WINDOW = 7
+MAX_STATS_WINDOW_SAMPLES = 100000
+MAX_ADAPTIVE_CALM_CYCLES = 10000
+MAX_MUX_SETTLE_US = 10000
+KELVIN_OFFSET = 273.15
+T25_K = 298.15
+HEALTH_DEBOUNCE = 3
+MAX_STREAM_SUBS = 4
+STREAM_SUB_NAME_LEN = 12
+STREAM_SUB_MAX_DIVISOR = 3600
+STREAM_SUB_FORMATS = ("json", "bin", "stats", "raw")
+STREAM_SUB_BIN_NAN = -32768
+TEMP_RAW_CODE_NONE = 0x0FFF
+# boot_prof phases; the emulated board reaches all but the first sample at these fixed times (us)
+BOOT_PHASES = (("app_main", 281000), ("log", 281400), ("config", 283900), ("temp", 290200), ("acquisition", 290500),
+               ("first_sample", None), ("serial_init", 287600), ("serial_ready", 290600))
+# Burst capture: ring of a build without PSRAM, emulated back-to-back oneshot rate, dump chunk size
+BURST_CAPACITY = 8192
+BURST_PERIOD_NS = 24000
+BURST_CHUNK_SAMPLES = 512
+BURST_STATES = ("idle", "armed", "triggered", "done")
+# temp_noise.h; plus the mains pickup the emulated raw samples carry
+NOISE_SAMPLES = 1024
+NOISE_PERIOD_US = 1000
+NOISE_PEAKS = 3
+NOISE_PEAK_RATIO = 10.0
+MAINS_HZ = 50.0
+MAINS_PICKUP_LSB = 1.2
+
+ESP_OK = "ESP_OK"
+ESP_FAIL = "ESP_FAIL"
+ESP_ERR_INVALID_ARG = "ESP_ERR_INVALID_ARG"
+ESP_ERR_INVALID_STATE = "ESP_ERR_INVALID_STATE"
+ESP_ERR_NO_MEM = "ESP_ERR_NO_MEM"
+ESP_ERR_NOT_FOUND = "ESP_ERR_NOT_FOUND"
+ESP_ERR_NOT_SUPPORTED = "ESP_ERR_NOT_SUPPORTED"
+
+HELP_TEXT = None    # Read from serial_comp.c at startup so the emulator never drifts from the firmware
+
+
+def f32(value):
+    """Round to float32, as the firmware stores it."""
+    return struct.unpack("<f", struct.pack("<f", value))[0]
+
+
+def load_help_text():
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "components", "serial_comp", "src", "serial_comp.c")
+    try:
+        with open(path, encoding="utf-8") as f:
+            source = f.read()
+        block = source[source.index('serial_comp_send(\n                    "Available commands'):]
+        block = block[:block.index(");")]
+        lines = [line.strip()[1:-1] for line in block.splitlines()[1:] if line.strip().startswith('"')]
+        return "".join(lines).encode().decode("unicode_escape").rstrip("\n")
+    except (OSError, ValueError):
+        return "Available commands:\n  help - Show this help message"
+
+
+class Slot:
+    def __init__(self, name, divider_r, adc_channel):
+        self.name = name
+        self.divider_r = divider_r
+        self.adc_channel = adc_channel
+        self.adc_unit = 1
+        self.mux_address = -1
+        self.cal_r = 0
+        self.model = {"type": "sh", "a": f32(0.001129148), "b": f32(0.000234125), "c": f32(0.0000000876741),
+                      "beta": f32(3950.0), "r25": f32(10000.0)}
+        self.filter = {"median": 0, "iir_alpha": 0.0, "kalman_q": 0.0, "kalman_r": 0.0}
+        self.alarm = {"enabled": False, "low_c": 0.0, "high_c": 0.0, "hysteresis_c": 0.0, "max_rate_c_per_min": 0.0}
+        self.alarm_active = {"high": False, "low": False, "rate": False}
+        self.cal_points = []
+        self.raw_code = TEMP_RAW_CODE_NONE
+        self.reset_runtime()
+
+    def reset_runtime(self):
+        self.temperature = math.nan
+        self.resistance = math.nan
+        self.health = "ok"
+        self.faults = 0
+        self.fault_run = 0
+        self.last_rate_sample = None    # (t_s, temperature) for the rate alarm
+
+    @property
+    def active(self):
+        return self.name not in ("", "UNUSED")
+
+    def conversion_k(self):
+        """temp_model_build()'s float32 k0, k1, k3."""
+        m = self.model
+        if m["type"] == "beta":
+            return f32(1.0 / T25_K - math.log(m["r25"]) / m["beta"]), f32(1.0 / m["beta"]), 0.0
+        return m["a"], m["b"], m["c"]
+
+    def to_celsius(self, resistance):
+        if not resistance > 0:
+            return math.nan
+        k0, k1, k3 = self.conversion_k()
+        log_r = math.log(resistance)
+        return f32(1.0 / (k0 + k1 * log_r + k3 * log_r ** 3) - KELVIN_OFFSET)
+
+
+class Physics:
+    """True temperature of each channel over time, and the NTC resistance it produces."""
+
+    def __init__(self, channels, seed):
+        self.rng = random.Random(seed)
+        self.base = [21.0 + 1.5 * i + self.rng.uniform(-0.5, 0.5) for i in range(channels)]
+        self.phase = [self.rng.uniform(0, 2 * math.pi) for _ in range(channels)]
+        self.ramps = [[] for _ in range(channels)]      # (start_s, rise_c, rise_s, tau_s)
+        self.faults = {}                                # channel -> (kind, after_s)
+
+    def temperature(self, channel, t):
+        if channel >= len(self.base):
+            return 25.0
+        if not self.ramps[channel] or t - self.ramps[channel][-1][0] > 240:
+            if self.rng.random() < 0.002:
+                self.ramps[channel].append((t, self.rng.uniform(3, 15), self.rng.uniform(10, 60), self.rng.uniform(30, 120)))
+                self.ramps[channel] = self.ramps[channel][-4:]
+        value = self.base[channel] + 0.4 * math.sin(2 * math.pi * t / 600 + self.phase[channel])
+        for start, rise, rise_s, tau in self.ramps[channel]:
+            dt = t - start
+            if dt < 0:
+                continue
+            value += rise * dt / rise_s if dt < rise_s else rise * math.exp(-(dt - rise_s) / tau)
+        return value
+
+    @staticmethod
+    def ntc_resistance(temperature_c):
+        """Inverse of the generic 10k Steinhart-Hart curve (Newton on ln R)."""
+        a, b, c = 0.001129148, 0.000234125, 0.0000000876741
+        y = 1.0 / (temperature_c + KELVIN_OFFSET)
+        log_r = math.log(10000.0)
+        for _ in range(8):
+            log_r -= (a + b * log_r + c * log_r ** 3 - y) / (b + 3 * c * log_r ** 2)
+        return math.exp(log_r)
+
+    def adc_code(self, channel, t, divider_r):
+        fault = self.faults.get(channel)
+        if fault is not None and t >= fault[1]:
+            return MAX_ADC if fault[0] == "open" else 0
+        resistance = self.ntc_resistance(self.temperature(channel, t)) * (1 + self.rng.gauss(0, 0.0002))
+        code = round(MAX_ADC * resistance / (resistance + divider_r) + self.rng.gauss(0, 0.7))
+        return min(max(code, 0), MAX_ADC)
+
+
+class LinkWriter:
+    """Everything leaving the 'board', with optional byte-rate pacing and fault injection."""
+
+    def __init__(self, fd, args, rng):
+        self.fd = fd
+        self.args = args
+        self.rng = rng
+        self.bytes_per_s = args.link_bps / 10.0 if args.link_bps else 0   # 8N1
+        self.budget_t = time.monotonic()
+        self.next_stall = time.monotonic() + args.stall_every if args.stall_every else math.inf
+
+    def write(self, data):
+        now = time.monotonic()
+        if now >= self.next_stall:
+            time.sleep(self.args.stall_ms / 1000.0)
+            self.next_stall = time.monotonic() + self.args.stall_every
+        if self.args.drop_bytes:
+            data = bytes(b for b in data if self.rng.random() >= self.args.drop_bytes)
+        if self.bytes_per_s:
+            self.budget_t = max(self.budget_t, now) + len(data) / self.bytes_per_s
+            delay = self.budget_t - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+        view = memoryview(data)
+        while view:
+            try:
+                written = os.write(self.fd, view)
+            except BlockingIOError:
+                select.select([], [self.fd], [], 0.1)
+                continue
+            view = view[written:]
+
+    def send(self, text):
+        """serial_comp_send(): the text plus a newline; may be preceded by a junk line."""
+        if self.args.garbage and self.rng.random() < self.args.garbage:
+            junk = bytes(self.rng.randrange(1, 256) for _ in range(self.rng.randrange(1, 40)))
+            self.write(junk.replace(b"\n", b"") + b"\n")
+        self.write(text.encode() + b"\n")
+
+
+class Board:
+    def __init__(self, args, out):
+        self.args = args
+        self.out = out
+        self.boot = time.monotonic()
+        defaults = [("Therm1", 9782), ("Therm2", 9795), ("Therm3", 9888), ("Therm4", 9963), ("Therm5", 10233)]
+        self.slots = []
+        for i in range(args.slots):
+            if i < args.channels:
+                name, divider = defaults[i] if i < len(defaults) else (f"Therm{i + 1}", 10000)
+                self.slots.append(Slot(name, divider, i % 10))
+            else:
+                self.slots.append(Slot("UNUSED", 10000, 5))
+        self.physics = Physics(args.slots, args.seed)
+        for spec in args.fault:
+            kind, index, after_s = spec.split(":")
+            self.physics.faults[int(index) - 1] = (kind, float(after_s))
+        self.sampling_interval_ms = 1000
+        self.serial_stream_active = args.stream
+        self.log_temps_active = False
+        self.low_power = False
+        self.stream_mode = "full"
+        self.deadband_abs_c = f32(0.1)
+        self.deadband_rel = 0.0
+        self.heartbeat_ms = 60000
+        self.stats_window = 60
+        self.adaptive = {"enabled": False, "min_ms": 200, "max_ms": 10000, "rate_c_per_min": 2.0, "stddev_c": 0.5,
+                         "hysteresis": 0.5, "calm_cycles": 10}
+        self.mux_settle_us = 50
+        self.log_mode = "text"
+        self.log_seq = 0
+        self.log_stats = {"binary_queued": 0, "binary_dropped": 0, "rate_suppressed": 0}
+        self.last_reported = {}
+        self.last_heartbeat = None
+        self.stats_acc = {}
+        self.stats_count = 0
+        self.stats_seq = 0
+        self.stats_last = None
+        self.stats_last_streamed = 0
+        self.cycle = 0
+        self.subs = [None] * MAX_STREAM_SUBS
+        self.conversion = None              # (generation, per-slot conversion inputs) for the raw descriptors
+        self.boot_us = dict(BOOT_PHASES)
+        self.boot_reported = False
+        self.burst = {"state": "idle", "index": -1, "capture": 0, "pre": 0, "post": 0, "trigger": "command", "level": 0.0,
+                      "manual": False, "edge": None, "level_code": 0, "ring": [], "codes": [], "previous": None, "pre_count": 0,
+                      "request": False}
+        self.burst_t = time.monotonic()
+        self.rx = b""
+
+    # --- console helpers ---
+
+    def uptime_ms(self):
+        return int((time.monotonic() - self.boot) * 1000)
+
+    def log(self, level, tag, message):
+        self.out.write(f"{level} ({self.uptime_ms()}) {tag}: {message}\n".encode())
+
+    def send(self, text):
+        self.out.send(text)
+
+    # --- measurement ---
+
+    def measure(self):
+        t = time.monotonic() - self.boot
+        for index, slot in enumerate(self.slots):
+            slot.raw_code = TEMP_RAW_CODE_NONE
+            if not slot.active:
+                continue
+            code = self.physics.adc_code(index, t, slot.divider_r)
+            slot.raw_code = code
+            if code <= 0 or code >= MAX_ADC:
+                slot.fault_run += 1
+                slot.temperature = slot.resistance = math.nan
+                slot.health = ("short" if code <= 0 else "open") if slot.fault_run >= HEALTH_DEBOUNCE else "suspect"
+                if slot.fault_run == HEALTH_DEBOUNCE:
+                    slot.faults += 1
+                continue
+            slot.fault_run = 0
+            slot.health = "ok"
+            slot.resistance = f32(slot.divider_r * code / (MAX_ADC - code) + slot.cal_r)
+            slot.temperature = slot.to_celsius(slot.resistance)
+            if self.log_temps_active:
+                self.log_sample(index, slot, code)
+            self.check_alarms(index, slot, t)
+        self.cycle += 1
+        if self.boot_us["first_sample"] is None:
+            self.boot_us["first_sample"] = self.boot_us["acquisition"] + 1800 + int((time.monotonic() - self.boot) * 1e6)
+        self.accumulate_stats()
+
+    def log_sample(self, index, slot, code):
+        if self.log_mode == "binary":
+            words = struct.pack("<iiiff", index + 1, code, -1, slot.resistance, slot.temperature)
+            record = struct.pack("<BBHI", 1, 5, self.log_seq & 0xFFFF, (self.uptime_ms() * 1000) & 0xFFFFFFFF) + words + bytes(4)
+            self.log_seq += 1
+            self.log_stats["binary_queued"] += 1
+            self.send("$L" + base64.b64encode(record).decode())
+        else:
+            self.log("I", "temp_comp", "Thermistor %s: ADC %d (%d mV), Rth %.2f Ohm (incl. calibration offset: %d Ohm), Temp: %.2f C"
+                     % (slot.name, code, -1, slot.resistance, slot.cal_r, slot.temperature))
+
+    def check_alarms(self, index, slot, t):
+        alarm, active = slot.alarm, slot.alarm_active
+        value = slot.temperature
+        if alarm["enabled"]:
+            for kind, raised, cleared in (("high", value > alarm["high_c"], value < alarm["high_c"] - alarm["hysteresis_c"]),
+                                          ("low", value < alarm["low_c"], value > alarm["low_c"] + alarm["hysteresis_c"])):
+                if not active[kind] and raised or active[kind] and cleared:
+                    active[kind] = not active[kind]
+                    self.send_alarm(index, slot, kind, active[kind], value)
+        if alarm["max_rate_c_per_min"] > 0 and slot.last_rate_sample is not None:
+            t0, v0 = slot.last_rate_sample
+            rate = abs(value - v0) / max(t - t0, 1e-3) * 60
+            if (rate > alarm["max_rate_c_per_min"]) != active["rate"]:
+                active["rate"] = not active["rate"]
+                self.send_alarm(index, slot, "rate", active["rate"], rate)
+        slot.last_rate_sample = (t, value)
+
+    def send_alarm(self, index, slot, kind, raised, value):
+        self.send('{"alarm":{"index":%d, "name":"%s", "type":"%s", "raised":%s, "value":%.2f}}'
+                  % (index + 1, slot.name, kind, "true" if raised else "false", value))
+
+    def accumulate_stats(self):
+        for index, slot in enumerate(self.slots):
+            if not slot.active:
+                continue
+            acc = self.stats_acc.setdefault(index, [0, math.inf, -math.inf, 0.0, 0.0])
+            value = slot.temperature
+            if math.isfinite(value):
+                acc[0] += 1
+                acc[1], acc[2] = min(acc[1], value), max(acc[2], value)
+                delta = value - acc[3]
+                acc[3] += delta / acc[0]
+                acc[4] += delta * (value - acc[3])
+        self.stats_count += 1
+        if self.stats_count >= self.stats_window:
+            self.stats_seq += 1
+            self.stats_last = (self.stats_seq, self.stats_count, dict(self.stats_acc))
+            self.stats_acc, self.stats_count = {}, 0
+
+    # --- stream formats ---
+
+    def active_indices(self):
+        return [i for i, slot in enumerate(self.slots) if slot.active]
+
+    def temps_json(self, indices, partial):
+        text = '{"names":[%s],"temperatures":[%s]' % (",".join('"%s"' % self.slots[i].name for i in indices),
+                                                       ",".join("%.2f" % self.slots[i].temperature for i in indices))
+        if not partial and any(self.slots[i].health != "ok" for i in indices):
+            text += ',"health":[%s]' % ",".join('"%s"' % self.slots[i].health for i in indices)
+        return text + (',"partial":true}' if partial else "}")
+
+    def send_latest_temps(self):
+        indices = self.active_indices()
+        if indices:
+            frame = self.temps_json(indices, False)
+            self.send(frame)
+            return frame
+        return ""
+
+    def stream_tick(self):
+        if not self.serial_stream_active:
+            self.last_heartbeat = None
+            return
+        if self.stream_mode == "change":
+            now = time.monotonic()
+            heartbeat_due = self.last_heartbeat is None or (now - self.last_heartbeat) * 1000 >= self.heartbeat_ms
+            mask = []
+            for i in self.active_indices():
+                value, last = self.slots[i].temperature, self.last_reported.get(i, math.nan)
+                if heartbeat_due or self.exceeds_deadband(last, value):
+                    mask.append(i)
+                    self.last_reported[i] = value
+            if heartbeat_due:
+                self.last_heartbeat = now
+            if mask:
+                self.send(self.temps_json(mask, not heartbeat_due))
+        elif self.stream_mode == "stats":
+            self.last_heartbeat = None
+            self.send_stats(only_new=True)
+        else:
+            self.last_heartbeat = None
+            self.send_latest_temps()
+
+    def boot_json(self):
+        return '{"boot":{%s}}' % ", ".join('"%s_us":%s' % (name, "null" if self.boot_us[name] is None else self.boot_us[name])
+                                            for name, _ in BOOT_PHASES)
+
+    def boot_tick(self):
+        if not self.boot_reported and None not in self.boot_us.values():
+            self.boot_reported = True
+            self.send(self.boot_json())
+
+    def burst_tick(self):
+        """The burst sampler: every sample since the previous tick goes through temp_burst_push()."""
+        now = time.monotonic()
+        count = min(int((now - self.burst_t) * 1e9 / BURST_PERIOD_NS), BURST_CAPACITY)
+        self.burst_t = now
+        b = self.burst
+        if b["state"] not in ("armed", "triggered"):
+            return
+        slot = self.slots[b["index"]]
+        center = self.physics.adc_code(b["index"], now - self.boot, slot.divider_r)
+        for n in range(count):
+            self.burst_push(self.raw_sample(center, now + n * BURST_PERIOD_NS * 1e-9), b["request"])
+            b["request"] = False
+            if b["state"] == "done":
+                self.log("I", "temp_comp", "Burst capture %d done: %d samples, %d ns apart" % (b["capture"], len(b["codes"]), BURST_PERIOD_NS))
+                break
+
+    def raw_sample(self, center, t):
+        """One back-to-back oneshot conversion around the slow measurement code."""
+        value = center + MAINS_PICKUP_LSB * math.sin(2 * math.pi * MAINS_HZ * t) + self.physics.rng.gauss(0, 1.5)
+        return min(max(round(value), 0), MAX_ADC)
+
+    def burst_push(self, code, force):
+        b = self.burst
+        b["ring"].append(code)
+        del b["ring"][:-BURST_CAPACITY]
+        if b["state"] == "armed":
+            filled, previous = len(b["ring"]), b["previous"]
+            crossed = previous is not None and filled > b["pre"] and (
+                (b["edge"] == "up" and previous < b["level_code"] <= code) or
+                (b["edge"] == "down" and code < b["level_code"] <= previous))
+            if force or crossed:
+                b["manual"], b["pre_count"], b["remaining"], b["state"] = force, min(b["pre"], filled - 1), b["post"], "triggered"
+        b["previous"] = code
+        if b["state"] == "triggered":
+            b["remaining"] -= 1
+            if b["remaining"] == 0:
+                b["codes"], b["ring"], b["state"] = b["ring"][-(b["pre_count"] + b["post"]):], [], "done"
+
+    def burst_level_code(self, slot, level, rising):
+        """_burst_level_to_code(): bisection over the code -> temperature curve (no eFuse calibration)."""
+        def temp(code):
+            return slot.to_celsius(f32(slot.divider_r * code / (MAX_ADC - code) + slot.cal_r))
+        lo, hi = 1, MAX_ADC - 1
+        t_lo, t_hi = temp(lo), temp(hi)
+        if not (level - t_lo) * (level - t_hi) < 0:
+            return None
+        while hi - lo > 1:
+            mid = lo + (hi - lo) // 2
+            if (temp(mid) < level) == (t_lo < level):
+                lo = mid
+            else:
+                hi = mid
+        return hi, "up" if rising == (t_hi > t_lo) else "down"
+
+    def burst_json(self):
+        b = self.burst
+        done = b["state"] == "done"
+        samples = len(b["codes"]) if done else len(b["ring"])
+        return ('{"burst":{"state":"%s", "index":%d, "capture":%d, "capacity":%d, "pre":%d, "post":%d, "trigger":"%s", "level":%.2f, '
+                '"manual":%s, "samples":%d, "trigger_offset":%d, "gap_free_from":0, "period_ns":%d}}'
+                % (b["state"], b["index"] + 1, b["capture"], BURST_CAPACITY, b["pre"], b["post"], b["trigger"], b["level"],
+                   "true" if done and b["manual"] else "false", samples, b["pre_count"] if done else 0, b["period_ns"] if done else 0))
+
+    def burst_cmd(self, cmd):
+        b = self.burst
+        words = cmd.split()
+        ret = ESP_ERR_INVALID_ARG
+        sizes = c_scan_ints(" ".join(words[2:5]), 3) if words[:2] == ["burst", "arm"] else None
+        level = None
+        if sizes is not None and len(words) >= 7 and words[5] in ("rise", "fall"):
+            try:
+                level = f32(float(words[6]))
+            except ValueError:
+                sizes = None
+        if sizes is not None and (len(words) == 5 or level is not None):
+            ret = self.burst_arm(sizes[0] - 1, sizes[1] % 2 ** 32, sizes[2] % 2 ** 32, words[5] if level is not None else "command", level)
+        elif cmd == "trigger":
+            ret = ESP_OK if b["state"] == "armed" else ESP_ERR_INVALID_STATE
+            b["request"] = b["request"] or ret == ESP_OK
+        elif cmd == "burst stop":
+            b["state"], b["ring"], ret = "idle", [], ESP_OK
+        elif cmd == "burst status":
+            ret = ESP_OK
+        elif cmd == "burst dump":
+            if b["state"] != "done":
+                ret = ESP_ERR_INVALID_STATE
+            else:
+                self.send(self.burst_json())
+                b["dumped"] = True
+                for offset in range(0, len(b["codes"]), BURST_CHUNK_SAMPLES):
+                    chunk = b["codes"][offset:offset + BURST_CHUNK_SAMPLES]
+                    self.send("$B" + base64.b64encode(struct.pack("<HHI", b["capture"], len(chunk), offset) + pack12(chunk)).decode())
+                return None
+        return self.burst_json() if ret == ESP_OK else self.error(ret)
+
+    def burst_arm(self, index, pre, post, trigger, level):
+        b = self.burst
+        if not 0 <= index < len(self.slots):
+            return ESP_ERR_INVALID_ARG
+        if b["state"] in ("armed", "triggered"):
+            return ESP_ERR_INVALID_STATE
+        slot = self.slots[index]
+        if not slot.active:
+            return ESP_ERR_INVALID_STATE
+        if slot.mux_address != -1:
+            return ESP_ERR_NOT_SUPPORTED
+        edge, level_code = None, 0
+        if level is not None:
+            found = self.burst_level_code(slot, level, trigger == "rise")
+            if found is None:
+                return ESP_ERR_INVALID_ARG
+            level_code, edge = found
+        if post == 0 or pre > BURST_CAPACITY or post > BURST_CAPACITY - pre:
+            return ESP_ERR_INVALID_ARG
+        b.update({"state": "armed", "index": index, "capture": (b["capture"] + 1) & 0xFFFF, "pre": pre, "post": post, "trigger": trigger,
+                  "level": level if level is not None else 0.0, "manual": False, "edge": edge, "level_code": level_code,
+                  "ring": [], "codes": [], "previous": None, "pre_count": 0, "request": False, "period_ns": BURST_PERIOD_NS,
+                  "dumped": False})
+        return ESP_OK
+
+    def diag_noise(self, index):
+        """temp_comp_diag_noise_start()/_result(): a paced capture through the burst sampler, then temp_noise_analyze()."""
+        if self.burst["state"] == "done" and not self.burst.get("dumped", True):
+            return self.error(ESP_ERR_INVALID_STATE)
+        ret = self.burst_arm(index - 1, 0, NOISE_SAMPLES, "command", None)
+        if ret != ESP_OK:
+            return self.error(ret)
+        b, slot = self.burst, self.slots[index - 1]
+        t = time.monotonic()
+        center = self.physics.adc_code(index - 1, t - self.boot, slot.divider_r)
+        codes = [self.raw_sample(center, t + n * NOISE_PERIOD_US * 1e-6) for n in range(NOISE_SAMPLES)]
+        b.update({"state": "done", "codes": codes, "manual": True, "pre_count": 0, "period_ns": NOISE_PERIOD_US * 1000, "dumped": True})
+        noise = noise_analyze(codes, 1e6 / NOISE_PERIOD_US, 12)
+        code = round(noise["mean_code"])
+        rms_c = math.nan
+        if 1 < code < MAX_ADC - 1:
+            t_below, t_above = (slot.to_celsius(f32(slot.divider_r * c / (MAX_ADC - c) + slot.cal_r)) for c in (code - 1, code + 1))
+            rms_c = noise["rms_lsb"] * abs(t_above - t_below) / 2
+        self.log("I", "temp_comp", "Noise on thermistor %d: %.2f LSB rms (%.4f C), ENOB %.1f, %d tones"
+                 % (index, noise["rms_lsb"], rms_c, noise["enob"], len(noise["peaks"])))
+        return ('{"noise":{"index":%d, "samples":%d, "rate_hz":%.1f, "mean_code":%.2f, "rms_lsb":%.3f, "p2p_lsb":%d, '
+                '"rms_c":%.4f, "enob":%.2f, "tone_fraction":%.2f, "peaks":[%s]}}'
+                % (index, NOISE_SAMPLES, 1e6 / NOISE_PERIOD_US, noise["mean_code"], noise["rms_lsb"], noise["p2p_lsb"], rms_c,
+                   noise["enob"], noise["tone_fraction"], ", ".join('{"hz":%.2f, "lsb":%.3f}' % peak for peak in noise["peaks"])))
+
+    def subs_tick(self):
+        """serial_subs_feed(): every enabled subscription, a frame each `divisor` cycles."""
+        for sub_id, sub in enumerate(self.subs, 1):
+            if sub is None or not sub["enabled"]:
+                continue
+            if not sub["primed"]:
+                sub["primed"], sub["last_cycle"] = True, self.cycle
+                continue
+            indices = [i for i in sub["channels"] if self.slots[i].active]
+            if sub["format"] == "stats":
+                for i in indices:
+                    value = self.slots[i].temperature
+                    acc = sub["acc"].setdefault(i, [0, math.inf, -math.inf, 0.0, 0.0])
+                    if math.isfinite(value):
+                        acc[0] += 1
+                        acc[1], acc[2] = min(acc[1], value), max(acc[2], value)
+                        delta = value - acc[3]
+                        acc[3] += delta / acc[0]
+                        acc[4] += delta * (value - acc[3])
+                sub["aggregated"] += 1
+            if self.cycle - sub["last_cycle"] < sub["divisor"]:
+                continue
+            names = ",".join('"%s"' % self.slots[i].name for i in indices)
+            if sub["format"] == "json":
+                frame = '{"sub":"%s","names":[%s],"temperatures":[%s]}' % (
+                    sub["name"], names, ",".join("%.2f" % self.slots[i].temperature for i in indices))
+            elif sub["format"] == "bin":
+                values = [centi(self.slots[i].temperature) for i in indices]
+                raw = (struct.pack("<BBHI", sub_id, len(indices), sub["seq"], self.cycle & 0xFFFFFFFF) + bytes(i + 1 for i in indices)
+                       + bytes(len(indices) & 1) + struct.pack("<%dh" % len(values), *values))
+                frame = "$T" + base64.b64encode(raw).decode()
+            elif sub["format"] == "raw":
+                generation = self.conversion_generation()
+                if sub["described"] != generation:
+                    self.send_raw_descriptor(sub_id, sub, indices, generation)
+                    sub["described"] = generation
+                raw = (struct.pack("<BBHII", sub_id, len(indices), sub["seq"], self.cycle & 0xFFFFFFFF, generation)
+                       + bytes(i + 1 for i in indices) + bytes(len(indices) & 1) + pack12([self.slots[i].raw_code for i in indices]))
+                frame = "$R" + base64.b64encode(raw).decode()
+            else:
+                fields = {"count": [], "min": [], "max": [], "mean": [], "stddev": []}
+                for i in indices:
+                    count, lo, hi, mean, m2 = sub["acc"].get(i, [0, 0.0, 0.0, 0.0, 0.0])
+                    if not count:
+                        lo = hi = mean = stddev = math.nan
+                    else:
+                        stddev = math.sqrt(m2 / (count - 1)) if count > 1 else 0.0
+                    fields["count"].append("%d" % count)
+                    for key, value in (("min", lo), ("max", hi), ("mean", mean), ("stddev", stddev)):
+                        fields[key].append("%.2f" % value)
+                frame = ('{"sub":"%s","stats":{"window":%d,"samples":%d,"names":[%s]' % (sub["name"], sub["seq"], sub["aggregated"], names)
+                         + "".join(',"%s":[%s]' % (key, ",".join(values)) for key, values in fields.items()) + "}}")
+                sub["acc"], sub["aggregated"] = {}, 0
+            sub["last_cycle"] = self.cycle
+            sub["seq"] = (sub["seq"] + 1) & 0xFFFF
+            self.send(frame)
+
+    def conversion_generation(self):
+        """s_conversion_generation: bumped whenever a slot's divider, offset, unit or model changes."""
+        inputs = [(s.divider_r, s.cal_r, s.adc_unit, s.adc_channel, s.name, tuple(sorted(s.model.items()))) for s in self.slots]
+        if self.conversion is None or self.conversion[1] != inputs:
+            self.conversion = ((self.conversion[0] if self.conversion else 0) + 1, inputs)
+        return self.conversion[0]
+
+    def send_raw_descriptor(self, sub_id, sub, indices, generation):
+        """_send_raw_descriptor(): header and one line per channel; no calibration tables (uncalibrated units)."""
+        self.send('{"sub":"%s","raw_descriptor":{"id":%d,"generation":%d,"max_code":%d,"channels":[%s],"adc_cal":[]}}'
+                  % (sub["name"], sub_id, generation, MAX_ADC, ",".join(str(i + 1) for i in indices)))
+        for i in indices:
+            slot = self.slots[i]
+            m = slot.model
+            model = ('"model":{"type":"beta","beta":%.2f,"r25":%.2f},' % (m["beta"], m["r25"]) if m["type"] == "beta"
+                     else '"model":{"type":"sh","a":%.7e,"b":%.7e,"c":%.7e},' % (m["a"], m["b"], m["c"]))
+            self.send('{"sub":"%s","raw_channel":{"index":%d,"name":"%s","unit":%d,"divider_r":%d,"cal_r":%d,%s"k":[%.9e,%.9e,%.9e]}}'
+                      % ((sub["name"], i + 1, slot.name, slot.adc_unit, slot.divider_r, slot.cal_r, model) + tuple(slot.conversion_k())))
+
+    def exceeds_deadband(self, last, now):
+        if math.isnan(last) or math.isnan(now):
+            return math.isnan(last) != math.isnan(now)
+        delta = abs(now - last)
+        if self.deadband_abs_c <= 0 and self.deadband_rel <= 0:
+            return delta > 0
+        return (self.deadband_abs_c > 0 and delta >= self.deadband_abs_c) or (self.deadband_rel > 0 and delta >= self.deadband_rel * abs(last))
+
+    def send_stats(self, only_new):
+        seq = self.stats_last[0] if self.stats_last else 0
+        if only_new and seq == self.stats_last_streamed:
+            return
+        self.stats_last_streamed = seq
+        if not seq:
+            self.send('{"stats":null}')
+            return
+        _, samples, acc = self.stats_last
+        indices = self.active_indices()
+        fields = {"count": [], "min": [], "max": [], "mean": [], "stddev": []}
+        for i in indices:
+            count, lo, hi, mean, m2 = acc.get(i, [0, math.nan, math.nan, math.nan, 0.0])
+            if not count:
+                lo = hi = mean = stddev = math.nan
+            else:
+                stddev = math.sqrt(m2 / (count - 1)) if count > 1 else 0.0
+            fields["count"].append("%d" % count)
+            for key, value in (("min", lo), ("max", hi), ("mean", mean), ("stddev", stddev)):
+                fields[key].append("%.2f" % value)
+        self.send('{"stats":{"window":%d, "samples":%d, "names":[%s],"count":[%s],"min":[%s],"max":[%s],"mean":[%s],"stddev":[%s]}}'
+                  % (seq, samples, ",".join('"%s"' % self.slots[i].name for i in indices), ",".join(fields["count"]),
+                     ",".join(fields["min"]), ",".join(fields["max"]), ",".join(fields["mean"]), ",".join(fields["stddev"])))
+
+    def stream_config_json(self):
+        return ('{"stream_mode":"%s", "deadband_abs_c":%.3f, "deadband_rel":%.3f, "heartbeat_ms":%d, "stats_window_samples":%d}'
+                % (self.stream_mode, self.deadband_abs_c, self.deadband_rel, self.heartbeat_ms, self.stats_window))
+
+    def therm_json(self, index):
+        slot = self.slots[index - 1]
+        return ('{"index":%d, "name":"%s", "divider_R":%d, "adc_channel":%d, "adc_unit":%d, "mux_address":%d, "cal_R":%d}'
+                % (index, slot.name, slot.divider_r, slot.adc_channel, slot.adc_unit, slot.mux_address, slot.cal_r))
+
+    def model_json(self, index):
+        m = self.slots[index - 1].model
+        if m["type"] == "beta":
+            return '{"index":%d, "model":{"type":"beta", "beta":%.2f, "r25":%.2f}}' % (index, m["beta"], m["r25"])
+        return '{"index":%d, "model":{"type":"sh", "a":%.7e, "b":%.7e, "c":%.7e}}' % (index, m["a"], m["b"], m["c"])
+
+    def filter_json(self, index):
+        f = self.slots[index - 1].filter
+        return ('{"index":%d, "filter":{"median":%d, "iir_alpha":%.3f, "kalman_q":%g, "kalman_r":%g}}'
+                % (index, f["median"], f["iir_alpha"], f["kalman_q"], f["kalman_r"]))
+
+    def alarm_json(self, index):
+        slot = self.slots[index - 1]
+        a, active = slot.alarm, slot.alarm_active
+        b = lambda v: "true" if v else "false"
+        return ('{"index":%d, "alarm":{"enabled":%s, "low_c":%.2f, "high_c":%.2f, "hysteresis_c":%.2f, "max_rate_c_per_min":%.2f, '
+                '"active":{"high":%s, "low":%s, "rate":%s}}}'
+                % (index, b(a["enabled"]), a["low_c"], a["high_c"], a["hysteresis_c"], a["max_rate_c_per_min"],
+                   b(active["high"]), b(active["low"]), b(active["rate"])))
+
+    def cal_points_json(self, index):
+        points = ",".join('{"R":%.2f, "T":%.3f}' % (r, t) for r, t in self.slots[index - 1].cal_points)
+        return '{"index":%d, "cal_points":[%s]}' % (index, points)
+
+    # --- commands ---
+
+    def valid_index(self, index):
+        return 1 <= index <= len(self.slots)
+
+    def receive(self, data):
+        """serial_comp_receive(): echo every byte, a line ends at CR or LF."""
+        self.out.write(data)
+        self.rx += data
+        while True:
+            cut = min((p for p in (self.rx.find(b"\n"), self.rx.find(b"\r")) if p >= 0), default=-1)
+            if cut < 0:
+                if len(self.rx) >= 127:
+                    self.log("E", "serial_comp", "Line buffer overflow. Discarding current line fragment.")
+                    self.rx = b""
+                return
+            line, self.rx = self.rx[:cut], self.rx[cut + 1:]
+            if line:
+                self.command(line.decode("utf-8", errors="replace"))
+
+    def command(self, cmd):
+        self.log("I", "serial_comp", "Processing command: %s (raw len: %d)" % (cmd, len(cmd)))
+        handler = self.dispatch(cmd)
+        if handler is None:
+            self.log("W", "serial_comp", "Unknown command received: '%s'" % cmd)
+            return
+        reply = handler()
+        if reply:
+            self.send(reply)
+
+    def dispatch(self, cmd):
+        words = cmd.split()
+        if cmd == "help":
+            return lambda: HELP_TEXT
+        if cmd in ("status", "get temps"):
+            return lambda: self.log("I", "", self.send_latest_temps())
+        if cmd == "toggle serial stream":
+            return lambda: self.toggle("serial_stream_active", "serial_stream_active")
+        if cmd == "toggle temp log":
+            return lambda: self.toggle("log_temps_active", "temp_log_active")
+        if cmd == "force cache refresh":
+            return lambda: '{"temp_component_cache_refresh_ok":true}'
+        if cmd.startswith("set sampling interval "):
+            return lambda: self.set_sampling_interval(c_atoi(cmd[22:]))
+        if cmd == "get sampling interval":
+            return lambda: '{"sampling_interval_ms":%d}' % self.sampling_interval_ms
+        if cmd.startswith("incr cal res ") or cmd.startswith("decr cal res "):
+            step = DEFAULT_CAL_R_STEP if cmd[0] == "i" else -DEFAULT_CAL_R_STEP
+            return lambda: self.set_cal_res(c_atoi(cmd[13:]), None, step)
+        if cmd.startswith("set cal res "):
+            return lambda: self.set_cal_res_cmd(cmd[12:])
+        if cmd.startswith("set therm "):
+            return lambda: self.set_therm(words[2:])
+        if cmd.startswith("get therm "):
+            return lambda: self.indexed(c_atoi(cmd[10:]), self.therm_json)
+        if cmd.startswith("set mux settle ") or cmd == "get mux":
+            return lambda: self.mux(cmd)
+        if cmd.startswith("set model ") or cmd.startswith("get model "):
+            return lambda: self.model_cmd(cmd)
+        if cmd.startswith("calibrate "):
+            return lambda: self.calibrate(words[1:])
+        if cmd.startswith("set adaptive ") or cmd == "get adaptive":
+            return lambda: self.adaptive_cmd(cmd)
+        if cmd == "get health":
+            return self.health_json
+        if cmd.startswith("set log mode ") or cmd == "get log stats":
+            return lambda: self.log_cmd(cmd)
+        if cmd.startswith("set filter "):
+            return lambda: self.filter_cmd(words[2:])
+        if cmd.startswith("set stream mode "):
+            return lambda: self.set_value(cmd[16:] in ("full", "change", "stats"), "stream_mode", cmd[16:])
+        if cmd.startswith("set deadband "):
+            return lambda: self.set_deadband(words[2:])
+        if cmd.startswith("set heartbeat "):
+            value = c_atoi(cmd[14:])
+            return lambda: self.set_value(MIN_SAMPLING_INTERVAL_MS <= value <= MAX_SAMPLING_INTERVAL_MS, "heartbeat_ms", value)
+        if cmd.startswith("set low power "):
+            return lambda: self.set_low_power(cmd[14:])
+        if cmd.startswith("burst ") or cmd == "trigger":
+            return lambda: self.burst_cmd(cmd)
+        if cmd.startswith("diag noise "):
+            return lambda: self.diag_noise(c_atoi(cmd[11:]))
+        if cmd == "boot stats":
+            return self.boot_json
+        if cmd == "get power stats":
+            return lambda: ('{"power":{"low_power":%s, "samples":0, "wake_latency_avg_us":0, "wake_latency_max_us":0, '
+                            '"awake_avg_us":0, "est_avg_current_ua":0, "est_charge_per_sample_uc":0}}' % ("true" if self.low_power else "false"))
+        if cmd == "get stats":
+            return lambda: self.send_stats(only_new=False)
+        if cmd.startswith("set stats window "):
+            value = c_atoi(cmd[17:])
+            return lambda: self.set_value(2 <= value <= MAX_STATS_WINDOW_SAMPLES, "stats_window", value)
+        if cmd == "get stream config":
+            return self.stream_config_json
+        if cmd.startswith("sub "):
+            return lambda: self.sub_cmd(cmd[4:].split())
+        if cmd.startswith("set alarm ") or cmd.startswith("clear alarm "):
+            return lambda: self.alarm_cmd(words)
+        if cmd.startswith("get alarm "):
+            return lambda: self.indexed(c_atoi(cmd[10:]), self.alarm_json)
+        if cmd.startswith("get filter "):
+            return lambda: self.indexed(c_atoi(cmd[11:]), self.filter_json)
+        return None
+
+    def sub_cmd(self, words):
+        # sscanf("%7s %12s %7s %d %127s") field count
+        fields = min(len(words), 3)
+        divisor = None
+        if len(words) > 3:
+            try:
+                divisor, fields = int(words[3]), 4 + (len(words) > 4)
+            except ValueError:
+                pass
+        action, name = (words + ["", ""])[0][:7], (words + ["", ""])[1][:STREAM_SUB_NAME_LEN]
+        ret = ESP_ERR_INVALID_ARG
+        if action == "add" and fields >= 4:
+            channels = parse_channel_list(words[4] if fields == 5 else "all", len(self.slots))
+            if words[2][:7] in STREAM_SUB_FORMATS and channels is not None:
+                ret = self.sub_add(name, words[2][:7], divisor, channels)
+        elif action == "remove" and fields >= 2:
+            ret = self.sub_find(name)
+            if ret == ESP_OK:
+                self.subs[[s is not None and s["name"] == name for s in self.subs].index(True)] = None
+        elif action in ("enable", "disable") and fields >= 2:
+            ret = self.sub_find(name)
+            if ret == ESP_OK:
+                sub = next(s for s in self.subs if s is not None and s["name"] == name)
+                if action == "enable" and not sub["enabled"]:
+                    sub["primed"], sub["acc"], sub["aggregated"], sub["described"] = False, {}, 0, None
+                sub["enabled"] = action == "enable"
+        elif action == "list" and fields == 1:
+            ret = ESP_OK
+        return self.subs_json() if ret == ESP_OK else self.error(ret)
+
+    def sub_find(self, name):
+        return ESP_OK if any(s is not None and s["name"] == name for s in self.subs) else ESP_ERR_NOT_FOUND
+
+    def sub_add(self, name, fmt, divisor, channels):
+        valid_name = 0 < len(name) < STREAM_SUB_NAME_LEN and all(c.isascii() and (c.isalnum() or c in "_-") for c in name)
+        if not valid_name or not 1 <= divisor <= STREAM_SUB_MAX_DIVISOR:
+            return ESP_ERR_INVALID_ARG
+        if self.sub_find(name) == ESP_OK:
+            return ESP_ERR_INVALID_STATE
+        if None not in self.subs:
+            return ESP_ERR_NO_MEM
+        self.subs[self.subs.index(None)] = {"name": name, "format": fmt, "divisor": divisor, "enabled": True, "channels": channels,
+                                            "primed": False, "last_cycle": 0, "seq": 0, "acc": {}, "aggregated": 0, "described": None}
+        return ESP_OK
+
+    def subs_json(self):
+        entries = ['{"id":%d, "name":"%s", "format":"%s", "divisor":%d, "enabled":%s, "channels":[%s]}'
+                   % (sub_id, s["name"], s["format"], s["divisor"], "true" if s["enabled"] else "false", ",".join(str(i + 1) for i in s["channels"]))
+                   for sub_id, s in enumerate(self.subs, 1) if s is not None]
+        return '{"subs":[%s]}' % ",".join(entries)
+
+    @staticmethod
+    def error(name):
+        return '{"error":"%s"}' % name
+
+    def indexed(self, index, formatter):
+        return formatter(index) if self.valid_index(index) else self.error(ESP_ERR_INVALID_ARG)
+
+    def toggle(self, attribute, key):
+        setattr(self, attribute, not getattr(self, attribute))
+        return '{"%s":%s}' % (key, "true" if getattr(self, attribute) else "false")
+
+    def set_value(self, valid, attribute, value):
+        if not valid:
+            return self.error(ESP_ERR_INVALID_ARG)
+        setattr(self, attribute, value)
+        return self.stream_config_json()
+
+    def set_sampling_interval(self, value):
+        if not self.args.min_interval_ms <= value <= MAX_SAMPLING_INTERVAL_MS:
+            return '{"error":%s}' % ESP_ERR_INVALID_ARG     # Unquoted, as the firmware sends it
+        self.sampling_interval_ms = value
+        return '{"sampling_interval_ms":%d}' % value
+
+    def set_cal_res(self, index, value, step=0):
+        error = '{"error":%s}' if step else '{"error":"%s"}'  # incr/decr reply unquoted, as the firmware does
+        if not self.valid_index(index):
+            return error % ESP_ERR_INVALID_ARG
+        slot = self.slots[index - 1]
+        value = slot.cal_r + step if value is None else value
+        if not -MAX_CAL_R_OFFSET <= value <= MAX_CAL_R_OFFSET:
+            return error % ESP_ERR_INVALID_ARG
+        slot.cal_r = value
+        return '{"index":%d, "cal_R":%d}' % (index, value)
+
+    def set_cal_res_cmd(self, args):
+        values = c_scan_ints(args, 2)
+        if values is None:
+            return '{"error":"malformed command syntax for set cal res"}'
+        return self.set_cal_res(values[0], values[1])
+
+    def set_therm(self, args):
+        if len(args) < 5 or not self.valid_index(c_atoi(args[0])):
+            return self.error(ESP_ERR_INVALID_ARG)
+        try:
+            index, name, divider_r, adc_channel, mux_address = int(args[0]), args[1][:9], int(args[2]), int(args[3]), int(args[4])
+            adc_unit = int(args[5]) if len(args) > 5 else 1
+        except ValueError:
+            return self.error(ESP_ERR_INVALID_ARG)
+        if divider_r <= 0 or not 0 <= adc_channel <= 9 or adc_unit not in (1, 2) or mux_address != -1:    # No mux address lines on the emulated board
+            return self.error(ESP_ERR_INVALID_ARG)
+        slot = self.slots[index - 1]
+        slot.name, slot.divider_r, slot.adc_channel, slot.adc_unit, slot.mux_address = name, divider_r, adc_channel, adc_unit, mux_address
+        slot.reset_runtime()
+        return self.therm_json(index)
+
+    def mux(self, cmd):
+        if cmd[0] == "s":
+            value = c_atoi(cmd[15:])
+            if not 0 <= value <= MAX_MUX_SETTLE_US:
+                return self.error(ESP_ERR_INVALID_ARG)
+            self.mux_settle_us = value
+        return '{"mux":{"addr_bits":0, "settle_us":%d, "addr_gpios":[]}}' % self.mux_settle_us
+
+    def model_cmd(self, cmd):
+        words = cmd.split()
+        try:
+            if cmd[0] == "g":
+                index = c_atoi(cmd[10:])
+                return self.indexed(index, self.model_json)
+            if words[2] == "sh" and len(words) >= 7:
+                index, a, b, c = int(words[3]), f32(float(words[4])), f32(float(words[5])), f32(float(words[6]))
+                if not self.valid_index(index) or not all(map(math.isfinite, (a, b, c))) or not b > 0:
+                    return self.error(ESP_ERR_INVALID_ARG)
+                self.slots[index - 1].model.update(type="sh", a=a, b=b, c=c)
+                return self.model_json(index)
+            if words[2] == "beta" and len(words) >= 6:
+                index, beta, r25 = int(words[3]), f32(float(words[4])), f32(float(words[5]))
+                if not self.valid_index(index) or not (beta > 0 and r25 > 0 and math.isfinite(beta) and math.isfinite(r25)):
+                    return self.error(ESP_ERR_INVALID_ARG)
+                self.slots[index - 1].model.update(type="beta", beta=beta, r25=r25)
+                return self.model_json(index)
+        except (ValueError, IndexError):
+            pass
+        return self.error(ESP_ERR_INVALID_ARG)
+
+    def calibrate(self, args):
+        try:
+            action, index = args[0], int(args[1])
+        except (ValueError, IndexError):
+            return self.error(ESP_ERR_INVALID_ARG)
+        if not self.valid_index(index):
+            return self.error(ESP_ERR_INVALID_ARG)
+        slot = self.slots[index - 1]
+        if action == "point" and len(args) >= 3:
+            reference_c = f32(float(args[2]))
+            resistance = f32(float(args[3])) if len(args) >= 4 else slot.resistance
+            if len(slot.cal_points) >= MAX_CAL_POINTS or not resistance > 0:
+                return self.error(ESP_ERR_INVALID_STATE)
+            slot.cal_points.append((resistance, reference_c))
+        elif action == "solve":
+            model = fit_model(slot.cal_points)
+            if model is None:
+                return self.error(ESP_ERR_INVALID_ARG if len(slot.cal_points) not in (2, 3) else ESP_ERR_INVALID_STATE)
+            slot.model.update(model)
+            slot.cal_points = []
+            return self.model_json(index)
+        elif action == "clear":
+            slot.cal_points = []
+        elif action != "status":
+            return self.error(ESP_ERR_INVALID_ARG)
+        return self.cal_points_json(index)
+
+    def adaptive_cmd(self, cmd):
+        adaptive = dict(self.adaptive)
+        if cmd[0] == "s":
+            words = cmd[13:].split()
+            try:
+                if words == ["off"]:
+                    adaptive["enabled"] = False
+                elif words[0] == "hysteresis":
+                    adaptive.update(hysteresis=f32(float(words[1])), calm_cycles=int(words[2]))
+                else:
+                    adaptive.update(enabled=True, min_ms=int(words[0]), max_ms=int(words[1]),
+                                    rate_c_per_min=f32(float(words[2])), stddev_c=f32(float(words[3])))
+            except (ValueError, IndexError):
+                return self.error(ESP_ERR_INVALID_ARG)
+            a = adaptive
+            if (not MIN_SAMPLING_INTERVAL_MS <= a["min_ms"] <= a["max_ms"] <= MAX_SAMPLING_INTERVAL_MS
+                    or not (a["rate_c_per_min"] >= 0 and a["stddev_c"] >= 0)
+                    or a["enabled"] and a["rate_c_per_min"] == 0 and a["stddev_c"] == 0
+                    or not 0 < a["hysteresis"] <= 1 or not 1 <= a["calm_cycles"] <= MAX_ADAPTIVE_CALM_CYCLES):
+                return self.error(ESP_ERR_INVALID_ARG)
+            self.adaptive = adaptive
+        a = self.adaptive
+        return ('{"adaptive":{"enabled":%s, "min_ms":%d, "max_ms":%d, "rate_c_per_min":%.2f, "stddev_c":%.2f, '
+                '"hysteresis":%.2f, "calm_cycles":%d, "interval_ms":%d}}'
+                % ("true" if a["enabled"] else "false", a["min_ms"], a["max_ms"], a["rate_c_per_min"], a["stddev_c"],
+                   a["hysteresis"], a["calm_cycles"], self.sampling_interval_ms))
+
+    def health_json(self):
+        entries = ['{"index":%d, "name":"%s", "state":"%s", "faults":%d, "backoff_cycles":%d}'
+                   % (i + 1, self.slots[i].name, self.slots[i].health, self.slots[i].faults, 0) for i in self.active_indices()]
+        return '{"health":[%s]}' % ",".join(entries)
+
+    def log_cmd(self, cmd):
+        if cmd[0] == "s":
+            mode = cmd[13:]
+            if mode not in ("text", "binary"):
+                return self.error(ESP_ERR_INVALID_ARG)
+            self.log_mode = mode
+        s = self.log_stats
+        return ('{"log":{"mode":"%s", "binary_queued":%d, "binary_dropped":%d, "rate_suppressed":%d}}'
+                % (self.log_mode, s["binary_queued"], s["binary_dropped"], s["rate_suppressed"]))
+
+    def filter_cmd(self, args):
+        try:
+            stage, index = args[0], int(args[1])
+            values = [float(v) for v in args[2:]]
+            if stage == "median":
+                update = {"median": int(args[2])}
+            elif stage == "iir":
+                update = {"iir_alpha": f32(values[0])}
+            elif stage == "kalman":
+                update = {"kalman_q": f32(values[0]), "kalman_r": f32(values[1])}
+            else:
+                raise ValueError
+        except (ValueError, IndexError):
+            return '{"error":"malformed command syntax for set filter"}'
+        if not self.valid_index(index):
+            return self.error(ESP_ERR_INVALID_ARG)
+        f = dict(self.slots[index - 1].filter, **update)
+        if (not 0 <= f["median"] <= MAX_FILTER_MEDIAN_WINDOW or f["median"] > 1 and f["median"] % 2 == 0
+                or not 0 <= f["iir_alpha"] < 1 or not f["kalman_q"] >= 0 or f["kalman_q"] > 0 and not f["kalman_r"] > 0):
+            return self.error(ESP_ERR_INVALID_ARG)
+        self.slots[index - 1].filter = f
+        return self.filter_json(index)
+
+    def set_deadband(self, args):
+        try:
+            abs_c, rel = f32(float(args[0])), f32(float(args[1]))
+        except (ValueError, IndexError):
+            return self.error(ESP_ERR_INVALID_ARG)
+        if not (abs_c >= 0 and 0 <= rel < 1):
+            return self.error(ESP_ERR_INVALID_ARG)
+        self.deadband_abs_c, self.deadband_rel = abs_c, rel
+        return self.stream_config_json()
+
+    def set_low_power(self, arg):
+        if arg not in ("on", "off"):
+            return self.error(ESP_ERR_INVALID_ARG)
+        self.low_power = arg == "on"
+        return '{"low_power_mode":%s}' % ("true" if self.low_power else "false")
+
+    def alarm_cmd(self, words):
+        try:
+            if words[0] == "clear":
+                index, update = int(words[2]), {"enabled": False, "low_c": 0.0, "high_c": 0.0, "hysteresis_c": 0.0, "max_rate_c_per_min": 0.0}
+            elif words[2] == "rate":
+                index, update = int(words[3]), {"max_rate_c_per_min": f32(float(words[4]))}
+            else:
+                index = int(words[2])
+                update = {"enabled": True, "low_c": f32(float(words[3])), "high_c": f32(float(words[4])), "hysteresis_c": f32(float(words[5]))}
+        except (ValueError, IndexError):
+            return self.error(ESP_ERR_INVALID_ARG)
+        if not self.valid_index(index):
+            return self.error(ESP_ERR_INVALID_ARG)
+        a = dict(self.slots[index - 1].alarm, **update)
+        if (a["enabled"] and not (a["low_c"] < a["high_c"] and 0 <= a["hysteresis_c"] < a["high_c"] - a["low_c"])
+                or not a["max_rate_c_per_min"] >= 0):
+            return self.error(ESP_ERR_INVALID_ARG)
+        self.slots[index - 1].alarm = a
+        return self.alarm_json(index)
+
+
+def c_atoi(text):
+    """atoi(): leading whitespace, optional sign, digits; 0 when there are none."""
+    text = text.lstrip()
+    end = 1 if text[:1] in ("-", "+") else 0
+    while end < len(text) and text[end].isdigit():
+        end += 1
+    try:
+        return int(text[:end])
+    except ValueError:
+        return 0
+
+
+def parse_channel_list(text, slots):
+    """_parse_channel_list(): "all" or comma-separated 1-based indices. Sorted 0-based indices, None when malformed."""
+    if text == "all":
+        return list(range(slots))
+    indices = set()
+    for part in (text[:-1] if text.endswith(",") else text).split(","):
+        try:
+            index = int(part)
+        except ValueError:
+            return None
+        if not 1 <= index <= slots:
+            return None
+        indices.add(index - 1)
+    return sorted(indices)
+
+
+def centi(value):
+    """Centi-degree code of a binary subscription frame (lroundf, NaN code when missing or out of range)."""
+    if not math.isfinite(value) or value <= -327.68 or value >= 327.67:
+        return STREAM_SUB_BIN_NAN
+    return int(math.copysign(math.floor(abs(value * 100.0) + 0.5), value))
+
+
+def pack12(codes):
+    """temp_burst_pack12(): two 12-bit codes per three bytes, an odd last code in two."""
+    out = bytearray()
+    for n in range(0, len(codes) - 1, 2):
+        a, b = codes[n], codes[n + 1]
+        out += bytes((a & 0xFF, (a >> 8) | (b & 0x0F) << 4, b >> 4))
+    if len(codes) & 1:
+        out += bytes((codes[-1] & 0xFF, codes[-1] >> 8))
+    return bytes(out)
+
+
+def fft(values):
+    """Recursive radix-2 FFT of a list of complex values (power-of-two length)."""
+    n = len(values)
+    if n == 1:
+        return list(values)
+    even, odd = fft(values[0::2]), fft(values[1::2])
+    twiddled = [cmath.exp(-2j * math.pi * k / n) * odd[k] for k in range(n // 2)]
+    return [even[k] + twiddled[k] for k in range(n // 2)] + [even[k] - twiddled[k] for k in range(n // 2)]
+
+
+def noise_analyze(codes, rate_hz, bits):
+    """temp_noise_analyze(): statistics, Hann-windowed spectrum, strongest tones above NOISE_PEAK_RATIO x mean bin power."""
+    count = len(codes)
+    mean = sum(codes) / count
+    rms = math.sqrt(sum((c - mean) ** 2 for c in codes) / count)
+    quantization_rms = rms * math.sqrt(12)
+    enob = max(bits - math.log2(quantization_rms), 0.0) if quantization_rms > 1 else float(bits)
+    result = {"mean_code": mean, "rms_lsb": rms, "p2p_lsb": max(codes) - min(codes), "enob": enob, "tone_fraction": 0.0, "peaks": []}
+    spectrum = fft([(c - mean) * (0.5 - 0.5 * math.cos(2 * math.pi * n / count)) for n, c in enumerate(codes)])
+    power = [abs(x) ** 2 for x in spectrum[:count // 2]]
+    total = sum(power[1:])
+    if not total > 0:
+        return result
+    threshold = NOISE_PEAK_RATIO * total / (count // 2 - 1)
+    bins = sorted((k for k in range(2, count // 2 - 1) if power[k] > threshold and power[k] > power[k - 1] and power[k] >= power[k + 1]),
+                  key=lambda k: -power[k])[:NOISE_PEAKS]
+    for k in bins:
+        left, center, right = (math.sqrt(power[j]) for j in (k - 1, k, k + 1))
+        denominator = left - 2 * center + right
+        delta = 0.5 * (left - right) / denominator if denominator else 0.0
+        result["peaks"].append(((k + delta) * rate_hz / count, 4 * center / count))
+    result["tone_fraction"] = min(sum(power[k - 1] + power[k] + power[k + 1] for k in bins) / total, 1.0)
+    return result
+
+
+def c_scan_ints(text, count):
+    words = text.split()
+    try:
+        return [int(w) for w in words[:count]] if len(words) >= count else None
+    except ValueError:
+        return None
+
+
+def fit_model(points):
+    """temp_model_fit(): 2 points -> Beta, 3 points -> Steinhart-Hart. None when the fit fails."""
+    if len(points) == 2:
+        (r1, t1), (r2, t2) = points
+        y1, y2 = 1.0 / (t1 + KELVIN_OFFSET), 1.0 / (t2 + KELVIN_OFFSET)
+        if y1 == y2 or r1 == r2:
+            return None
+        beta = math.log(r1 / r2) / (y1 - y2)
+        r25 = r1 * math.exp(beta * (1.0 / T25_K - y1))
+        return {"type": "beta", "beta": f32(beta), "r25": f32(r25)} if beta > 0 and r25 > 0 else None
+    if len(points) == 3:
+        (l1, l2, l3) = (math.log(r) for r, _ in points)
+        y1, y2, y3 = (1.0 / (t + KELVIN_OFFSET) for _, t in points)
+        if l1 == l2 or l1 == l3 or l2 == l3 or l1 + l2 + l3 == 0:
+            return None
+        g2, g3 = (y2 - y1) / (l2 - l1), (y3 - y1) / (l3 - l1)
+        c = (g3 - g2) / (l3 - l2) / (l1 + l2 + l3)
+        b = g2 - c * (l1 * l1 + l1 * l2 + l2 * l2)
+        a = y1 - (b + l1 * l1 * c) * l1
+        return {"type": "sh", "a": f32(a), "b": f32(b), "c": f32(c)} if b > 0 else None
+    return None
+
+
+def run(board, master, stop_after_s=None):
+    """Single loop: read commands, measure and stream on the sampling interval."""
+    next_sample = time.monotonic()
+    end = time.monotonic() + stop_after_s if stop_after_s else math.inf
+    while time.monotonic() < end:
+        timeout = max(0.0, next_sample - time.monotonic())
+        ready, _, _ = select.select([master], [], [], timeout)
+        if ready:
+            try:
+                data = os.read(master, 1024)
+            except OSError:     # EIO until a client opens the slave side
+                data = b""
+                time.sleep(0.05)
+            if data:
+                board.receive(data)
+        if time.monotonic() >= next_sample:
+            board.measure()
+            board.stream_tick()
+            board.boot_tick()
+            board.subs_tick()
+            board.burst_tick()
+            interval_s = board.sampling_interval_ms / 1000.0
+            next_sample = next_sample + interval_s if interval_s else time.monotonic()
+            if next_sample < time.monotonic() - 1.0:
+                next_sample = time.monotonic()  # Fell behind (stall, slow reader): do not burst to catch up
+
+
+def main():
+    global HELP_TEXT
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--slots", type=int, default=6, help="CONFIG_THERMISTRON_MAX_THERMISTORS of the emulated build")
+    parser.add_argument("--channels", type=int, default=5, help="slots wired to a probe at boot (Therm1..)")
+    parser.add_argument("--stream", action="store_true", help="start with the serial stream enabled")
+    parser.add_argument("--interval-ms", type=int, default=1000, help="initial sampling interval")
+    parser.add_argument("--min-interval-ms", type=int, default=MIN_SAMPLING_INTERVAL_MS,
+                        help="lowest interval 'set sampling interval' accepts (0: frames back to back)")
+    parser.add_argument("--link-bps", type=int, default=0, help="pace the output to this baud rate (0: as fast as the pty takes it)")
+    parser.add_argument("--drop-bytes", type=float, default=0.0, help="probability of dropping each output byte")
+    parser.add_argument("--garbage", type=float, default=0.0, help="probability of a junk line before each frame")
+    parser.add_argument("--stall-every", type=float, default=0.0, help="seconds between output stalls (0: none)")
+    parser.add_argument("--stall-ms", type=int, default=1000)
+    parser.add_argument("--fault", action="append", default=[], help="open|short:<index>:<after_s>, repeatable")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--duration", type=float, default=0.0, help="exit after this many seconds (0: run until Ctrl+C)")
+    args = parser.parse_args()
+    if not 1 <= args.channels <= args.slots:
+        parser.error("--channels must be between 1 and --slots")
+
+    HELP_TEXT = load_help_text()
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    os.set_blocking(master, False)
+    board = Board(args, LinkWriter(master, args, random.Random(args.seed + 1)))
+    board.sampling_interval_ms = args.interval_ms
+    print(f"Emulated Thermistron on {os.ttyname(slave)} ({args.channels} of {args.slots} slots active)", file=sys.stderr)
+    try:
+        run(board, master, args.duration or None)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,213 @@
+"""
+Multi-board hub: reads N Thermistron boards at once and merges them into one dataset.
+
+    python hub.py stand1=/dev/ttyACM0 stand2=/dev/ttyACM1 --tick-ms 500
+    python hub.py A=COM8 B=COM9
+
+Each port gets its own reader thread and IngestEngine; decoded batches are handed to one asyncio
+loop, which keeps the latest value per (device, channel) and emits one time-aligned row every
+tick_ms (last value carried forward, NaN once older than stale_ms). Rows go to a ColumnStore
+whose channel names are "<device>/<channel>". Commands typed at the prompt are fanned out to all
+devices or to a chosen subset. Ports can be pseudo-terminals, e.g. the emulator's.
+"""
+
+import argparse
+import asyncio
+import math
+import os
+import threading
+import time
+
+from colstore import ColumnStore
+from ingest import IngestEngine, Port
+
+RECONNECT_S = 5.0
+
+
+class Device:
+    """One board: its port, reader thread and ingest engine."""
+
+    def __init__(self, device_id, path, baudrate, on_batches):
+        self.device_id = device_id
+        self.path = path
+        self.baudrate = baudrate
+        self.engine = IngestEngine()
+        self.port = None
+        self._on_batches = on_batches       # Called from the reader thread after each block
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._reader, name=f"reader-{device_id}", daemon=True)
+
+    def start(self):
+        self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+        self._thread.join(timeout=2)
+
+    def _reader(self):
+        while not self._stop.is_set():
+            try:
+                if self.port is None:
+                    self.port = Port(self.path, self.baudrate)
+                    print(f"[{self.device_id}] connected to {self.path}")
+                while not self._stop.is_set():
+                    block = self.port.read()
+                    if block:
+                        self.engine.feed(block)
+                        self._on_batches(self)
+            except (OSError, ConnectionError) as e:   # serial.SerialException is an OSError
+                print(f"[{self.device_id}] {e}; reconnecting in {RECONNECT_S:.0f} s")
+                self._close_port()
+                self._stop.wait(RECONNECT_S)
+        self._close_port()
+
+    def _close_port(self):
+        if self.port is not None:
+            try:
+                self.port.close()
+            except OSError:
+                pass
+            self.port = None
+
+    def send(self, command):
+        port = self.port
+        if port is None:
+            return False
+        port.write(command.encode("utf-8") + b"\n")
+        return True
+
+
+class Hub:
+    def __init__(self, devices, store, tick_ms=500, stale_ms=5000):
+        self.store = store
+        self.tick_ms = tick_ms
+        self.stale_ms = stale_ms
+        self.loop = None
+        self.devices = {}
+        for device_id, path, baudrate in devices:
+            self.devices[device_id] = Device(device_id, path, baudrate, self._on_batches)
+        self.latest = {}        # (device, channel) -> (timestamp_ms, value)
+        self.columns = []       # Stable column order of the aligned rows
+        self.listeners = []     # Callables (device_id, batch), run on the loop for every batch
+
+    def _on_batches(self, device):
+        # Reader thread -> event loop; the loop drains the device's queue
+        self.loop.call_soon_threadsafe(self._drain, device)
+
+    def _drain(self, device):
+        batches = device.engine.batches
+        while not batches.empty():
+            batch = batches.get()
+            for sample in batch.samples:
+                for name, value in zip(sample["names"], sample["temperatures"]):
+                    key = (device.device_id, name)
+                    if key not in self.latest:
+                        self.columns.append(key)
+                    self.latest[key] = (sample["timestamp_ms"], value)
+            for config_point in batch.configs:
+                print(f"[{device.device_id}] {config_point['config_point']}")
+            for line_str in batch.logs + batch.texts:
+                print(f"[{device.device_id}] {line_str}")
+            for listener in self.listeners:
+                listener(device.device_id, batch)
+
+    def aligned_row(self, now_ms):
+        """One merged sample: every known (device, channel) with its latest value, NaN if stale."""
+        values = []
+        for key in self.columns:
+            timestamp_ms, value = self.latest[key]
+            values.append(value if now_ms - timestamp_ms <= self.stale_ms and value is not None else math.nan)
+        return {"names": [f"{device}/{name}" for device, name in self.columns], "temperatures": values, "timestamp_ms": now_ms}
+
+    async def _align(self):
+        tick_s = self.tick_ms / 1000.0
+        next_tick = time.monotonic()
+        while True:
+            next_tick += tick_s
+            await asyncio.sleep(max(0.0, next_tick - time.monotonic()))
+            if self.columns:
+                now_ms = time.time_ns() // 1_000_000
+                now_ms -= now_ms % self.tick_ms     # Rows land on a common grid
+                self.store.append([self.aligned_row(now_ms)])
+
+    def send(self, command, device_ids=None):
+        """Fan a command out to the given devices (all when None). Returns the ids it was written to."""
+        sent = []
+        for device_id in device_ids or self.devices:
+            device = self.devices.get(device_id)
+            if device is None:
+                print(f"Unknown device '{device_id}'")
+            elif device.send(command):
+                sent.append(device_id)
+        return sent
+
+    async def run(self, interactive=True):
+        self.loop = asyncio.get_running_loop()
+        for device in self.devices.values():
+            device.start()
+        aligner = asyncio.create_task(self._align())
+        try:
+            if interactive:
+                await self._prompt()
+            else:
+                await asyncio.Event().wait()
+        finally:
+            aligner.cancel()
+            for device in self.devices.values():
+                device.stop()
+            self.store.close()
+
+    async def _prompt(self):
+        print("Commands: 'cmd <text>' to all devices, 'cmd @id1,id2 <text>' to a subset, (d)ata latest, (st)ore summary, (q)uit")
+        while True:
+            command = (await self.loop.run_in_executor(None, input, "> ")).strip()
+            if command == "q":
+                return
+            elif command == "d":
+                row = self.aligned_row(time.time_ns() // 1_000_000)
+                print(dict(zip(row["names"], row["temperatures"])))
+            elif command == "st":
+                print(f"Column store: {self.store.summary()}")
+            elif command.startswith("cmd "):
+                text = command[4:].strip()
+                device_ids = None
+                if text.startswith("@"):
+                    target, _, text = text.partition(" ")
+                    device_ids = [d for d in target[1:].split(",") if d]
+                if not text:
+                    print("Command cannot be empty.")
+                else:
+                    print(f"Sent '{text}' to {self.send(text, device_ids)}")
+            elif command:
+                print(f"Unknown command '{command}'")
+
+
+def parse_device(spec):
+    device_id, sep, path = spec.partition("=")
+    if not sep:
+        device_id, path = os.path.basename(spec), spec
+    return device_id, path
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("devices", nargs="+", help="id=port, e.g. stand1=/dev/ttyACM0 (id defaults to the port name)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--tick-ms", type=int, default=500, help="grid of the merged rows")
+    parser.add_argument("--stale-ms", type=int, default=5000, help="age after which a channel is written as NaN")
+    parser.add_argument("--store", default=os.path.join("sensor_data", "hub_store"))
+    args = parser.parse_args()
+
+    devices = [(*parse_device(spec), args.baud) for spec in args.devices]
+    ids = [device_id for device_id, _, _ in devices]
+    if len(set(ids)) != len(ids):
+        parser.error(f"device ids must be unique: {ids}")
+    hub = Hub(devices, ColumnStore(args.store), args.tick_ms, args.stale_ms)
+    try:
+        asyncio.run(hub.run())
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
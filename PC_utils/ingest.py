@@ -0,0 +1,307 @@
+"""
+Block-based ingest engine for the Thermistron serial stream.
+
+The reader pulls whatever the port has buffered in one call, splits the block into lines in bulk,
+decodes the JSON lines of a block with a single json.loads and the binary ("$<type><base64>")
+lines through FRAME_DECODERS, and hands one Batch per block to the consumers through a
+queue.SimpleQueue (no lock taken per sample). All lines of a block share the host timestamp of
+its arrival.
+"""
+
+import base64
+import json
+import math
+import os
+import queue
+import re
+import select
+import struct
+import time
+
+READ_BLOCK = 65536
+
+# The firmware prints non-finite floats with "%.2f" (faulted channels, empty statistics): bare
+# nan / inf tokens, which are not JSON. Mapped to the NaN / Infinity literals json.loads accepts.
+_C_NONFINITE = re.compile(rb"(?<=[\[,:])(-?)(nan|inf)(?=[,\]}])")
+_NONFINITE_JSON = {(b"", b"nan"): b"NaN", (b"-", b"nan"): b"NaN", (b"", b"inf"): b"Infinity", (b"-", b"inf"): b"-Infinity"}
+
+# Binary log records ("$L" + base64, see log_comp.h). Argument kinds per id: i = int32, f = float32
+LOG_MESSAGES = {
+    1: ("i i i f f", "Thermistor {0}: ADC {1} ({2} mV), Rth {3:.2f} Ohm, Temp: {4:.2f} C"),
+    2: ("i i i", "Thermistor {0}: ADC read failed on channel {1}: esp_err {2}"),
+    3: ("i i i", "Thermistor {0}: ADC value {1} ({2} mV) out of range"),
+    4: ("i i", "Thermistor {0}: measurement failed: esp_err {1}"),
+    5: ("i i", "({1} similar messages of id {0} suppressed)"),
+}
+
+
+class LogDecoder:
+    """Formats binary log records on the host and notes records the device dropped (sequence gaps)."""
+
+    def __init__(self):
+        self.last_seq = None
+
+    def __call__(self, payload):
+        raw = base64.b64decode(payload)
+        msg_id, argc, seq, timestamp_us = struct.unpack_from("<BBHI", raw)
+        words = struct.unpack_from(f"<{argc}I", raw, 8)
+        kinds, fmt = LOG_MESSAGES.get(msg_id, (" ".join("i" * argc), f"log id {msg_id}: " + " ".join(f"{{{k}}}" for k in range(argc))))
+        args = [struct.unpack("<f", struct.pack("<I", w))[0] if kind == "f" else struct.unpack("<i", struct.pack("<I", w))[0]
+                for kind, w in zip(kinds.split(), words)]
+        gap = "" if self.last_seq is None or seq == (self.last_seq + 1) & 0xFFFF else f" [{(seq - self.last_seq - 1) & 0xFFFF} dropped]"
+        self.last_seq = seq
+        return "log", f"L ({timestamp_us // 1000}) {fmt.format(*args)}{gap}"
+
+
+def decode_sub_frame(payload):
+    """Binary subscription frame ("$T" + base64, see serial_subs.h); channels are 1-based slot indices."""
+    raw = base64.b64decode(payload)
+    sub_id, count, seq, cycle = struct.unpack_from("<BBHI", raw)
+    indices = list(raw[8:8 + count])
+    values = struct.unpack_from(f"<{count}h", raw, 8 + count + (count & 1))
+    return "sub", {"sub_id": sub_id, "seq": seq, "cycle": cycle, "indices": indices,
+                   "temperatures": [math.nan if v == -32768 else v / 100.0 for v in values]}
+
+
+def unpack12(raw, count):
+    """Inverse of temp_burst_pack12(): two 12-bit codes per three bytes, an odd last code in two."""
+    codes = []
+    for n in range(0, count - 1, 2):
+        b0, b1, b2 = raw[3 * (n // 2):3 * (n // 2) + 3]
+        codes.append(b0 | (b1 & 0x0F) << 8)
+        codes.append(b1 >> 4 | b2 << 4)
+    if count & 1:
+        tail = 3 * (count // 2)
+        codes.append(raw[tail] | (raw[tail + 1] & 0x0F) << 8)
+    return codes
+
+
+def decode_burst_chunk(payload):
+    """Burst dump chunk ("$B" + base64): raw ADC codes at `offset` of capture `capture` (see `burst dump`)."""
+    raw = base64.b64decode(payload)
+    capture, count, offset = struct.unpack_from("<HHI", raw)
+    return "burst", {"capture": capture, "offset": offset, "codes": unpack12(raw[8:], count)}
+
+
+def decode_raw_frame(payload):
+    """Raw subscription frame ("$R" + base64): the "$T" header, the conversion generation of the codes, then the
+    "$T" layout with packed 12-bit ADC codes (rawconv.py converts them with the descriptor of that generation)."""
+    raw = base64.b64decode(payload)
+    sub_id, count, seq, cycle, generation = struct.unpack_from("<BBHII", raw)
+    return "sub", {"sub_id": sub_id, "seq": seq, "cycle": cycle, "generation": generation, "indices": list(raw[12:12 + count]),
+                   "codes": unpack12(raw[12 + count + (count & 1):], count)}
+
+
+def decode_cal_chunk(payload):
+    """ADC calibration table chunk ("$C" + base64): mV of codes offset.. of a 1-based unit, part of a raw descriptor."""
+    raw = base64.b64decode(payload)
+    unit, _, offset, count = struct.unpack_from("<BBHH", raw)
+    return "adc_cal", {"unit": unit, "offset": offset, "mv": unpack12(raw[6:], count)}
+
+
+def merge_partial_frame(last_frame, partial_frame):
+    """
+    Rebuilds a full data point from a report-on-change ("partial") frame.
+    Channels missing from the partial frame keep the value of the last full data point.
+    Returns None if no full frame (heartbeat) has been received yet.
+    """
+    if last_frame is None:
+        return None
+    merged = dict(zip(last_frame['names'], last_frame['temperatures']))
+    merged.update(zip(partial_frame['names'], partial_frame['temperatures']))
+    return {'names': list(merged.keys()), 'temperatures': list(merged.values())}
+
+
+class Batch:
+    """Everything decoded from one read block."""
+    __slots__ = ("host_time_ns", "samples", "configs", "logs", "texts", "subs", "binary")
+
+    def __init__(self, host_time_ns):
+        self.host_time_ns = host_time_ns
+        self.samples = []   # Full temperature frames (partials already merged), with 'timestamp_ms'
+        self.configs = []   # Every other JSON object (command replies, alarms, rate changes, stats)
+        self.logs = []      # Decoded binary log lines
+        self.texts = []     # Non-JSON console output (ESP_LOG lines, echo)
+        self.subs = []      # Stream subscription frames ("sub" JSON objects and decoded "$T"/"$R" frames), with 'timestamp_ms'
+        self.binary = []    # (type, decoded) of other binary frames
+
+
+class IngestEngine:
+    """
+    Splits and decodes raw blocks into Batches. Stateless apart from the partial-frame merge
+    and the per-type binary decoders, so one engine serves one device stream.
+    """
+
+    def __init__(self):
+        self.batches = queue.SimpleQueue()
+        self.frame_decoders = {"L": LogDecoder(), "T": decode_sub_frame, "B": decode_burst_chunk,
+                               "R": decode_raw_frame, "C": decode_cal_chunk}   # Binary frame type -> callable(payload) -> (kind, value)
+        self.stats = {"bytes": 0, "lines": 0, "samples": 0, "errors": 0, "batches": 0}
+        self._tail = b""
+        self._last_full_frame = None
+
+    def feed(self, block, host_time_ns=None):
+        """Split a raw block, decode the complete lines and queue the resulting Batch."""
+        if host_time_ns is None:
+            host_time_ns = time.time_ns()
+        self.stats["bytes"] += len(block)
+        lines = (self._tail + block).split(b"\n")
+        self._tail = lines.pop()    # Incomplete last line waits for the next block
+        if lines:
+            batch = self.decode_lines(lines, host_time_ns)
+            self.stats["batches"] += 1
+            self.batches.put(batch)
+
+    def decode_lines(self, lines, host_time_ns):
+        batch = Batch(host_time_ns)
+        json_lines = []
+        for line in lines:
+            line = line.strip()
+            if not line:
+                continue
+            first = line[:1]
+            if first == b"{":
+                json_lines.append(line)
+            elif first == b"$" and len(line) > 2:
+                self._decode_binary(line, batch)
+            else:
+                batch.texts.append(line.decode("utf-8", errors="replace"))
+        self.stats["lines"] += len(lines)
+        if json_lines:
+            self._decode_json(json_lines, batch)
+        return batch
+
+    def _decode_binary(self, line, batch):
+        decoder = self.frame_decoders.get(chr(line[1]))
+        if decoder is None:
+            batch.texts.append(line.decode("utf-8", errors="replace"))
+            return
+        try:
+            kind, value = decoder(line[2:])
+        except Exception:
+            self.stats["errors"] += 1
+            return
+        if kind == "log":
+            batch.logs.append(value)
+        elif kind == "sub":
+            value["timestamp_ms"] = batch.host_time_ns // 1_000_000
+            batch.subs.append(value)
+        else:
+            batch.binary.append((kind, value))
+
+    def _decode_json(self, json_lines, batch):
+        block = b"[" + b",".join(json_lines) + b"]"
+        try:
+            objects = json.loads(block)     # One parse for the whole block
+        except ValueError:
+            objects = None
+        if objects is None and (b"nan" in block or b"inf" in block):
+            json_lines = [_C_NONFINITE.sub(lambda m: _NONFINITE_JSON[m.groups()], line) for line in json_lines]
+            try:
+                objects = json.loads(b"[" + b",".join(json_lines) + b"]")
+            except ValueError:
+                pass
+        if objects is None:
+            objects = []
+            for line in json_lines:     # A corrupt line (e.g. interleaved console output): isolate it
+                try:
+                    objects.append(json.loads(line))
+                except ValueError:
+                    self.stats["errors"] += 1
+                    batch.texts.append(line.decode("utf-8", errors="replace"))
+        timestamp_ms = batch.host_time_ns // 1_000_000
+        for obj in objects:
+            if not isinstance(obj, dict):
+                continue
+            if "sub" in obj:
+                obj["timestamp_ms"] = timestamp_ms  # Own channel subset and rate: kept out of the main sample stream
+                batch.subs.append(obj)
+            elif "names" in obj and "temperatures" in obj:
+                if obj.get("partial"):
+                    obj = merge_partial_frame(self._last_full_frame, obj)
+                    if obj is None:
+                        continue    # Wait for the next heartbeat to get the full channel set
+                else:
+                    self._last_full_frame = obj
+                obj["timestamp_ms"] = timestamp_ms
+                batch.samples.append(obj)
+            else:
+                batch.configs.append({"timestamp_ms": timestamp_ms, "config_point": obj})
+        self.stats["samples"] += len(batch.samples)
+
+    def run(self, source, stop_event):
+        """Pump source.read() into the engine until stop_event is set; source errors propagate."""
+        while not stop_event.is_set():
+            block = source.read()
+            if block:
+                self.feed(block)
+
+
+class SerialSource:
+    """pyserial port: returns everything buffered, or blocks up to the port timeout for the first byte."""
+
+    def __init__(self, ser, block_size=READ_BLOCK):
+        self.ser = ser
+        self.block_size = block_size
+
+    def read(self):
+        return self.ser.read(min(max(1, self.ser.in_waiting), self.block_size))
+
+
+class FdSource:
+    """Raw file descriptor (pty, pipe, socket): select() then one os.read of up to block_size."""
+
+    def __init__(self, fd, block_size=READ_BLOCK, timeout_s=0.05):
+        self.fd = fd
+        self.block_size = block_size
+        self.timeout_s = timeout_s
+
+    def read(self):
+        ready, _, _ = select.select([self.fd], [], [], self.timeout_s)
+        if not ready:
+            return b""
+        try:
+            block = os.read(self.fd, self.block_size)
+        except OSError as e:    # EIO: pty whose other side was closed
+            raise ConnectionError(f"port closed: {e}") from e
+        if not block:
+            raise ConnectionError("port closed")
+        return block
+
+
+class Port:
+    """
+    An open device port: read() for IngestEngine.run(), write() for commands. Uses pyserial when it
+    is installed; without it, POSIX tty paths (e.g. pseudo-terminals) are opened as raw descriptors.
+    """
+
+    def __init__(self, path, baudrate=115200, timeout_s=0.05):
+        self.path = path
+        try:
+            import serial
+        except ImportError:
+            serial = None
+        if serial is not None:
+            self.ser = serial.serial_for_url(path, baudrate=baudrate, timeout=timeout_s)
+            self.source = SerialSource(self.ser)
+        else:
+            import tty
+            self.ser = None
+            self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+            tty.setraw(self.fd)
+            self.source = FdSource(self.fd, timeout_s=timeout_s)
+
+    def read(self):
+        return self.source.read()
+
+    def write(self, data):
+        if self.ser is not None:
+            self.ser.write(data)
+        else:
+            os.write(self.fd, data)
+
+    def close(self):
+        if self.ser is not None:
+            self.ser.close()
+        else:
+            os.close(self.fd)
@@ -0,0 +1,120 @@
+"""
+Live temperature plot with constant refresh cost.
+
+LiveSeries keeps, per channel, the min and max of each time bucket. New rows only touch the last
+bucket; once there are more than 2 x max_buckets buckets, neighbouring pairs are merged and the
+bucket width doubles. The plot therefore never has more than ~4 x max_buckets points per channel,
+however long the capture. Rows come from ColumnStore.read_since(), so the plot never takes the
+ingest lock and each refresh only reads what was flushed since the previous one.
+"""
+
+import math
+
+MAX_BUCKETS = 1000
+INITIAL_BUCKET_MS = 100
+
+
+class LiveSeries:
+    def __init__(self, max_buckets=MAX_BUCKETS, bucket_ms=INITIAL_BUCKET_MS):
+        self.max_buckets = max_buckets
+        self.initial_bucket_ms = bucket_ms
+        self.cursor = None
+        self.reset([])
+
+    def reset(self, names):
+        self.names = list(names)
+        self.bucket_ms = self.initial_bucket_ms
+        self.starts = []                            # Bucket start times (ms)
+        self.mins = [[] for _ in self.names]        # Per channel, per bucket
+        self.maxs = [[] for _ in self.names]
+
+    def update(self, store):
+        """Fold the rows flushed since the last update into the buckets. Returns True if anything changed."""
+        chunks, self.cursor = store.read_since(self.cursor)
+        for names, timestamps, columns in chunks:
+            if names != self.names:
+                self.reset(names)   # Channel set changed: the plot follows the new set
+            for row, timestamp in enumerate(timestamps):
+                self._add(timestamp, [column[row] for column in columns])
+        return bool(chunks)
+
+    def _add(self, timestamp, values):
+        if not self.starts or timestamp >= self.starts[-1] + self.bucket_ms:
+            if self.starts and len(self.starts) >= 2 * self.max_buckets:
+                self._halve()
+            if self.starts and timestamp < self.starts[-1] + self.bucket_ms:
+                pass    # The merge widened the last bucket enough to take this row
+            else:
+                start = timestamp - timestamp % self.bucket_ms
+                self.starts.append(start)
+                for mins, maxs in zip(self.mins, self.maxs):
+                    mins.append(math.inf)
+                    maxs.append(-math.inf)
+        for mins, maxs, value in zip(self.mins, self.maxs, values):
+            if value < mins[-1]:    # NaN compares false on both sides and is skipped
+                mins[-1] = value
+            if value > maxs[-1]:
+                maxs[-1] = value
+
+    def _halve(self):
+        """Merge bucket pairs aligned to twice the current width."""
+        self.bucket_ms *= 2
+        starts, mins, maxs = [], [[] for _ in self.names], [[] for _ in self.names]
+        for i, start in enumerate(self.starts):
+            aligned = start - start % self.bucket_ms
+            if starts and starts[-1] == aligned:
+                for c in range(len(self.names)):
+                    mins[c][-1] = min(mins[c][-1], self.mins[c][i])
+                    maxs[c][-1] = max(maxs[c][-1], self.maxs[c][i])
+            else:
+                starts.append(aligned)
+                for c in range(len(self.names)):
+                    mins[c].append(self.mins[c][i])
+                    maxs[c].append(self.maxs[c][i])
+        self.starts, self.mins, self.maxs = starts, mins, maxs
+
+    def points(self, channel, origin_ms):
+        """x (s relative to origin_ms), y of the min/max envelope: two points per bucket at its centre."""
+        xs, ys = [], []
+        half = self.bucket_ms / 2
+        for start, lo, hi in zip(self.starts, self.mins[channel], self.maxs[channel]):
+            if lo > hi:
+                continue    # Only NaN in this bucket
+            x = (start + half - origin_ms) / 1000.0
+            xs += (x, x)
+            ys += (lo, hi)
+        return xs, ys
+
+
+def show_live_plot(store, series, refresh_ms=1000):
+    """Opens a window that refreshes from the store every refresh_ms until it is closed."""
+    import matplotlib.pyplot as plt
+    from matplotlib.animation import FuncAnimation
+
+    fig, ax = plt.subplots(figsize=(10, 6))
+    ax.set_xlabel("Time (seconds relative to start)")
+    ax.set_ylabel("Temperatures (C)")
+    ax.set_title("Temperature vs Time")
+    ax.grid(True)
+    lines = []
+
+    def refresh(_frame):
+        if not series.update(store) and lines:
+            return lines
+        if len(lines) != len(series.names) or [line.get_label() for line in lines] != series.names:
+            for line in lines:
+                line.remove()
+            lines[:] = [ax.plot([], [], label=name, linewidth=1)[0] for name in series.names]
+            if lines:
+                ax.legend(loc="upper left")
+        origin = series.starts[0] if series.starts else 0
+        for channel, line in enumerate(lines):
+            line.set_data(*series.points(channel, origin))
+        ax.relim()
+        ax.autoscale_view()
+        return lines
+
+    refresh(None)
+    animation = FuncAnimation(fig, refresh, interval=refresh_ms, cache_frame_data=False)
+    plt.show() # Blocks until the window is closed; ingestion keeps running in its own threads
+    del animation
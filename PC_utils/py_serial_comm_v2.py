@@ -1,13 +1,16 @@
 
 import serial
-import json
 import threading
 import time
 import datetime
 import csv
 from collections import deque
-import matplotlib.pyplot as plt
 import os
+import queue
+from ingest import IngestEngine, SerialSource
+from colstore import ColumnStore
+from rawconv import RawConverter, RawRecorder
+from liveplot import LiveSeries, show_live_plot
 
 # --- Configuration ---
 ESP_SERIAL_PORT = "COM8"  # <<<<<<< IMPORTANT: Use correct ESP32-C6 COM port
@@ -22,11 +25,15 @@ data_lock = threading.Lock()
 stop_event = threading.Event()
 g_serial_instance = None
 datadir = "sensor_data"
+storedir = os.path.join(datadir, "store") # Columnar capture of every sample, independent of max_log_size
+rawdir = os.path.join(datadir, "raw_store") # Codes and descriptors of raw subscriptions, for later reconversion
 sampling_interval = 1000
 
-def serial_reader_thread_func(port, baudrate, data_list, config_list, lock, stop_event_flag):
+engine = IngestEngine()
+
+def serial_reader_thread_func(port, baudrate, stop_event_flag):
     """
-    Thread function to read serial data, parse JSON, and append to a shared list.
+    Thread function that keeps the port open and pumps raw blocks into the ingest engine.
     """
     ser = None
     global g_serial_instance
@@ -36,7 +43,7 @@ def serial_reader_thread_func(port, baudrate, data_list, config_list, lock, stop
                 print(f"Attempting to connect to {port} at {baudrate} baud...")
                 # For ESP32 native USB, DTR/RTS handling might be important for resets or bootloader
                 # For general communication after boot, it might not be strictly needed.
-                ser = serial.Serial(port=None, baudrate=baudrate, timeout=1) # Open later
+                ser = serial.Serial(port=None, baudrate=baudrate, timeout=0.05) # Open later; short timeout bounds the stop latency
                 ser.port = port
                 # ser.dtr = False # Data Terminal Ready - uncomment if connection issues
                 # ser.rts = False # Request To Send - uncomment if connection issues
@@ -45,39 +52,7 @@ def serial_reader_thread_func(port, baudrate, data_list, config_list, lock, stop
                 print(f"Connected to {ser.name}")
                 time.sleep(0.1) # Small delay after opening
 
-            if ser.in_waiting > 0:
-                line_bytes = ser.readline()
-                if line_bytes:
-                    try:
-                        line_str = line_bytes.decode('utf-8').strip()
-                        if line_str: # Ensure it's not an empty line after strip
-                            data_point = json.loads(line_str)
-                            with lock:
-                                if "names" in data_point and "temperatures" in data_point:
-                                    data_point['timestamp_ms'] = time.time_ns() // 1_000_000
-                                    data_list.append(data_point)
-                                else:
-                                    config_point = {
-                                        "timestamp_ms": time.time_ns() // 1_000_000,
-                                        "config_point": data_point
-                                    }
-                                    if "sampling_interval_ms" in data_point:
-                                        global sampling_interval
-                                        sampling_interval = data_point["sampling_interval_ms"]
-                                        print(f"Updated sampling interval to {sampling_interval} ms")
-                                    config_list.append(config_point) 
-                            # print(f"Logged: {data_point}") # Uncomment for verbose logging
-                    except json.JSONDecodeError as e:
-                        # print(f"JSON Decode Error: {e} - Received: '{line_str}'")
-                        # print(f"Received non-JSON: '{line_str}'")
-                        print(line_str) #type: ignore
-                    except UnicodeDecodeError as e:
-                        print(f"Unicode Decode Error: {e} - Received bytes: {line_bytes}")
-                    except Exception as e:
-                        print(f"An unexpected error occurred while processing data: {e}")
-            else:
-                # No data, sleep briefly to avoid busy-waiting if timeout is short or None
-                time.sleep(0.01)
+            engine.run(SerialSource(ser), stop_event_flag)
 
         except serial.SerialException as e:
             print(f"Serial Error: {e}. Reconnecting in 5 seconds...")
@@ -97,6 +72,44 @@ def serial_reader_thread_func(port, baudrate, data_list, config_list, lock, stop
     g_serial_instance = None
     print("Serial reader thread stopped.")
 
+def batch_consumer_thread_func(data_list, config_list, lock, store, converter, recorder, stop_event_flag):
+    """
+    Thread function that takes decoded batches from the ingest engine, appends them to the shared logs
+    (holding the lock once per batch) and streams the samples to the column store. Raw subscription
+    frames are recorded as codes and converted per batch into the data log.
+    """
+    global sampling_interval
+    while not stop_event_flag.is_set():
+        try:
+            batch = engine.batches.get(timeout=0.2)
+        except queue.Empty:
+            store.append([]) # Lets the time-based flush run while the device is quiet
+            recorder.append([])
+            continue
+        raw_samples = converter.observe(batch)
+        with lock:
+            data_list.extend(batch.samples)
+            data_list.extend(raw_samples)
+            config_list.extend(batch.configs)
+        store.append(batch.samples)
+        recorder.append(batch.subs)
+        for config_point in batch.configs:
+            data_point = config_point["config_point"]
+            if "alarm" in data_point:
+                print(f"ALARM: {data_point['alarm']}")
+            if "rate" in data_point:
+                print(f"Sampling interval {data_point['rate']['previous_ms']} -> {data_point['rate']['interval_ms']} ms ({data_point['rate']['reason']})")
+            if "sampling_interval_ms" in data_point:
+                sampling_interval = data_point["sampling_interval_ms"]
+                print(f"Updated sampling interval to {sampling_interval} ms")
+        for line_str in batch.logs:
+            print(line_str)
+        for line_str in batch.texts:
+            print(line_str)
+    store.close()
+    recorder.close()
+    print("Batch consumer thread stopped.")
+
 def clear_data_log(data_list, lock):
     """Clears the sensor data log."""
     with lock:
@@ -159,74 +172,28 @@ def save_data_log_csv(data_list, config_list, lock):
             writer.writerow(row)
 
 
-def plot_data_log(data_list, lock):
-    """Plots the sensor data log."""
-    if not data_list:
-        print("No data to plot.")
-        return
-
-    # Copy data to a local list while holding the lock
-    with lock:
-        data_to_plot = list(data_list)
-
-    names = data_to_plot[0].get('names', [])
-
-    # Extract data
-    timestamps_ms = [d.get('timestamp_ms', 0) for d in data_to_plot]
-    # names = [d.get('names', []) for d in data_to_plot]
-    temps = [d.get('temperatures', []) for d in data_to_plot]
-
-    # Convert timestamps to seconds relative to the first timestamp
-    if timestamps_ms:
-        start_time_ms = timestamps_ms[0]
-        relative_timestamps_sec = [(ts - start_time_ms) / 1000.0 for ts in timestamps_ms]
-    else:
-        relative_timestamps_sec = []
-
-    # Plotting logic moved inside the function
-    if relative_timestamps_sec:
-        
-        plt.figure(figsize=(10, 6))
-        # temps_by_sensor = list(zip(*temps))
-        # for sensor_temps, name in zip(temps_by_sensor, names):
-        #     plt.plot(relative_timestamps_sec, sensor_temps, label=name)
-        plt.plot(relative_timestamps_sec, temps, label = names)
-        plt.xlabel("Time (seconds relative to start)")
-        plt.ylabel("Temperatures (C)")
-        plt.title("Temperature vs Time")
-        plt.legend()
-        
-        plt.grid(True)
-
-        # # Plot 2: Temperatures vs Time
-        # plt.figure(figsize=(10, 6))
-        # plt.plot(relative_timestamps_sec, temps, label="External Temp")
-        # plt.plot(relative_timestamps_sec, internal_temps, label="Internal Temp")
-        # plt.xlabel("Time (seconds relative to start)")
-        # plt.ylabel("Temperature (°C)")
-        # plt.title("Temperature vs Time")
-        # plt.legend()
-        # plt.grid(True)
-
-        plt.show() # This will block until plot windows are closed
-    else:
-        print("No data points to plot.")
-
-    # Import matplotlib here to avoid needing it if plotting is never used
-    # import matplotlib.pyplot as plt
-
 def main():
     global max_log_size, sensor_data_log, config_log
     print("Starting ESP32 Data Logger...")
     print(f"Logging data to a list with max size: {max_log_size}")
 
-    # Start the serial reader thread
+    # Start the serial reader thread and the consumer of its decoded batches
     reader_thread = threading.Thread(
         target=serial_reader_thread_func,
-        args=(ESP_SERIAL_PORT, BAUD_RATE, sensor_data_log, config_log, data_lock, stop_event),
+        args=(ESP_SERIAL_PORT, BAUD_RATE, stop_event),
         daemon=True # Daemon threads exit when the main program exits
     )
     reader_thread.start()
+    store = ColumnStore(storedir)
+    recorder = RawRecorder(rawdir)
+    converter = RawConverter(on_descriptor=recorder.add_descriptor)
+    live_series = LiveSeries() # Kept across plot windows, so reopening only reads the new rows
+    consumer_thread = threading.Thread(
+        target=batch_consumer_thread_func,
+        args=(sensor_data_log, config_log, data_lock, store, converter, recorder, stop_event),
+        daemon=True
+    )
+    consumer_thread.start()
 
     print("Reader thread started. Press Ctrl+C to stop.")
     time.sleep(1)
@@ -235,7 +202,7 @@ def main():
         while True:
             
             print(f"\nEnter command: \
-                  \n(c)lear data log, (cc)lear config log, (r)efresh to show prompt, (s)ave data and config, (g)raph, (q)uit, (d)ata latest \
+                  \n(c)lear data log, (cc)lear config log, (r)efresh to show prompt, (s)ave data and config, (g)raph live, (q)uit, (d)ata latest, (st)ore summary \
                   \nTo change the 'max_log_size' use `size <new_size>` (currently max_log_size = {max_log_size} -> {sampling_interval/1000 * max_log_size} seconds for current sampling interval of {sampling_interval/1000}s.)\
                   \nTo send a remote command use 'cmd <device_recognisable_cmd>'")
             command = input("> ").strip().lower()
@@ -245,9 +212,12 @@ def main():
             elif command == 'cc':
                 clear_config_log(config_log, data_lock)
             elif command == 's':
-                save_data_log_csv(sensor_data_log, config_log, data_lock)
+                # CSV export of the in-memory log runs in the background; the column store already has every sample
+                threading.Thread(target=save_data_log_csv, args=(sensor_data_log, config_log, data_lock), daemon=True).start()
+            elif command == 'st':
+                print(f"Column store: {store.summary()}")
             elif command == 'g':
-                plot_data_log(sensor_data_log, data_lock)
+                show_live_plot(store, live_series)
             elif command == 'q':
                 break # Exit the loop
             elif command == 'r':
@@ -295,6 +265,7 @@ def main():
         if reader_thread.is_alive():
             print("Waiting for reader thread to finish...")
             reader_thread.join(timeout=5) # Wait for the thread to close
+        consumer_thread.join(timeout=1)
         print("Application stopped.")
 
 if __name__ == "__main__":
@@ -0,0 +1,340 @@
+"""
+Host-side conversion of raw ADC code subscriptions (`sub add <name> raw <divisor> ...`).
+
+A raw subscription sends packed 12-bit codes ("$R" frames) instead of temperatures. Before its first
+frame, and whenever a conversion parameter changes, the device sends a descriptor: a header line,
+one line per channel (divider resistance, calibration offset, model and the k0/k1/k3 coefficients
+temp_comp evaluates) and the calibrated code -> mV table of every ADC unit in use ("$C" frames).
+Every frame carries the conversion generation of its codes, and RawConverter converts it with the
+descriptor of that generation, in whole blocks at once with numpy, in float32 like the firmware,
+so the results match the device's own readings.
+
+RawRecorder keeps the codes and their generation in one column store per subscription (both are
+exact in float32) and the descriptors in descriptors.jsonl next to them, so a capture can be
+converted again later, e.g. with an improved model:
+
+    python rawconv.py sensor_data/raw_store --csv raw.csv
+    python rawconv.py sensor_data/raw_store --descriptor improved.json
+
+An override descriptor has the format of a descriptors.jsonl line; a channel that gives a "model"
+but no "k" gets its coefficients derived from the model.
+"""
+
+import argparse
+import bisect
+import csv
+import json
+import math
+import os
+import sys
+
+from colstore import ColumnStore
+
+try:
+    import numpy as np
+except ImportError:     # Frames are still recorded; conversion needs numpy
+    np = None
+
+KELVIN_OFFSET = 273.15
+T25_K = 298.15
+DESCRIPTOR_FILE = "descriptors.jsonl"
+GENERATION_COLUMN = "generation"    # First column of a raw store segment, before the 1-based channel indices
+MAX_WAITING_FRAMES = 100000         # Frames held for a descriptor still being received
+
+
+def k_from_model(model):
+    """temp_model_build(): 1/T = k0 + k1 ln(R) + k3 ln(R)^3 for a Steinhart-Hart or Beta model."""
+    if model["type"] == "beta":
+        return [1.0 / T25_K - math.log(model["r25"]) / model["beta"], 1.0 / model["beta"], 0.0]
+    return [model["a"], model["b"], model["c"]]
+
+
+class RawDescriptor:
+    """Conversion parameters of one raw subscription: the header, its channel lines and the calibration tables."""
+
+    def __init__(self, header, timestamp_ms=None):
+        self.sub_id = header["id"]
+        self.name = header.get("sub")
+        self.generation = header["generation"]
+        self.max_code = header["max_code"]
+        self.indices = list(header["channels"])
+        self.adc_cal = {unit: None for unit in header["adc_cal"]}    # 1-based unit -> list of mV per code
+        self.channels = {}      # 1-based index -> raw_channel object
+        self.timestamp_ms = timestamp_ms
+
+    @property
+    def complete(self):
+        return all(i in self.channels for i in self.indices) and all(table is not None for table in self.adc_cal.values())
+
+    def to_json(self):
+        return {"timestamp_ms": self.timestamp_ms, "sub": self.name, "id": self.sub_id, "generation": self.generation,
+                "max_code": self.max_code, "channels": self.indices,
+                "adc_cal": {str(unit): table for unit, table in self.adc_cal.items()},
+                "channel_params": {str(index): channel for index, channel in self.channels.items()}}
+
+    @classmethod
+    def from_json(cls, obj):
+        descriptor = cls({**obj, "adc_cal": []}, obj.get("timestamp_ms"))
+        descriptor.adc_cal = {int(unit): table for unit, table in obj["adc_cal"].items()}
+        descriptor.channels = {int(index): channel for index, channel in obj["channel_params"].items()}
+        for channel in descriptor.channels.values():
+            if "k" not in channel:
+                channel["k"] = k_from_model(channel["model"])
+        return descriptor
+
+    def names(self, indices):
+        return [self.channels[i]["name"] if i in self.channels else str(i) for i in indices]
+
+
+def convert_codes(descriptor, indices, codes):
+    """
+    Temperatures (C) of a block of codes: rows are cycles, columns the 1-based channels in indices.
+    Mirrors _code_to_resistance() and temp_model_to_celsius() in float32; codes the firmware would
+    reject (rails, voltage outside the calibrated full scale, unknown channel) give NaN.
+    """
+    if np is None:
+        raise RuntimeError("numpy is required to convert raw codes")
+    f32 = np.float32
+    codes = np.asarray(codes, dtype=np.int32).reshape(-1, len(indices))
+    columns = len(indices)
+    max_code = descriptor.max_code
+    lut = np.empty((columns, max_code + 1), f32)      # Code -> divider voltage (mV or code) per column
+    full = np.empty(columns, f32)                     # Voltage of max_code: the ratio is taken against it
+    divider, offset, k = np.full(columns, np.nan, f32), np.zeros(columns, f32), np.zeros((3, columns), f32)
+    for col, index in enumerate(indices):
+        channel = descriptor.channels.get(index)
+        table = descriptor.adc_cal.get(channel["unit"]) if channel is not None else None
+        if table is not None:
+            lut[col] = np.asarray(table[:max_code + 1], f32)
+        else:
+            lut[col] = np.arange(max_code + 1, dtype=f32)
+        full[col] = lut[col, max_code]
+        if channel is not None:
+            divider[col], offset[col] = channel["divider_r"], channel["cal_r"]
+            k[:, col] = channel["k"]
+    v = lut[np.arange(columns), np.clip(codes, 0, max_code)]
+    with np.errstate(divide="ignore", invalid="ignore", over="ignore"):
+        r = divider * v / (full - v) + offset
+        log_r = np.log(r)
+        t = f32(1.0) / (k[0] + k[1] * log_r + k[2] * log_r * log_r * log_r) - f32(KELVIN_OFFSET)
+    t[(codes <= 0) | (codes >= max_code) | (v <= 0) | (v >= full) | ~(r > 0)] = np.nan
+    return t
+
+
+class RawConverter:
+    """
+    Follows the raw subscriptions of one device stream and converts their frames block by block.
+
+    Each frame is converted with the descriptor of the generation it carries, whatever order frames
+    and descriptor lines arrive in, so a parameter change never applies to codes taken before it.
+    Frames of the generation whose descriptor is still arriving (its "$C" tables may span batches)
+    wait for it; frames of a generation that was never described are counted unconverted.
+    """
+
+    def __init__(self, on_descriptor=None):
+        self.on_descriptor = on_descriptor      # callable(RawDescriptor) when a descriptor completes
+        self.descriptors = {}   # (sub_id, generation) -> complete RawDescriptor
+        self.pending = {}       # sub_id -> RawDescriptor still waiting for channel lines or tables
+        self.waiting = []       # Frames of a pending descriptor's generation, oldest first
+        self.adc_cal = {}       # 1-based unit -> mV per code; the tables are fixed at boot
+        self.stats = {"frames": 0, "converted": 0, "unconverted": 0}
+
+    def _add_cal_chunk(self, chunk):
+        table = self.adc_cal.setdefault(chunk["unit"], [])
+        end = chunk["offset"] + len(chunk["mv"])
+        if len(table) < end:
+            table.extend([None] * (end - len(table)))
+        table[chunk["offset"]:end] = chunk["mv"]
+
+    def _complete_pending(self):
+        for sub_id, descriptor in list(self.pending.items()):
+            for unit in descriptor.adc_cal:
+                table = self.adc_cal.get(unit)
+                if table is not None and len(table) > descriptor.max_code and None not in table[:descriptor.max_code + 1]:
+                    descriptor.adc_cal[unit] = table[:descriptor.max_code + 1]
+            if descriptor.complete:
+                del self.pending[sub_id]
+                self.descriptors[(sub_id, descriptor.generation)] = descriptor
+                if self.on_descriptor is not None:
+                    self.on_descriptor(descriptor)
+
+    def observe(self, batch):
+        """Apply the descriptor parts of a batch, then return its raw frames converted to samples
+        ({'sub_id', 'cycle', 'names', 'temperatures', 'timestamp_ms'})."""
+        for kind, value in batch.binary:
+            if kind == "adc_cal":
+                self._add_cal_chunk(value)
+        frames = []
+        for obj in batch.subs:
+            if "raw_descriptor" in obj:
+                header = {**obj["raw_descriptor"], "sub": obj["sub"]}
+                self._complete_pending()    # The previous generation may complete in this same batch
+                self.pending[header["id"]] = RawDescriptor(header, obj["timestamp_ms"])
+            elif "raw_channel" in obj:
+                descriptor = next((d for d in self.pending.values() if d.name == obj["sub"]), None)
+                if descriptor is not None:
+                    descriptor.channels[obj["raw_channel"]["index"]] = obj["raw_channel"]
+            elif "codes" in obj:
+                frames.append(obj)
+        self._complete_pending()
+        self.stats["frames"] += len(frames)
+        if np is None:
+            self.stats["unconverted"] += len(frames)
+            return []
+
+        frames, self.waiting = self.waiting + frames, []
+        samples = []
+        start = 0
+        while start < len(frames):  # Runs of frames with the same subscription, generation and channel set form one block
+            sub_id, generation, indices = frames[start]["sub_id"], frames[start]["generation"], frames[start]["indices"]
+            end = start + 1
+            while (end < len(frames) and frames[end]["sub_id"] == sub_id and frames[end]["generation"] == generation
+                   and frames[end]["indices"] == indices):
+                end += 1
+            descriptor = self.descriptors.get((sub_id, generation))
+            pending = self.pending.get(sub_id)
+            if descriptor is None and indices and pending is not None and pending.generation == generation:
+                self.waiting.extend(frames[start:end])
+            elif descriptor is None or not indices:
+                self.stats["unconverted"] += end - start
+            else:
+                block = convert_codes(descriptor, indices, [frame["codes"] for frame in frames[start:end]])
+                names_row = descriptor.names(indices)
+                for frame, row in zip(frames[start:end], block.tolist()):
+                    samples.append({"sub_id": sub_id, "cycle": frame["cycle"], "names": names_row, "temperatures": row,
+                                    "timestamp_ms": frame["timestamp_ms"]})
+                self.stats["converted"] += end - start
+            start = end
+        if len(self.waiting) > MAX_WAITING_FRAMES:
+            self.stats["unconverted"] += len(self.waiting) - MAX_WAITING_FRAMES
+            del self.waiting[:-MAX_WAITING_FRAMES]
+        return samples
+
+
+class RawRecorder:
+    """Raw codes in one ColumnStore per subscription (<directory>/sub<id>: the generation column, then a column per
+    1-based channel index), descriptors appended to <directory>/descriptors.jsonl."""
+
+    def __init__(self, directory):
+        self.directory = directory
+        os.makedirs(directory, exist_ok=True)
+        self.stores = {}
+
+    def add_descriptor(self, descriptor):
+        with open(os.path.join(self.directory, DESCRIPTOR_FILE), "a", encoding="utf-8") as f:
+            f.write(json.dumps(descriptor.to_json(), separators=(",", ":")) + "\n")
+
+    def append(self, subs):
+        """Append the raw frames among a batch's subscription objects; [] lets the time-based flushes run."""
+        rows = {}
+        for obj in subs:
+            if "codes" in obj:
+                rows.setdefault(obj["sub_id"], []).append({"names": [GENERATION_COLUMN] + [str(i) for i in obj["indices"]],
+                                                           "temperatures": [obj["generation"]] + obj["codes"],
+                                                           "timestamp_ms": obj["timestamp_ms"]})
+        for sub_id, samples in rows.items():
+            if sub_id not in self.stores:
+                self.stores[sub_id] = ColumnStore(os.path.join(self.directory, f"sub{sub_id}"))
+            self.stores[sub_id].append(samples)
+        for sub_id, store in self.stores.items():
+            if sub_id not in rows:
+                store.append([])
+
+    def close(self):
+        for store in self.stores.values():
+            store.close()
+
+
+def load_descriptors(directory):
+    """Descriptors recorded next to a raw store, per sub_id in time order."""
+    descriptors = {}
+    path = os.path.join(directory, DESCRIPTOR_FILE)
+    if os.path.isfile(path):
+        with open(path, encoding="utf-8") as f:
+            for line in f:
+                if line.strip():
+                    descriptor = RawDescriptor.from_json(json.loads(line))
+                    descriptors.setdefault(descriptor.sub_id, []).append(descriptor)
+    return descriptors
+
+
+def reconvert(directory, override=None):
+    """
+    Convert a recorded raw store again. Yields (sub_id, names, timestamps, temperatures) per segment
+    and descriptor, each row converted with the descriptor of its recorded generation (the last one
+    recorded for it), or with override for every row of its subscription. Rows of a generation with
+    no recorded descriptor are skipped. Stores recorded without the generation column fall back to
+    the latest descriptor recorded at or before each row (the first one for earlier rows).
+    """
+    descriptors = load_descriptors(directory)
+    if override is not None:
+        descriptors[override.sub_id] = [override]
+    for entry in sorted(os.listdir(directory)):
+        if not entry.startswith("sub") or not os.path.isdir(os.path.join(directory, entry)):
+            continue
+        sub_id = int(entry[3:])
+        history = descriptors.get(sub_id)
+        if not history:
+            print(f"{entry}: no descriptor recorded, skipped", file=sys.stderr)
+            continue
+        by_generation = {d.generation: d for d in history}
+        starts = [d.timestamp_ms if d.timestamp_ms is not None else -math.inf for d in history]
+        for names, timestamps, columns in ColumnStore(os.path.join(directory, entry)).read_range(-math.inf, math.inf):
+            timestamps = np.frombuffer(timestamps, dtype=np.int64)
+            columns = [np.frombuffer(column, dtype=np.float32) for column in columns]
+            if names and names[0] == GENERATION_COLUMN:
+                names, generations, columns = names[1:], columns[0].astype(np.int64), columns[1:]
+            else:
+                generations = None
+            indices = [int(name) for name in names]
+            codes = np.column_stack(columns).astype(np.int32)
+            if generations is not None:
+                bounds = [0] + (np.flatnonzero(np.diff(generations)) + 1).tolist() + [len(generations)]
+                for lo, hi in zip(bounds[:-1], bounds[1:]):     # Runs of rows with one generation
+                    descriptor = override if override is not None else by_generation.get(int(generations[lo]))
+                    if descriptor is None:
+                        print(f"{entry}: {hi - lo} rows of generation {generations[lo]} have no descriptor, skipped", file=sys.stderr)
+                        continue
+                    yield sub_id, descriptor.names(indices), timestamps[lo:hi], convert_codes(descriptor, indices, codes[lo:hi])
+                continue
+            first, last = (max(bisect.bisect_right(starts, ts) - 1, 0) for ts in (timestamps[0], timestamps[-1]))
+            for d in range(first, last + 1):    # Rows from this descriptor's arrival to the next one's
+                lo = 0 if d == first else np.searchsorted(timestamps, starts[d], "left")
+                hi = len(timestamps) if d == last else np.searchsorted(timestamps, starts[d + 1], "left")
+                if lo < hi:
+                    yield sub_id, history[d].names(indices), timestamps[lo:hi], convert_codes(history[d], indices, codes[lo:hi])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a recorded raw ADC code store to temperatures.")
+    parser.add_argument("directory", help="raw store directory, e.g. sensor_data/raw_store")
+    parser.add_argument("--descriptor", help="JSON descriptor (a descriptors.jsonl line) to use instead of the recorded ones")
+    parser.add_argument("--csv", help="write timestamp_ms, sub_id and one column per channel to this file")
+    args = parser.parse_args()
+    if np is None:
+        sys.exit("numpy is required to convert raw codes")
+    override = None
+    if args.descriptor:
+        with open(args.descriptor, encoding="utf-8") as f:
+            override = RawDescriptor.from_json(json.load(f))
+
+    writer = out = None
+    if args.csv:
+        out = open(args.csv, "w", newline="", encoding="utf-8")
+        writer = csv.writer(out)
+    try:
+        for sub_id, names, timestamps, temperatures in reconvert(args.directory, override):
+            if writer is not None:
+                writer.writerow(["timestamp_ms", "sub_id"] + names)
+                for ts, row in zip(timestamps.tolist(), temperatures.tolist()):
+                    writer.writerow([ts, sub_id] + ["" if math.isnan(v) else f"{v:.4f}" for v in row])
+            with np.errstate(all="ignore"):
+                means = np.nanmean(temperatures, axis=0) if len(temperatures) else []
+            print(f"sub {sub_id}: {len(timestamps)} rows, " + ", ".join(f"{n} {m:.2f} C" for n, m in zip(names, means)))
+    finally:
+        if out is not None:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
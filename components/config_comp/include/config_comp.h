@@ -3,17 +3,40 @@
 #include "esp_err.h"
 #include <stdbool.h>
 #include "esp_adc/adc_oneshot.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
 
-#define MAX_CONFIG_UPDATE_CALLBACKS     3
 #define DEFAULT_MEASUREMENT_INTERVAL_MS 1000
 #define MIN_SAMPLING_INTERVAL_MS        100
 #define MAX_SAMPLING_INTERVAL_MS        3600000
-#define MAX_THERMISTOR_COUNT            6
+#define MAX_THERMISTOR_COUNT            CONFIG_THERMISTRON_MAX_THERMISTORS // Kconfig, 1..64
+#define MAX_MUX_ADDR_BITS               6
+#define MUX_ADDRESS_DIRECT              -1   // Thermistor wired straight to its ADC pin
+#define MAX_MUX_SETTLE_US               10000
 #define ADC_BITWIDTH                    ADC_BITWIDTH_12
-#define ADC_ATTENUATION                 ADC_ATTEN_DB_12  // Supposedely ADC_ATTEN_DB_12 → 150 mV ~ 2450 mV
-#define ADC_UNIT_ID                     ADC_UNIT_1
+#define ADC_ATTENUATION                 ADC_ATTEN_DB_12  // Supposedely ADC_ATTEN_DB_12 → 150 mV ~ 2450 mV; non-linear, corrected by the eFuse curve fit in temp_comp
+#define ADC_UNIT_COUNT                  2    // ADC_UNIT_1 and ADC_UNIT_2, sampled concurrently
 #define DEFAULT_CAL_R_STEP              50 // Ohm, default calibration resistance step of incr/decr functions
 #define MAX_CAL_R_OFFSET                5000
+#define MAX_FILTER_MEDIAN_WINDOW        7    // Odd window sizes 3..7; 0 or 1 disables the median stage
+#define DEFAULT_DEADBAND_ABS_C          0.1f // C, report-on-change absolute deadband
+#define DEFAULT_DEADBAND_REL            0.0f // fraction of the last reported value, 0: off
+#define DEFAULT_HEARTBEAT_MS            60000
+#define MAX_HEARTBEAT_MS                MAX_SAMPLING_INTERVAL_MS
+#define DEFAULT_STATS_WINDOW_SAMPLES    60   // Samples per tumbling statistics window
+#define MIN_STATS_WINDOW_SAMPLES        2
+#define MAX_STATS_WINDOW_SAMPLES        100000
+#define DEFAULT_ADAPTIVE_MIN_MS         200  // Interval used while any channel is active
+#define DEFAULT_ADAPTIVE_MAX_MS         10000 // Floor rate once everything is stable
+#define DEFAULT_ADAPTIVE_RATE_C_PER_MIN 2.0f
+#define DEFAULT_ADAPTIVE_STDDEV_C       0.5f
+#define DEFAULT_ADAPTIVE_HYSTERESIS     0.5f // Calm means below threshold * hysteresis
+#define DEFAULT_ADAPTIVE_CALM_CYCLES    10
+#define MAX_ADAPTIVE_CALM_CYCLES        10000
+#define CONFIG_CHANNEL_ALL              -1   // Channel of a change event that is not about one thermistor
+#define DEFAULT_CONFIG_EVENT_DEPTH      16   // Change events buffered per subscriber before they collapse into CONFIG_FIELD_ALL
 
 // NOTE: bitwidth and attenuation really go to the channel measurement in the sensor components:
 //adc_oneshot_chan_cfg_t channel_config = {
@@ -25,23 +48,138 @@
 extern "C" {
 #endif
 
-typedef void (*config_update_callback_t)(void);
+// What a setter changed. Per-thermistor fields carry the 0-based index in ConfigChangeEvent_t.channel.
+typedef enum {
+    CONFIG_FIELD_ALL = 0,               // Events were lost, re-read everything
+    CONFIG_FIELD_SAMPLING_INTERVAL,
+    CONFIG_FIELD_STREAM_ACTIVE,
+    CONFIG_FIELD_STREAM_MODE,
+    CONFIG_FIELD_DEADBAND,
+    CONFIG_FIELD_HEARTBEAT,
+    CONFIG_FIELD_STATS_WINDOW,
+    CONFIG_FIELD_LOG_TEMPS,
+    CONFIG_FIELD_LOW_POWER,
+    CONFIG_FIELD_ADAPTIVE,
+    CONFIG_FIELD_THERMISTOR_COUNT,
+    CONFIG_FIELD_THERMISTOR,            // Per thermistor: name, divider resistor, ADC channel, mux address
+    CONFIG_FIELD_CALIBRATION,           // Per thermistor: calibration resistance offset
+    CONFIG_FIELD_MODEL,                 // Per thermistor
+    CONFIG_FIELD_FILTER,                // Per thermistor
+    CONFIG_FIELD_ALARM,                 // Per thermistor
+    CONFIG_FIELD_MUX,
+    CONFIG_FIELD_COUNT
+} ConfigField_t;
+
+#define CONFIG_FIELD_BIT(field)         (1UL << (field))
+#define CONFIG_FIELD_MASK_ALL           ((1UL << CONFIG_FIELD_COUNT) - 1)
+
+typedef struct {
+    ConfigField_t field;
+    int           channel;              // 0-based thermistor index, CONFIG_CHANNEL_ALL for global settings
+    uint32_t      seq;                  // Increments with every published change
+} ConfigChangeEvent_t;
+
+// Storage of one subscription, owned by the subscriber (usually static). Members are private to config_comp.
+typedef struct ConfigSubscription {
+    QueueHandle_t              events;
+    StaticQueue_t              events_queue;
+    uint32_t                   field_mask;      // CONFIG_FIELD_BIT() of the fields it wants
+    TaskHandle_t               task;            // Woken on every event, NULL: poll only
+    uint32_t                   notify_bits;
+    volatile bool              overflowed;      // Events were dropped: the next change read is CONFIG_FIELD_ALL
+    struct ConfigSubscription *next;
+} ConfigSubscription_t;
+
+typedef enum {
+    STREAM_MODE_FULL = 0,       // Full snapshot every sampling interval
+    STREAM_MODE_ON_CHANGE,      // Only channels that moved beyond the deadband, plus a periodic full heartbeat
+    STREAM_MODE_STATS,          // One aggregate statistics record per completed window instead of raw samples
+} StreamMode_t;
+
+// Per-channel filter chain, applied in order: median -> IIR -> Kalman.
+// An all-zero FilterConfig_t is a pass-through (every stage disabled).
+typedef struct {
+    int     median_window;                  // 0/1: disabled, otherwise odd, <= MAX_FILTER_MEDIAN_WINDOW
+    float   iir_alpha;                      // 0: disabled, otherwise 0 < alpha < 1 (weight of the new sample)
+    float   kalman_q;                       // Process noise variance (C^2). 0: Kalman stage disabled
+    float   kalman_r;                       // Measurement noise variance (C^2), must be > 0 when kalman_q > 0
+} FilterConfig_t;
+
+typedef enum {
+    THERM_MODEL_STEINHART_HART = 0,         // 1/T = a + b ln(R) + c ln(R)^3
+    THERM_MODEL_BETA,                       // 1/T = 1/T25 + ln(R/R25) / beta
+} ThermistorModelType_t;
+
+typedef struct {
+    ThermistorModelType_t type;
+    float   a, b, c;                        // Steinhart-Hart coefficients (T in K, R in Ohm)
+    float   beta;                           // K
+    float   r25;                            // Ohm at 25 C
+} ThermistorModel_t;
+
+// Generic 10k NTC, used for every slot until a model is set or calibrated
+#define DEFAULT_THERM_MODEL { .type = THERM_MODEL_STEINHART_HART, .a = 0.001129148f, .b = 0.000234125f, .c = 0.0000000876741f, \
+                              .beta = 3950.0f, .r25 = 10000.0f }
+
+// Per-channel alarm rules, evaluated by temp_comp right after each conversion.
+// An all-zero AlarmConfig_t disables every rule.
+typedef struct {
+    bool    enabled;                        // Threshold rules (low/high) enabled
+    float   low_c;                          // Raised below low_c, cleared above low_c + hysteresis_c
+    float   high_c;                         // Raised above high_c, cleared below high_c - hysteresis_c
+    float   hysteresis_c;                   // >= 0
+    float   max_rate_c_per_min;             // |dT/dt| limit, 0: rate rule disabled
+} AlarmConfig_t;
 
 typedef struct {
     char    name[10];
     int     divider_resistor_value;         // Ohm
     int     calibration_resistance_offset;  // Ohm
     int     adc_channel;
+    int     adc_unit;                       // ADC_UNIT_1 (default) or ADC_UNIT_2
+    int     mux_address;                    // MUX_ADDRESS_DIRECT, or the mux input selected on the address lines
+    ThermistorModel_t model;                // Resistance -> temperature conversion
+    FilterConfig_t filter;                  // Default: all stages disabled
+    AlarmConfig_t alarm;                    // Default: all rules disabled
 } ThermistorConfig_t;
 
 
+// Adaptive sampling: the interval drops to min_interval_ms as soon as any channel is active
+// (|dT/dt| or short-term std dev above its threshold) and doubles back toward max_interval_ms
+// after calm_cycles consecutive cycles with every channel below threshold * hysteresis.
+typedef struct {
+    bool    enabled;
+    int     min_interval_ms;
+    int     max_interval_ms;
+    float   rate_c_per_min;                 // 0: dT/dt not used
+    float   stddev_c;                       // 0: std dev not used
+    float   hysteresis;                     // 0 < hysteresis <= 1
+    int     calm_cycles;
+} AdaptiveConfig_t;
+
+// External analog multiplexers share the address lines; each mux output goes to its own ADC pin,
+// so a logical thermistor is addressed by (adc_channel, mux_address).
+typedef struct {
+    int     addr_bits;                      // Number of address lines in use, 0: no multiplexers
+    int     addr_gpios[MAX_MUX_ADDR_BITS];  // LSB first
+    int     settle_us;                      // Delay after switching the address, before converting
+} MuxConfig_t;
+
 typedef struct {
     int     sampling_interval_ms;                               // Default: 10000, Min: 1000
     bool    serial_stream_active;                               // Default: false
+    StreamMode_t stream_mode;                                   // Default: STREAM_MODE_FULL
+    float   deadband_abs_c;                                     // Default: DEFAULT_DEADBAND_ABS_C, 0: off
+    float   deadband_rel;                                       // Default: DEFAULT_DEADBAND_REL, 0: off
+    int     heartbeat_ms;                                       // Default: DEFAULT_HEARTBEAT_MS
+    int     stats_window_samples;                               // Default: DEFAULT_STATS_WINDOW_SAMPLES
     bool    log_temp_measurements;                              // Default: false -> whether to log temperatures to console 
+    bool    low_power_mode;                                     // Default: false -> automatic light sleep between samples
+    AdaptiveConfig_t adaptive;                                  // Default: disabled, DEFAULT_ADAPTIVE_* bounds/thresholds
     int     thermistor_count;                                   // Number of active thermistors
     ThermistorConfig_t thermistors[MAX_THERMISTOR_COUNT];       // Array of thermistor pin names
-    adc_oneshot_unit_handle_t adc_unit_handle; 
+    MuxConfig_t mux;                                            // Defaults from Kconfig
+    adc_oneshot_unit_handle_t adc_unit_handles[ADC_UNIT_COUNT];  // NULL if the unit failed to initialize
 } AppConfig_t;
 
 
@@ -55,10 +193,34 @@ int config_comp_get_sampling_interval();
 esp_err_t config_comp_set_serial_stream_active(bool active);
 bool config_comp_get_serial_stream_active();
 
+esp_err_t config_comp_set_stream_mode(StreamMode_t mode);
+StreamMode_t config_comp_get_stream_mode();
+
+esp_err_t config_comp_set_deadband(float abs_c, float rel);
+esp_err_t config_comp_get_deadband(float *abs_c, float *rel);
+
+esp_err_t config_comp_set_heartbeat(int heartbeat_ms);
+int config_comp_get_heartbeat();
+
+esp_err_t config_comp_set_stats_window(int window_samples);
+int config_comp_get_stats_window();
+
 esp_err_t config_comp_set_log_temps_active(bool active);
 bool config_comp_get_log_temps_active();
 
+esp_err_t config_comp_set_low_power_mode(bool active);
+bool config_comp_get_low_power_mode();
+
+esp_err_t config_comp_set_adaptive_config(const AdaptiveConfig_t *adaptive);
+esp_err_t config_comp_get_adaptive_config(AdaptiveConfig_t *adaptive);
+
 esp_err_t config_comp_update_thermistor_count();
+
+/**
+ * @brief Recount the used thermistor slots and publish CONFIG_FIELD_ALL, so every subscriber
+ *        re-reads the whole configuration in its own task.
+ */
+esp_err_t config_comp_request_refresh();
 int config_comp_get_thermistor_count();
 
 esp_err_t config_comp_set_thermistor_config(int index, const ThermistorConfig_t *config);
@@ -70,10 +232,60 @@ esp_err_t config_comp_get_calibration_resistance_offset(int index, int *offset);
 esp_err_t config_comp_incr_calibration_resistance_offset(int index);
 esp_err_t config_comp_decr_calibration_resistance_offset(int index);
 
-esp_err_t config_comp_get_adc_unit_handle(adc_oneshot_unit_handle_t *adc_unit_handle);
+esp_err_t config_comp_set_thermistor_model(int index, const ThermistorModel_t *model);
+esp_err_t config_comp_get_thermistor_model(int index, ThermistorModel_t *model);
+
+esp_err_t config_comp_set_filter_config(int index, const FilterConfig_t *filter);
+esp_err_t config_comp_get_filter_config(int index, FilterConfig_t *filter);
+
+esp_err_t config_comp_set_alarm_config(int index, const AlarmConfig_t *alarm);
+esp_err_t config_comp_get_alarm_config(int index, AlarmConfig_t *alarm);
+
+esp_err_t config_comp_get_mux_config(MuxConfig_t *mux);
+esp_err_t config_comp_set_mux_settle_us(int settle_us);
+
+/**
+ * @brief Oneshot handle of one ADC unit.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, or ESP_ERR_INVALID_STATE if that unit is not available.
+ */
+esp_err_t config_comp_get_adc_unit_handle(adc_unit_t unit, adc_oneshot_unit_handle_t *adc_unit_handle);
+
+/**
+ * @brief RAM reserved at build time by the component (configuration and its mutex), for the boot memory report.
+ */
+size_t config_comp_get_static_ram_bytes(void);
+
+/**
+ * @brief Subscribe to configuration change events.
+ *
+ * Every setter publishes one ConfigChangeEvent_t after the new value is stored. Events matching
+ * field_mask are queued for the subscriber (up to depth); if the queue is full they are dropped
+ * and the next config_comp_next_change() returns CONFIG_FIELD_ALL instead. Setters never block
+ * on subscribers. There is no limit on the number of subscriptions, and no heap is used:
+ * the subscriber provides the subscription and the event queue storage.
+ *
+ * @param subscription  Subscription storage, must stay valid until config_comp_unsubscribe().
+ * @param field_mask    CONFIG_FIELD_BIT() of the wanted fields, or CONFIG_FIELD_MASK_ALL.
+ * @param event_storage depth events, e.g. static ConfigChangeEvent_t events[DEFAULT_CONFIG_EVENT_DEPTH].
+ * @param depth         Events buffered.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, or ESP_FAIL.
+ */
+esp_err_t config_comp_subscribe(ConfigSubscription_t *subscription, uint32_t field_mask, ConfigChangeEvent_t *event_storage, int depth);
+
+/**
+ * @brief Wake a task on every event of the subscription: notify_bits are set in its notification
+ *        value (eSetBits), so it can wait with xTaskNotifyWait(). Pass NULL to poll instead.
+ *        If events are already pending, the task is notified right away.
+ */
+esp_err_t config_comp_subscription_set_task(ConfigSubscription_t *subscription, TaskHandle_t task, uint32_t notify_bits);
+
+/**
+ * @brief Pop the next pending change without blocking.
+ * @return true if event was filled, false when there is nothing pending.
+ */
+bool config_comp_next_change(ConfigSubscription_t *subscription, ConfigChangeEvent_t *event);
 
-esp_err_t config_comp_register_update_callback(config_update_callback_t callback);
-esp_err_t config_comp_unregister_update_callback(config_update_callback_t callback);
+esp_err_t config_comp_unsubscribe(ConfigSubscription_t *subscription);
 
 
 #ifdef __cplusplus
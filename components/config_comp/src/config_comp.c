@@ -1,21 +1,40 @@
 #include "config_comp.h"
 #include "freertos/FreeRTOS.h" // Required for mutex
 #include "freertos/semphr.h"  // Required for mutex
+#include "freertos/queue.h"
 #include "esp_log.h"
 #include <string.h>
+#include <math.h>
 
 static const char *TAG = "config_comp";
 static AppConfig_t s_app_config;
 static SemaphoreHandle_t s_config_mutex = NULL;
-static config_update_callback_t s_update_callbacks[MAX_CONFIG_UPDATE_CALLBACKS] = {NULL};
+static StaticSemaphore_t s_config_mutex_struct;
 
-static void notify_config_updated() {
-    for (int i = 0; i < MAX_CONFIG_UPDATE_CALLBACKS; ++i) {
-        if (s_update_callbacks[i] != NULL) {
-            ESP_LOGD(TAG, "Notifying callback %d of config update", i);
-            s_update_callbacks[i]();
+// Config event bus: every subscriber has its own event queue and is woken through a task notification
+static ConfigSubscription_t *s_subscriptions = NULL; // Guarded by s_config_mutex
+static uint32_t s_change_seq = 0;                    // Guarded by s_config_mutex
+
+static void notify_config_updated(ConfigField_t field, int channel) {
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    ConfigChangeEvent_t event = {
+        .field = field,
+        .channel = channel,
+        .seq = ++s_change_seq,
+    };
+    for (ConfigSubscription_t *sub = s_subscriptions; sub != NULL; sub = sub->next) {
+        if ((sub->field_mask & CONFIG_FIELD_BIT(field)) == 0) {
+            continue;
+        }
+        if (xQueueSend(sub->events, &event, 0) != pdTRUE) {
+            sub->overflowed = true; // Never block a setter on a slow subscriber
+        }
+        if (sub->task != NULL) {
+            xTaskNotify(sub->task, sub->notify_bits, eSetBits);
         }
     }
+    xSemaphoreGive(s_config_mutex);
+    ESP_LOGD(TAG, "Published config change %u: field %d, channel %d", (unsigned)event.seq, field, channel);
 }
 
 static void _update_thermistor_count() {
@@ -32,7 +51,7 @@ static void _update_thermistor_count() {
 esp_err_t config_comp_init() {
     esp_err_t ret = ESP_OK;
 
-    s_config_mutex = xSemaphoreCreateMutex();
+    s_config_mutex = xSemaphoreCreateMutexStatic(&s_config_mutex_struct);
     if (s_config_mutex == NULL) {
         ESP_LOGE(TAG, "Failed to create config mutex");
         return ESP_FAIL; // Or a more specific error
@@ -43,36 +62,76 @@ esp_err_t config_comp_init() {
     // Initialize the application configuration with default values
     s_app_config.sampling_interval_ms = DEFAULT_MEASUREMENT_INTERVAL_MS;
     s_app_config.serial_stream_active = false;
+    s_app_config.stream_mode = STREAM_MODE_FULL;
+    s_app_config.deadband_abs_c = DEFAULT_DEADBAND_ABS_C;
+    s_app_config.deadband_rel = DEFAULT_DEADBAND_REL;
+    s_app_config.heartbeat_ms = DEFAULT_HEARTBEAT_MS;
+    s_app_config.stats_window_samples = DEFAULT_STATS_WINDOW_SAMPLES;
     s_app_config.log_temp_measurements = false;
-    s_app_config.thermistor_count = 5;
-
-    // Definition below is silly in that I'm hardcoding 6 thermistors, so MAX_THERMISTOR_COUNT doesn't make much sense
-    // If I change the MAX_THERMISTOR_COUNT, I should also change the hardcode below
-    const ThermistorConfig_t thermistors[MAX_THERMISTOR_COUNT] = {
-
-        {"Therm1",  9782, 0, ADC_CHANNEL_0}, // Example values
-        {"Therm2",  9795, 0, ADC_CHANNEL_1},
-        {"Therm3",  9888, 0, ADC_CHANNEL_2},
-        {"Therm4",  9963, 0, ADC_CHANNEL_3},
-        {"Therm5", 10233, 0, ADC_CHANNEL_4},
-        {"UNUSED", 10000, 0, ADC_CHANNEL_5} // <-- unused slot
+    s_app_config.low_power_mode = false;
+    s_app_config.adaptive = (AdaptiveConfig_t){
+        .enabled = false,
+        .min_interval_ms = DEFAULT_ADAPTIVE_MIN_MS,
+        .max_interval_ms = DEFAULT_ADAPTIVE_MAX_MS,
+        .rate_c_per_min = DEFAULT_ADAPTIVE_RATE_C_PER_MIN,
+        .stddev_c = DEFAULT_ADAPTIVE_STDDEV_C,
+        .hysteresis = DEFAULT_ADAPTIVE_HYSTERESIS,
+        .calm_cycles = DEFAULT_ADAPTIVE_CALM_CYCLES,
     };
 
-    memcpy(s_app_config.thermistors, thermistors, sizeof(thermistors));
+    // Example board: the first slots are wired straight to ADC pins. Remaining slots (up to
+    // MAX_THERMISTOR_COUNT, set in Kconfig) start UNUSED and are configured with 'set therm'.
+    static const ThermistorConfig_t default_thermistors[] = {
+        {.name = "Therm1", .divider_resistor_value =  9782, .adc_channel = ADC_CHANNEL_0, .mux_address = MUX_ADDRESS_DIRECT, .model = DEFAULT_THERM_MODEL},
+        {.name = "Therm2", .divider_resistor_value =  9795, .adc_channel = ADC_CHANNEL_1, .mux_address = MUX_ADDRESS_DIRECT, .model = DEFAULT_THERM_MODEL},
+        {.name = "Therm3", .divider_resistor_value =  9888, .adc_channel = ADC_CHANNEL_2, .mux_address = MUX_ADDRESS_DIRECT, .model = DEFAULT_THERM_MODEL},
+        {.name = "Therm4", .divider_resistor_value =  9963, .adc_channel = ADC_CHANNEL_3, .mux_address = MUX_ADDRESS_DIRECT, .model = DEFAULT_THERM_MODEL},
+        {.name = "Therm5", .divider_resistor_value = 10233, .adc_channel = ADC_CHANNEL_4, .mux_address = MUX_ADDRESS_DIRECT, .model = DEFAULT_THERM_MODEL},
+    };
+    const int default_count = sizeof(default_thermistors) / sizeof(default_thermistors[0]);
+
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (i < default_count) {
+            s_app_config.thermistors[i] = default_thermistors[i];
+        } else {
+            ThermistorConfig_t unused = {.name = "UNUSED", .divider_resistor_value = 10000,
+                                         .adc_channel = ADC_CHANNEL_5, .mux_address = MUX_ADDRESS_DIRECT, .model = DEFAULT_THERM_MODEL};
+            s_app_config.thermistors[i] = unused;
+        }
+    }
+
+    const int mux_gpios[MAX_MUX_ADDR_BITS] = {
+        CONFIG_THERMISTRON_MUX_ADDR_GPIO0, CONFIG_THERMISTRON_MUX_ADDR_GPIO1, CONFIG_THERMISTRON_MUX_ADDR_GPIO2,
+        CONFIG_THERMISTRON_MUX_ADDR_GPIO3, CONFIG_THERMISTRON_MUX_ADDR_GPIO4, CONFIG_THERMISTRON_MUX_ADDR_GPIO5,
+    };
+    s_app_config.mux.addr_bits = CONFIG_THERMISTRON_MUX_ADDR_BITS;
+    memcpy(s_app_config.mux.addr_gpios, mux_gpios, sizeof(mux_gpios));
+    s_app_config.mux.settle_us = CONFIG_THERMISTRON_MUX_SETTLE_US;
+    for (int b = 0; b < s_app_config.mux.addr_bits; ++b) {
+        if (s_app_config.mux.addr_gpios[b] < 0) {
+            ESP_LOGE(TAG, "Mux address line %d has no GPIO assigned, multiplexer support disabled", b);
+            s_app_config.mux.addr_bits = 0;
+            break;
+        }
+    }
 
     _update_thermistor_count();
 
-    // Initialize ADC unit handle
-    adc_oneshot_unit_init_cfg_t adc_init_cfg = {
-        .unit_id = ADC_UNIT_ID,
-        .ulp_mode = ADC_ULP_MODE_DISABLE,
-    };
-    
-    ret = adc_oneshot_new_unit(&adc_init_cfg, &s_app_config.adc_unit_handle);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize ADC unit: %s", esp_err_to_name(ret));
-        xSemaphoreGive(s_config_mutex);
-        return ret;
+    // Initialize one oneshot handle per ADC unit. ADC1 is required; without ADC2 only its thermistors fail.
+    for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+        adc_oneshot_unit_init_cfg_t adc_init_cfg = {
+            .unit_id = (adc_unit_t)unit,
+            .ulp_mode = ADC_ULP_MODE_DISABLE,
+        };
+        ret = adc_oneshot_new_unit(&adc_init_cfg, &s_app_config.adc_unit_handles[unit]);
+        if (ret != ESP_OK) {
+            s_app_config.adc_unit_handles[unit] = NULL;
+            ESP_LOGE(TAG, "Failed to initialize ADC unit %d: %s", unit + 1, esp_err_to_name(ret));
+            if (unit == ADC_UNIT_1) {
+                xSemaphoreGive(s_config_mutex);
+                return ret;
+            }
+        }
     }
 
     ESP_LOGI(TAG, "Initial configuration completed successfully");
@@ -100,7 +159,7 @@ esp_err_t config_comp_set_sampling_interval(int sampling_interval_ms){
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
     s_app_config.sampling_interval_ms = sampling_interval_ms;
     xSemaphoreGive(s_config_mutex);
-    notify_config_updated();
+    notify_config_updated(CONFIG_FIELD_SAMPLING_INTERVAL, CONFIG_CHANNEL_ALL);
     ESP_LOGI(TAG, "Sampling interval set to %d ms", sampling_interval_ms);
     return ESP_OK;
 }
@@ -117,7 +176,7 @@ esp_err_t config_comp_set_serial_stream_active(bool active) {
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
     s_app_config.serial_stream_active = active;
     xSemaphoreGive(s_config_mutex);
-    notify_config_updated();
+    notify_config_updated(CONFIG_FIELD_STREAM_ACTIVE, CONFIG_CHANNEL_ALL);
     ESP_LOGI(TAG, "Serial stream is now %s", active ? "active" : "inactive");
     return ESP_OK;
 }
@@ -130,11 +189,100 @@ bool config_comp_get_serial_stream_active() {
     return active;
 }
 
+esp_err_t config_comp_set_stream_mode(StreamMode_t mode) {
+    if (mode != STREAM_MODE_FULL && mode != STREAM_MODE_ON_CHANGE && mode != STREAM_MODE_STATS) {
+        ESP_LOGE(TAG, "Unknown stream mode %d", mode);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.stream_mode = mode;
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_STREAM_MODE, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Stream mode set to %s", mode == STREAM_MODE_ON_CHANGE ? "on-change" : mode == STREAM_MODE_STATS ? "stats" : "full");
+    return ESP_OK;
+}
+
+StreamMode_t config_comp_get_stream_mode() {
+    StreamMode_t mode;
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    mode = s_app_config.stream_mode;
+    xSemaphoreGive(s_config_mutex);
+    return mode;
+}
+
+esp_err_t config_comp_set_deadband(float abs_c, float rel) {
+    if (!(abs_c >= 0.0f) || !(rel >= 0.0f) || rel >= 1.0f) {
+        ESP_LOGE(TAG, "Deadband must satisfy abs >= 0 C and 0 <= rel < 1, got abs=%.3f rel=%.3f", abs_c, rel);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.deadband_abs_c = abs_c;
+    s_app_config.deadband_rel = rel;
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_DEADBAND, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Deadband set to abs %.3f C, rel %.3f", abs_c, rel);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_get_deadband(float *abs_c, float *rel) {
+    if (abs_c == NULL || rel == NULL) {
+        ESP_LOGE(TAG, "Provided deadband pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *abs_c = s_app_config.deadband_abs_c;
+    *rel = s_app_config.deadband_rel;
+    xSemaphoreGive(s_config_mutex);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_set_heartbeat(int heartbeat_ms) {
+    if (heartbeat_ms < MIN_SAMPLING_INTERVAL_MS || heartbeat_ms > MAX_HEARTBEAT_MS) {
+        ESP_LOGE(TAG, "Heartbeat must be between %d and %d ms", MIN_SAMPLING_INTERVAL_MS, MAX_HEARTBEAT_MS);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.heartbeat_ms = heartbeat_ms;
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_HEARTBEAT, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Heartbeat set to %d ms", heartbeat_ms);
+    return ESP_OK;
+}
+
+int config_comp_get_heartbeat() {
+    int heartbeat_ms;
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    heartbeat_ms = s_app_config.heartbeat_ms;
+    xSemaphoreGive(s_config_mutex);
+    return heartbeat_ms;
+}
+
+esp_err_t config_comp_set_stats_window(int window_samples) {
+    if (window_samples < MIN_STATS_WINDOW_SAMPLES || window_samples > MAX_STATS_WINDOW_SAMPLES) {
+        ESP_LOGE(TAG, "Statistics window must be between %d and %d samples", MIN_STATS_WINDOW_SAMPLES, MAX_STATS_WINDOW_SAMPLES);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.stats_window_samples = window_samples;
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_STATS_WINDOW, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Statistics window set to %d samples", window_samples);
+    return ESP_OK;
+}
+
+int config_comp_get_stats_window() {
+    int window_samples;
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    window_samples = s_app_config.stats_window_samples;
+    xSemaphoreGive(s_config_mutex);
+    return window_samples;
+}
+
 esp_err_t config_comp_set_log_temps_active(bool active) {
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
     s_app_config.log_temp_measurements = active;
     xSemaphoreGive(s_config_mutex);
-    notify_config_updated();
+    notify_config_updated(CONFIG_FIELD_LOG_TEMPS, CONFIG_CHANNEL_ALL);
     ESP_LOGI(TAG, "Logging temperature measurements to console is now %s", active ? "active" : "inactive");
     return ESP_OK;
 }
@@ -147,15 +295,81 @@ bool config_comp_get_log_temps_active() {
     return active;
 }
 
+esp_err_t config_comp_set_low_power_mode(bool active) {
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.low_power_mode = active;
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_LOW_POWER, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Low-power (light sleep) mode is now %s", active ? "active" : "inactive");
+    return ESP_OK;
+}
+
+bool config_comp_get_low_power_mode() {
+    bool active;
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    active = s_app_config.low_power_mode;
+    xSemaphoreGive(s_config_mutex);
+    return active;
+}
+
+esp_err_t config_comp_set_adaptive_config(const AdaptiveConfig_t *adaptive) {
+    if (adaptive == NULL) {
+        ESP_LOGE(TAG, "Provided adaptive config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (adaptive->min_interval_ms < MIN_SAMPLING_INTERVAL_MS || adaptive->max_interval_ms > MAX_SAMPLING_INTERVAL_MS ||
+        adaptive->min_interval_ms > adaptive->max_interval_ms) {
+        ESP_LOGE(TAG, "Adaptive bounds must satisfy %d <= min <= max <= %d ms", MIN_SAMPLING_INTERVAL_MS, MAX_SAMPLING_INTERVAL_MS);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(adaptive->rate_c_per_min >= 0.0f) || !(adaptive->stddev_c >= 0.0f) ||
+        (adaptive->enabled && adaptive->rate_c_per_min == 0.0f && adaptive->stddev_c == 0.0f)) {
+        ESP_LOGE(TAG, "Adaptive thresholds must be >= 0, and at least one > 0 when enabled");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(adaptive->hysteresis > 0.0f && adaptive->hysteresis <= 1.0f) ||
+        adaptive->calm_cycles < 1 || adaptive->calm_cycles > MAX_ADAPTIVE_CALM_CYCLES) {
+        ESP_LOGE(TAG, "Adaptive hysteresis must be in (0, 1] and calm cycles in 1..%d", MAX_ADAPTIVE_CALM_CYCLES);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.adaptive = *adaptive;
+    xSemaphoreGive(s_config_mutex);
+    ESP_LOGI(TAG, "Adaptive sampling %s: %d..%d ms, rate %.2f C/min, std dev %.2f C, hysteresis %.2f, calm %d cycles",
+             adaptive->enabled ? "enabled" : "disabled", adaptive->min_interval_ms, adaptive->max_interval_ms,
+             adaptive->rate_c_per_min, adaptive->stddev_c, adaptive->hysteresis, adaptive->calm_cycles);
+    notify_config_updated(CONFIG_FIELD_ADAPTIVE, CONFIG_CHANNEL_ALL);
+    return ESP_OK;
+}
+esp_err_t config_comp_get_adaptive_config(AdaptiveConfig_t *adaptive) {
+    if (adaptive == NULL) {
+        ESP_LOGE(TAG, "Provided adaptive config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *adaptive = s_app_config.adaptive;
+    xSemaphoreGive(s_config_mutex);
+    return ESP_OK;
+}
+
 esp_err_t config_comp_update_thermistor_count() {
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
     _update_thermistor_count();
     xSemaphoreGive(s_config_mutex);
-    notify_config_updated();
+    notify_config_updated(CONFIG_FIELD_THERMISTOR_COUNT, CONFIG_CHANNEL_ALL);
     ESP_LOGI(TAG, "Thermistor count updated to %d", s_app_config.thermistor_count);
     return ESP_OK;
 }
 
+esp_err_t config_comp_request_refresh() {
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    _update_thermistor_count();
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_ALL, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Full refresh requested");
+    return ESP_OK;
+}
+
 int config_comp_get_thermistor_count() {
     int count;
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
@@ -174,13 +388,26 @@ esp_err_t config_comp_set_thermistor_config(int index, const ThermistorConfig_t
         ESP_LOGE(TAG, "Provider thermistor config pointer provided is null");
         return ESP_ERR_INVALID_ARG;
     }
+    if (memchr(config->name, '\0', sizeof(config->name)) == NULL || config->divider_resistor_value <= 0 ||
+        config->adc_channel < 0 || config->adc_channel > ADC_CHANNEL_9 || config->adc_unit < 0 || config->adc_unit >= ADC_UNIT_COUNT) {
+        ESP_LOGE(TAG, "Invalid thermistor config: name must be < %d chars, divider resistor > 0, ADC channel 0..%d, ADC unit 1..%d",
+                 (int)sizeof(config->name), ADC_CHANNEL_9, ADC_UNIT_COUNT);
+        return ESP_ERR_INVALID_ARG;
+    }
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    int mux_addresses = 1 << s_app_config.mux.addr_bits;
+    if (config->mux_address != MUX_ADDRESS_DIRECT && (s_app_config.mux.addr_bits == 0 ||
+        config->mux_address < 0 || config->mux_address >= mux_addresses)) {
+        xSemaphoreGive(s_config_mutex);
+        ESP_LOGE(TAG, "Mux address %d is invalid: %d address lines configured", config->mux_address, s_app_config.mux.addr_bits);
+        return ESP_ERR_INVALID_ARG;
+    }
     memcpy(&s_app_config.thermistors[index], config, sizeof(ThermistorConfig_t));
     _update_thermistor_count();
     xSemaphoreGive(s_config_mutex);
-    notify_config_updated();
-    ESP_LOGI(TAG, "Thermistor %d configuration updated: %s, Resistor: %d, ADC Channel: %d",
-             index, config->name, config->divider_resistor_value, config->adc_channel);
+    notify_config_updated(CONFIG_FIELD_THERMISTOR, index);
+    ESP_LOGI(TAG, "Thermistor %d configuration updated: %s, Resistor: %d, ADC Unit: %d, ADC Channel: %d, Mux address: %d",
+             index, config->name, config->divider_resistor_value, config->adc_unit + 1, config->adc_channel, config->mux_address);
     return ESP_OK;
 }
 
@@ -212,7 +439,7 @@ esp_err_t config_comp_set_calibration_resistance_offset(int index, int offset) {
     s_app_config.thermistors[index].calibration_resistance_offset = offset;
     xSemaphoreGive(s_config_mutex);
     ESP_LOGI(TAG, "Set calibration resistance offset for thermistor %s (index: %d | 0-based index: %d) to %d Ohm", s_app_config.thermistors[index].name, index + 1, index, offset);
-    notify_config_updated();
+    notify_config_updated(CONFIG_FIELD_CALIBRATION, index);
     return ESP_OK;
 }
 
@@ -254,44 +481,272 @@ esp_err_t config_comp_get_calibration_resistance_offset(int index, int *offset)
 }
 
 
-esp_err_t config_comp_get_adc_unit_handle(adc_oneshot_unit_handle_t *adc_unit_handle) {
-    if (adc_unit_handle == NULL) {
-        ESP_LOGE(TAG, "Provided adc_unit_handle pointer is null");
+static esp_err_t _validate_thermistor_model(const ThermistorModel_t *model) {
+    if (model->type == THERM_MODEL_STEINHART_HART) {
+        if (!isfinite(model->a) || !isfinite(model->b) || !isfinite(model->c) || !(model->b > 0.0f)) {
+            ESP_LOGE(TAG, "Steinhart-Hart coefficients must be finite with B > 0");
+            return ESP_ERR_INVALID_ARG;
+        }
+    } else if (model->type == THERM_MODEL_BETA) {
+        if (!(model->beta > 0.0f && isfinite(model->beta)) || !(model->r25 > 0.0f && isfinite(model->r25))) {
+            ESP_LOGE(TAG, "Beta model requires beta > 0 K and R25 > 0 Ohm");
+            return ESP_ERR_INVALID_ARG;
+        }
+    } else {
+        ESP_LOGE(TAG, "Unknown thermistor model type %d", model->type);
         return ESP_ERR_INVALID_ARG;
     }
+    return ESP_OK;
+}
+
+esp_err_t config_comp_set_thermistor_model(int index, const ThermistorModel_t *model) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        ESP_LOGE(TAG, "Thermistor index %d (%d for 0-based internal logic) is out of bounds", index + 1, index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (model == NULL) {
+        ESP_LOGE(TAG, "Provided thermistor model pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = _validate_thermistor_model(model);
+    if (ret != ESP_OK) {
+        return ret;
+    }
     xSemaphoreTake(s_config_mutex, portMAX_DELAY);
-    *adc_unit_handle = s_app_config.adc_unit_handle;
+    s_app_config.thermistors[index].model = *model;
     xSemaphoreGive(s_config_mutex);
-    ESP_LOGI(TAG, "Retrieved ADC unit handle");
+    if (model->type == THERM_MODEL_BETA) {
+        ESP_LOGI(TAG, "Thermistor %s (index: %d) model set to Beta %.1f K, R25 %.1f Ohm",
+                 s_app_config.thermistors[index].name, index + 1, model->beta, model->r25);
+    } else {
+        ESP_LOGI(TAG, "Thermistor %s (index: %d) model set to Steinhart-Hart A %.6e, B %.6e, C %.6e",
+                 s_app_config.thermistors[index].name, index + 1, model->a, model->b, model->c);
+    }
+    notify_config_updated(CONFIG_FIELD_MODEL, index);
     return ESP_OK;
 }
 
-esp_err_t config_comp_register_update_callback(config_update_callback_t callback) {
-    if (callback == NULL) {
+esp_err_t config_comp_get_thermistor_model(int index, ThermistorModel_t *model) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        ESP_LOGE(TAG, "Thermistor index %d (%d for 0-based internal logic) is out of bounds", index + 1, index);
         return ESP_ERR_INVALID_ARG;
     }
-    for (int i = 0; i < MAX_CONFIG_UPDATE_CALLBACKS; ++i) {
-        if (s_update_callbacks[i] == NULL) {
-            s_update_callbacks[i] = callback;
-            ESP_LOGI(TAG, "Registered new config update callback at index %d", i);
-            return ESP_OK;
-        }
+    if (model == NULL) {
+        ESP_LOGE(TAG, "Provided thermistor model pointer is null");
+        return ESP_ERR_INVALID_ARG;
     }
-    ESP_LOGE(TAG, "Failed to register config update callback, no free slots");
-    return ESP_ERR_NO_MEM; // Or ESP_ERR_INVALID_STATE if all slots are full
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *model = s_app_config.thermistors[index].model;
+    xSemaphoreGive(s_config_mutex);
+    return ESP_OK;
 }
 
-esp_err_t config_comp_unregister_update_callback(config_update_callback_t callback) {
-    if (callback == NULL) {
+static esp_err_t _validate_filter_config(const FilterConfig_t *filter) {
+    if (filter->median_window < 0 || filter->median_window > MAX_FILTER_MEDIAN_WINDOW ||
+        (filter->median_window > 1 && filter->median_window % 2 == 0)) {
+        ESP_LOGE(TAG, "Median window must be 0 (off) or odd and <= %d, got %d", MAX_FILTER_MEDIAN_WINDOW, filter->median_window);
         return ESP_ERR_INVALID_ARG;
     }
-    for (int i = 0; i < MAX_CONFIG_UPDATE_CALLBACKS; ++i) {
-        if (s_update_callbacks[i] == callback) {
-            s_update_callbacks[i] = NULL;
-            ESP_LOGI(TAG, "Unregistered config update callback from index %d", i);
-            return ESP_OK;
-        }
+    if (!(filter->iir_alpha >= 0.0f && filter->iir_alpha < 1.0f)) {
+        ESP_LOGE(TAG, "IIR alpha must be 0 (off) or in (0, 1), got %.3f", filter->iir_alpha);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(filter->kalman_q >= 0.0f) || (filter->kalman_q > 0.0f && !(filter->kalman_r > 0.0f))) {
+        ESP_LOGE(TAG, "Kalman q must be >= 0 (0: off) and r > 0 when enabled, got q=%g r=%g", filter->kalman_q, filter->kalman_r);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t config_comp_set_filter_config(int index, const FilterConfig_t *filter) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        ESP_LOGE(TAG, "Thermistor index %d (%d for 0-based internal logic) is out of bounds", index + 1, index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (filter == NULL) {
+        ESP_LOGE(TAG, "Provided filter config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = _validate_filter_config(filter);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.thermistors[index].filter = *filter;
+    xSemaphoreGive(s_config_mutex);
+    ESP_LOGI(TAG, "Filter for thermistor %s (index: %d) set to median %d, IIR alpha %.3f, Kalman q %g r %g",
+             s_app_config.thermistors[index].name, index + 1, filter->median_window, filter->iir_alpha, filter->kalman_q, filter->kalman_r);
+    notify_config_updated(CONFIG_FIELD_FILTER, index);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_get_filter_config(int index, FilterConfig_t *filter) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        ESP_LOGE(TAG, "Thermistor index %d (%d for 0-based internal logic) is out of bounds", index + 1, index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (filter == NULL) {
+        ESP_LOGE(TAG, "Provided filter config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *filter = s_app_config.thermistors[index].filter;
+    xSemaphoreGive(s_config_mutex);
+    return ESP_OK;
+}
+
+
+esp_err_t config_comp_set_alarm_config(int index, const AlarmConfig_t *alarm) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        ESP_LOGE(TAG, "Thermistor index %d (%d for 0-based internal logic) is out of bounds", index + 1, index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (alarm == NULL) {
+        ESP_LOGE(TAG, "Provided alarm config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (alarm->enabled && !(alarm->low_c < alarm->high_c && alarm->hysteresis_c >= 0.0f &&
+                            alarm->hysteresis_c < alarm->high_c - alarm->low_c)) {
+        ESP_LOGE(TAG, "Alarm thresholds must satisfy low < high and 0 <= hysteresis < high - low");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(alarm->max_rate_c_per_min >= 0.0f)) {
+        ESP_LOGE(TAG, "Alarm rate limit must be >= 0 C/min (0: off)");
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.thermistors[index].alarm = *alarm;
+    xSemaphoreGive(s_config_mutex);
+    ESP_LOGI(TAG, "Alarm for thermistor %s (index: %d) set to %s, low %.2f C, high %.2f C, hysteresis %.2f C, rate %.2f C/min",
+             s_app_config.thermistors[index].name, index + 1, alarm->enabled ? "enabled" : "disabled",
+             alarm->low_c, alarm->high_c, alarm->hysteresis_c, alarm->max_rate_c_per_min);
+    notify_config_updated(CONFIG_FIELD_ALARM, index);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_get_alarm_config(int index, AlarmConfig_t *alarm) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        ESP_LOGE(TAG, "Thermistor index %d (%d for 0-based internal logic) is out of bounds", index + 1, index);
+        return ESP_ERR_INVALID_ARG;
     }
-    ESP_LOGW(TAG, "Failed to unregister config update callback, not found");
-    return ESP_ERR_NOT_FOUND;
-}
\ No newline at end of file
+    if (alarm == NULL) {
+        ESP_LOGE(TAG, "Provided alarm config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *alarm = s_app_config.thermistors[index].alarm;
+    xSemaphoreGive(s_config_mutex);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_get_mux_config(MuxConfig_t *mux) {
+    if (mux == NULL) {
+        ESP_LOGE(TAG, "Provided mux config pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *mux = s_app_config.mux;
+    xSemaphoreGive(s_config_mutex);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_set_mux_settle_us(int settle_us) {
+    if (settle_us < 0 || settle_us > MAX_MUX_SETTLE_US) {
+        ESP_LOGE(TAG, "Mux settling delay must be between 0 and %d us", MAX_MUX_SETTLE_US);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    s_app_config.mux.settle_us = settle_us;
+    xSemaphoreGive(s_config_mutex);
+    notify_config_updated(CONFIG_FIELD_MUX, CONFIG_CHANNEL_ALL);
+    ESP_LOGI(TAG, "Mux settling delay set to %d us", settle_us);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_get_adc_unit_handle(adc_unit_t unit, adc_oneshot_unit_handle_t *adc_unit_handle) {
+    if (adc_unit_handle == NULL || unit < 0 || unit >= ADC_UNIT_COUNT) {
+        ESP_LOGE(TAG, "Invalid ADC unit %d or null adc_unit_handle pointer", unit + 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    *adc_unit_handle = s_app_config.adc_unit_handles[unit];
+    xSemaphoreGive(s_config_mutex);
+    ESP_LOGI(TAG, "Retrieved ADC unit %d handle", unit + 1);
+    return *adc_unit_handle != NULL ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t config_comp_subscribe(ConfigSubscription_t *sub, uint32_t field_mask, ConfigChangeEvent_t *event_storage, int depth) {
+    if (sub == NULL || event_storage == NULL || field_mask == 0 || depth < 1) {
+        ESP_LOGE(TAG, "Invalid subscription: storage required, field mask must be non-zero and depth >= 1");
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(sub, 0, sizeof(ConfigSubscription_t));
+    sub->events = xQueueCreateStatic(depth, sizeof(ConfigChangeEvent_t), (uint8_t *)event_storage, &sub->events_queue);
+    if (sub->events == NULL) {
+        return ESP_FAIL;
+    }
+    sub->field_mask = field_mask;
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    sub->next = s_subscriptions;
+    s_subscriptions = sub;
+    xSemaphoreGive(s_config_mutex);
+    ESP_LOGI(TAG, "New config subscription, field mask 0x%05x, %d events deep", (unsigned)field_mask, depth);
+    return ESP_OK;
+}
+
+esp_err_t config_comp_subscription_set_task(ConfigSubscription_t *subscription, TaskHandle_t task, uint32_t notify_bits) {
+    if (subscription == NULL || (task != NULL && notify_bits == 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    subscription->task = task;
+    subscription->notify_bits = notify_bits;
+    bool pending = uxQueueMessagesWaiting(subscription->events) > 0 || subscription->overflowed;
+    xSemaphoreGive(s_config_mutex);
+    if (task != NULL && pending) {
+        xTaskNotify(task, notify_bits, eSetBits); // Changes published before the task attached
+    }
+    return ESP_OK;
+}
+
+bool config_comp_next_change(ConfigSubscription_t *subscription, ConfigChangeEvent_t *event) {
+    if (subscription == NULL || event == NULL) {
+        return false;
+    }
+    if (subscription->overflowed) {
+        // Lost events cannot be reconstructed: drop the rest and ask for a full re-read
+        subscription->overflowed = false;
+        xQueueReset(subscription->events);
+        xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+        event->seq = s_change_seq;
+        xSemaphoreGive(s_config_mutex);
+        event->field = CONFIG_FIELD_ALL;
+        event->channel = CONFIG_CHANNEL_ALL;
+        return true;
+    }
+    return xQueueReceive(subscription->events, event, 0) == pdTRUE;
+}
+
+esp_err_t config_comp_unsubscribe(ConfigSubscription_t *subscription) {
+    if (subscription == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(s_config_mutex, portMAX_DELAY);
+    ConfigSubscription_t **link = &s_subscriptions;
+    while (*link != NULL && *link != subscription) {
+        link = &(*link)->next;
+    }
+    if (*link == NULL) {
+        xSemaphoreGive(s_config_mutex);
+        ESP_LOGW(TAG, "Failed to unsubscribe from config changes, subscription not found");
+        return ESP_ERR_NOT_FOUND;
+    }
+    *link = subscription->next;
+    xSemaphoreGive(s_config_mutex);
+    vQueueDelete(subscription->events);
+    return ESP_OK;
+}
+
+size_t config_comp_get_static_ram_bytes(void) {
+    return sizeof(s_app_config) + sizeof(s_config_mutex_struct);
+}
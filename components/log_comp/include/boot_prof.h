@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Boot milestones, in the order a healthy boot usually reaches them. Acquisition and the serial link
+// come up concurrently, so the serial phases may land before or after the first sample.
+typedef enum {
+    BOOT_PHASE_APP_MAIN = 0,        // app_main entered (bootloader and IDF startup done)
+    BOOT_PHASE_LOG,                 // log_comp ready
+    BOOT_PHASE_CONFIG,              // config_comp ready, ADC units initialized
+    BOOT_PHASE_TEMP,                // temp_comp ready, channels configured
+    BOOT_PHASE_ACQUISITION,         // Measurement task running
+    BOOT_PHASE_FIRST_SAMPLE,        // First measurement cycle completed
+    BOOT_PHASE_SERIAL_INIT,         // USB Serial/JTAG driver installed, RX task running
+    BOOT_PHASE_SERIAL_READY,        // Commands are processed
+    BOOT_PHASE_COUNT
+} BootPhase_t;
+
+/**
+ * @brief Record the esp_timer time of a phase. Only the first call per phase counts, so it is
+ *        safe to call from a loop. Callable from any task.
+ */
+void boot_prof_mark(BootPhase_t phase);
+
+/**
+ * @brief Microseconds since esp_timer start when the phase was reached, or -1 if it was not (yet).
+ */
+int64_t boot_prof_get_us(BootPhase_t phase);
+
+/**
+ * @brief Short snake_case name of a phase, e.g. "first_sample".
+ */
+const char *boot_prof_phase_name(BootPhase_t phase);
+
+/**
+ * @brief Whether every phase has been reached.
+ */
+bool boot_prof_complete(void);
+
+#ifdef __cplusplus
+}
+#endif
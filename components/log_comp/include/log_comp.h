@@ -0,0 +1,159 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_err.h"
+#include "esp_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_RL_WINDOW_US        1000000 // Rate-limit window per call site
+#define LOG_RL_BURST            3       // Messages let through per window and call site
+#define LOG_BIN_MAX_ARGS        6
+#define LOG_BIN_QUEUE_LENGTH    32      // Records buffered between the producers and the drain task
+#define LOG_BIN_LINE_MAX        64      // "$L" + base64 of the largest record + terminator
+
+typedef enum {
+    LOG_MODE_TEXT = 0,      // Hot-path records formatted on the device with ESP_LOG
+    LOG_MODE_BINARY,        // Hot-path records queued raw, formatting deferred to the host
+} LogMode_t;
+
+// Binary record ids. Argument layout (all 32-bit) is documented here and mirrored by the host decoder.
+typedef enum {
+    LOG_MSG_TEMP_SAMPLE = 1,        // index, raw code, mV (-1: uncalibrated), R (f32), T (f32)
+    LOG_MSG_ADC_READ_FAILED,        // index, adc channel, esp_err_t
+    LOG_MSG_ADC_OUT_OF_RANGE,       // index, raw code, mV (-1: uncalibrated)
+    LOG_MSG_MEASURE_FAILED,         // index, esp_err_t
+    LOG_MSG_SUPPRESSED,             // message id, suppressed count
+} LogMsgId_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  id;
+    uint8_t  argc;
+    uint16_t seq;
+    uint32_t timestamp_us;          // Low 32 bits of esp_timer_get_time()
+    uint32_t args[LOG_BIN_MAX_ARGS];
+} LogBinRecord_t;
+
+// Per-call-site state of the rate limiter. Each call site is expected to be hit from one task;
+// concurrent hits only make the counts approximate.
+typedef struct {
+    int64_t  window_start_us;
+    uint32_t in_window;
+    uint32_t suppressed;
+} LogRateLimit_t;
+
+typedef struct {
+    uint32_t binary_queued;
+    uint32_t binary_dropped;        // Queue full: records lost instead of stalling the caller
+    uint32_t rate_suppressed;       // Text messages swallowed by the rate limiter
+} LogStats_t;
+
+// Receives one complete "$L<base64>" line per binary record (e.g. serial_comp_send)
+typedef esp_err_t (*log_comp_sink_t)(const char *line);
+
+/**
+ * @brief Initialize the logging facility and start the binary drain task.
+ */
+esp_err_t log_comp_init(void);
+
+/**
+ * @brief Register the output used for binary records (none: records are dropped).
+ */
+void log_comp_register_sink(log_comp_sink_t sink);
+
+esp_err_t log_comp_set_mode(LogMode_t mode);
+LogMode_t log_comp_get_mode(void);
+void log_comp_get_stats(LogStats_t *stats);
+
+/**
+ * @brief Rate-limiter check for one call site.
+ *
+ * @param rl         Call-site state (static, see LOG_RL_LEVEL).
+ * @param suppressed Output: messages swallowed since the last one let through (0 if none).
+ * @return true if the message may be emitted.
+ */
+bool log_comp_rate_allow(LogRateLimit_t *rl, uint32_t *suppressed);
+
+/**
+ * @brief Queue a binary record without blocking. Counted as dropped if the queue is full.
+ */
+void log_comp_binary(LogMsgId_t id, int argc, const uint32_t *args);
+
+/**
+ * @brief Rate-limited binary record; emits a LOG_MSG_SUPPRESSED record with the backlog first.
+ */
+void log_comp_binary_rl(LogRateLimit_t *rl, LogMsgId_t id, int argc, const uint32_t *args);
+
+/**
+ * @brief Standard base64 (with padding) of len bytes into out, which must hold 4 * ((len + 2) / 3) + 1 bytes.
+ * @return Number of characters written, excluding the terminator.
+ */
+size_t log_comp_base64_encode(const uint8_t *data, size_t len, char *out);
+
+static inline bool log_comp_binary_active(void) {
+    return log_comp_get_mode() == LOG_MODE_BINARY;
+}
+
+static inline uint32_t log_comp_f32(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// ESP_LOG with per-call-site rate limiting: at most LOG_RL_BURST messages per LOG_RL_WINDOW_US,
+// followed by a summary of what was suppressed once the call site gets through again.
+#define LOG_RL_LEVEL(level, tag, format, ...) do {                                                  \
+        static LogRateLimit_t _log_rl;                                                              \
+        uint32_t _log_suppressed;                                                                   \
+        if (log_comp_rate_allow(&_log_rl, &_log_suppressed)) {                                      \
+            if (_log_suppressed > 0) {                                                              \
+                ESP_LOG_LEVEL(level, tag, "(%" PRIu32 " similar messages suppressed)", _log_suppressed); \
+            }                                                                                       \
+            ESP_LOG_LEVEL(level, tag, format, ##__VA_ARGS__);                                       \
+        }                                                                                           \
+    } while (0)
+
+#define LOGE_RL(tag, format, ...) LOG_RL_LEVEL(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define LOGW_RL(tag, format, ...) LOG_RL_LEVEL(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+
+// Queue a binary record: LOG_BIN(LOG_MSG_ADC_READ_FAILED, index, channel, err)
+#define LOG_BIN(id, ...) do {                                                                       \
+        const uint32_t _log_args[] = { __VA_ARGS__ };                                               \
+        log_comp_binary(id, sizeof(_log_args) / sizeof(_log_args[0]), _log_args);                  \
+    } while (0)
+
+#define LOG_UNPACK(...) __VA_ARGS__
+
+// Rate-limited fault report sharing one limiter per call site: a binary record in binary mode,
+// ESP_LOG otherwise. bin_args is a parenthesized list of 32-bit values:
+// LOG_FAULT_RL(ESP_LOG_ERROR, TAG, LOG_MSG_MEASURE_FAILED, (index, ret), "Failed on %d: %s", index, esp_err_to_name(ret));
+#define LOG_FAULT_RL(level, tag, id, bin_args, format, ...) do {                                    \
+        static LogRateLimit_t _log_rl;                                                              \
+        if (log_comp_binary_active()) {                                                             \
+            const uint32_t _log_args[] = { LOG_UNPACK bin_args };                                   \
+            log_comp_binary_rl(&_log_rl, id, sizeof(_log_args) / sizeof(_log_args[0]), _log_args);  \
+        } else {                                                                                    \
+            uint32_t _log_suppressed;                                                               \
+            if (log_comp_rate_allow(&_log_rl, &_log_suppressed)) {                                  \
+                if (_log_suppressed > 0) {                                                          \
+                    ESP_LOG_LEVEL(level, tag, "(%" PRIu32 " similar messages suppressed)", _log_suppressed); \
+                }                                                                                   \
+                ESP_LOG_LEVEL(level, tag, format, ##__VA_ARGS__);                                   \
+            }                                                                                       \
+        }                                                                                           \
+    } while (0)
+
+/**
+ * @brief RAM reserved at build time by the component (binary record queue and drain task), for the boot memory report.
+ */
+size_t log_comp_get_static_ram_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
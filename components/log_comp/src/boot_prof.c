@@ -0,0 +1,43 @@
+#include "boot_prof.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <inttypes.h>
+
+static const char *TAG = "boot_prof";
+
+static const char *const s_phase_names[BOOT_PHASE_COUNT] = {
+    "app_main", "log", "config", "temp", "acquisition", "first_sample", "serial_init", "serial_ready",
+};
+
+// 32-bit so readers on another core never see a torn value; 0 means not reached (boot phases are
+// far below the ~71 minutes a microsecond counter of this width covers)
+static volatile uint32_t s_phase_us[BOOT_PHASE_COUNT];
+
+void boot_prof_mark(BootPhase_t phase) {
+    if (phase < 0 || phase >= BOOT_PHASE_COUNT || s_phase_us[phase] != 0) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    s_phase_us[phase] = now > 0 && now < UINT32_MAX ? (uint32_t)now : 1;
+    ESP_LOGI(TAG, "Boot phase %s at %" PRIu32 " us", s_phase_names[phase], s_phase_us[phase]);
+}
+
+int64_t boot_prof_get_us(BootPhase_t phase) {
+    if (phase < 0 || phase >= BOOT_PHASE_COUNT || s_phase_us[phase] == 0) {
+        return -1;
+    }
+    return s_phase_us[phase];
+}
+
+const char *boot_prof_phase_name(BootPhase_t phase) {
+    return phase >= 0 && phase < BOOT_PHASE_COUNT ? s_phase_names[phase] : "unknown";
+}
+
+bool boot_prof_complete(void) {
+    for (int p = 0; p < BOOT_PHASE_COUNT; ++p) {
+        if (s_phase_us[p] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
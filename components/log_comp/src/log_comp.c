@@ -0,0 +1,161 @@
+#include "log_comp.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+
+#define LOG_DRAIN_TASK_STACK    3072
+#define LOG_DRAIN_TASK_PRIO     2   // Below the measurement (5) and serial (4) tasks
+
+static const char *TAG = "log_comp";
+
+static QueueHandle_t s_bin_queue = NULL;
+static StaticQueue_t s_bin_queue_struct;
+static uint8_t s_bin_queue_storage[LOG_BIN_QUEUE_LENGTH * sizeof(LogBinRecord_t)];
+static StaticTask_t s_drain_task_tcb;
+static StackType_t s_drain_task_stack[LOG_DRAIN_TASK_STACK];
+static volatile LogMode_t s_mode = LOG_MODE_TEXT;
+static log_comp_sink_t s_sink = NULL;
+// Producers run on both cores, so the sequence number and the counters are only updated atomically
+static uint16_t s_seq = 0;
+static LogStats_t s_stats;
+
+static const char s_base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t log_comp_base64_encode(const uint8_t *data, size_t len, char *out) {
+    size_t o = 0;
+    size_t i = 0;
+    for (; i + 2 < len; i += 3) {
+        uint32_t v = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+        out[o++] = s_base64_alphabet[(v >> 18) & 0x3F];
+        out[o++] = s_base64_alphabet[(v >> 12) & 0x3F];
+        out[o++] = s_base64_alphabet[(v >> 6) & 0x3F];
+        out[o++] = s_base64_alphabet[v & 0x3F];
+    }
+    if (i < len) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) {
+            v |= (uint32_t)data[i + 1] << 8;
+        }
+        out[o++] = s_base64_alphabet[(v >> 18) & 0x3F];
+        out[o++] = s_base64_alphabet[(v >> 12) & 0x3F];
+        out[o++] = i + 1 < len ? s_base64_alphabet[(v >> 6) & 0x3F] : '=';
+        out[o++] = '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+// Formats and writes the queued records at low priority, so producers only pay for a queue copy
+static void _log_drain_task(void *arg) {
+    LogBinRecord_t record;
+    char line[LOG_BIN_LINE_MAX];
+    while (1) {
+        if (xQueueReceive(s_bin_queue, &record, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        log_comp_sink_t sink = s_sink;
+        if (sink == NULL) {
+            continue;
+        }
+        line[0] = '$';
+        line[1] = 'L';
+        size_t record_len = offsetof(LogBinRecord_t, args) + record.argc * sizeof(uint32_t);
+        log_comp_base64_encode((const uint8_t *)&record, record_len, line + 2);
+        sink(line);
+    }
+}
+
+esp_err_t log_comp_init(void) {
+    s_bin_queue = xQueueCreateStatic(LOG_BIN_QUEUE_LENGTH, sizeof(LogBinRecord_t), s_bin_queue_storage, &s_bin_queue_struct);
+    if (s_bin_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create binary log queue");
+        return ESP_FAIL;
+    }
+    if (xTaskCreateStatic(_log_drain_task, "log_drain_task", LOG_DRAIN_TASK_STACK, NULL, LOG_DRAIN_TASK_PRIO,
+                          s_drain_task_stack, &s_drain_task_tcb) == NULL) {
+        ESP_LOGE(TAG, "Failed to create log drain task");
+        vQueueDelete(s_bin_queue);
+        s_bin_queue = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+size_t log_comp_get_static_ram_bytes(void) {
+    return sizeof(s_bin_queue_struct) + sizeof(s_bin_queue_storage) + sizeof(s_drain_task_tcb) + sizeof(s_drain_task_stack);
+}
+
+void log_comp_register_sink(log_comp_sink_t sink) {
+    s_sink = sink;
+}
+
+esp_err_t log_comp_set_mode(LogMode_t mode) {
+    if (mode != LOG_MODE_TEXT && mode != LOG_MODE_BINARY) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mode == LOG_MODE_BINARY && s_bin_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_mode = mode;
+    ESP_LOGI(TAG, "Log mode set to %s", mode == LOG_MODE_BINARY ? "binary" : "text");
+    return ESP_OK;
+}
+
+LogMode_t log_comp_get_mode(void) {
+    return s_mode;
+}
+
+void log_comp_get_stats(LogStats_t *stats) {
+    if (stats != NULL) {
+        *stats = s_stats;
+    }
+}
+
+bool log_comp_rate_allow(LogRateLimit_t *rl, uint32_t *suppressed) {
+    int64_t now = esp_timer_get_time();
+    *suppressed = 0;
+    if (now - rl->window_start_us >= LOG_RL_WINDOW_US) {
+        rl->window_start_us = now;
+        rl->in_window = 0;
+    }
+    if (rl->in_window >= LOG_RL_BURST) {
+        rl->suppressed++;
+        __atomic_fetch_add(&s_stats.rate_suppressed, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    rl->in_window++;
+    *suppressed = rl->suppressed;
+    rl->suppressed = 0;
+    return true;
+}
+
+void log_comp_binary(LogMsgId_t id, int argc, const uint32_t *args) {
+    if (s_bin_queue == NULL) {
+        return;
+    }
+    LogBinRecord_t record = {
+        .id = (uint8_t)id,
+        .argc = (uint8_t)(argc > LOG_BIN_MAX_ARGS ? LOG_BIN_MAX_ARGS : argc),
+        .seq = __atomic_fetch_add(&s_seq, 1, __ATOMIC_RELAXED),
+        .timestamp_us = (uint32_t)esp_timer_get_time(),
+    };
+    memcpy(record.args, args, record.argc * sizeof(uint32_t));
+    if (xQueueSend(s_bin_queue, &record, 0) == pdTRUE) {
+        __atomic_fetch_add(&s_stats.binary_queued, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_add(&s_stats.binary_dropped, 1, __ATOMIC_RELAXED); // Never block the caller: the gap shows up in the sequence numbers
+    }
+}
+
+void log_comp_binary_rl(LogRateLimit_t *rl, LogMsgId_t id, int argc, const uint32_t *args) {
+    uint32_t suppressed;
+    if (!log_comp_rate_allow(rl, &suppressed)) {
+        return;
+    }
+    if (suppressed > 0) {
+        const uint32_t summary[] = { (uint32_t)id, suppressed };
+        log_comp_binary(LOG_MSG_SUPPRESSED, 2, summary);
+    }
+    log_comp_binary(id, argc, args);
+}
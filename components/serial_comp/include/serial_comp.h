@@ -4,7 +4,11 @@
 #include "driver/usb_serial_jtag.h" // Needed for the full USB JTAG driver
 //#include "driver/usb_serial_jtag_vfs.h"
 
-#define SERIAL_BUFFER_SIZE 2048
+#include "config_comp.h"
+
+// Reply/stream frames grow with the channel count (the widest, the stats record, needs ~50 bytes per channel)
+#define SERIAL_FRAME_BYTES_PER_CHANNEL 64
+#define SERIAL_BUFFER_SIZE (1664 + SERIAL_FRAME_BYTES_PER_CHANNEL * MAX_THERMISTOR_COUNT) // 2048 for 6 thermistors
 #define SERIAL_STACK_SIZE 4096
 
 #ifdef __cplusplus
@@ -72,6 +76,12 @@ void serial_comp_task(void *arg);
 void serial_rx_task(void *arg); // Declare if created by main, or keep static if created by serial_comp_init
 
 
+/**
+ * @brief RAM reserved at build time by the component (command pool, reply buffer, queues, RX task, stream state),
+ *        for the boot memory report. The serial_comp_task stack is created by the caller.
+ */
+size_t serial_comp_get_static_ram_bytes(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
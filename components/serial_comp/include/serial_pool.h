@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fixed pool of equally sized buffers handed around by pointer.
+ *
+ * The blocks live in static storage (SERIAL_POOL_STORAGE) and the free list is a statically
+ * allocated FreeRTOS queue of block pointers, so get/put are O(1), safe across tasks and never
+ * touch the heap. A block is owned by whoever got it until it is put back.
+ */
+typedef struct {
+    QueueHandle_t free_list;
+    StaticQueue_t free_list_queue;
+    size_t        block_size;
+    int           block_count;
+    int           min_free;         // Low-water mark of free blocks since init
+    uint32_t      exhausted;        // Gets that timed out with no free block
+} SerialPool_t;
+
+// Static storage of a pool: block_count blocks of block_size bytes plus the free-list queue storage
+#define SERIAL_POOL_STORAGE(name, block_size, block_count)                  \
+    static char name##_blocks[(block_count)][(block_size)];                 \
+    static uint8_t name##_free_list[(block_count) * sizeof(void *)]
+
+#define SERIAL_POOL_STORAGE_BYTES(block_size, block_count) ((block_count) * ((block_size) + sizeof(void *)))
+
+/**
+ * @brief Create the free list and put every block on it.
+ *
+ * @param blocks            block_count * block_size bytes, e.g. name##_blocks.
+ * @param free_list_storage block_count * sizeof(void *) bytes, e.g. name##_free_list.
+ */
+esp_err_t serial_pool_init(SerialPool_t *pool, void *blocks, size_t block_size, int block_count, uint8_t *free_list_storage);
+
+/**
+ * @brief Take a block, waiting up to timeout for one to be returned.
+ * @return The block, or NULL if none became free in time.
+ */
+void *serial_pool_get(SerialPool_t *pool, TickType_t timeout);
+
+/**
+ * @brief Return a block obtained with serial_pool_get (NULL is ignored).
+ */
+void serial_pool_put(SerialPool_t *pool, void *block);
+
+int serial_pool_free_count(const SerialPool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "temp_comp.h"
+
+#define MAX_STREAM_SUBS         4
+#define STREAM_SUB_NAME_LEN     12      // Including the terminator
+#define STREAM_SUB_MAX_DIVISOR  3600
+#define STREAM_SUB_BIN_NAN      INT16_MIN   // Centi-degree code of a missing value in "$T" frames
+#define STREAM_SUB_CAL_CHUNK    512         // Calibration table entries per "$C" frame
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    STREAM_SUB_JSON = 0,    // {"sub":"<name>","names":[...],"temperatures":[...]}
+    STREAM_SUB_BIN,         // "$T" + base64 of StreamSubBinHeader_t, 1-based indices, int16 centi-degrees
+    STREAM_SUB_STATS,       // {"sub":"<name>","stats":{...}} aggregated over the divisor's cycles
+    STREAM_SUB_RAW,         // "$R": StreamSubRawHeader_t, indices, packed 12-bit ADC codes, after a descriptor (see serial_subs_feed)
+    STREAM_SUB_FORMAT_COUNT
+} StreamSubFormat_t;
+
+/**
+ * @brief Named stream subscription: its own channel subset, rate divisor, format and enable state.
+ *
+ * Frames are emitted every `divisor` measurement cycles. All subscriptions are fed from the snapshot
+ * the measurement task posts at the end of every cycle, and each value is converted once per cycle
+ * however many subscriptions use it.
+ */
+typedef struct {
+    char              name[STREAM_SUB_NAME_LEN];  // Empty: free slot
+    StreamSubFormat_t format;
+    int               divisor;                    // Measurement cycles per frame, >= 1
+    bool              enabled;
+    bool              channels[MAX_THERMISTOR_COUNT];
+    bool              primed;                     // last_cycle set: false until the first cycle after add/enable
+    uint32_t          last_cycle;                 // Cycle of the last frame (or of the priming cycle)
+    uint16_t          seq;                        // Frames sent, wraps (binary frames carry it for gap detection)
+    uint32_t          aggregated;                 // Stats format: snapshots in the current window
+    bool              described;                  // Raw format: descriptor sent since the last add/enable
+    uint32_t          described_generation;       // Raw format: conversion generation of that descriptor
+} StreamSub_t;
+
+// Header of a binary frame, followed by count uint8 indices (padded to even length) and count int16 values
+typedef struct __attribute__((packed)) {
+    uint8_t  sub_id;        // 1-based subscription slot
+    uint8_t  count;
+    uint16_t seq;
+    uint32_t cycle;
+} StreamSubBinHeader_t;
+
+// Header of a "$R" frame, followed like "$T" by the indices and the count codes packed to 12 bits. The codes
+// convert with the descriptor of this generation, whichever descriptor the host received last.
+typedef struct __attribute__((packed)) {
+    StreamSubBinHeader_t bin;
+    uint32_t             generation;    // TemperatureOutputData_t.conversion_generation of the cycle
+} StreamSubRawHeader_t;
+
+// Header of a "$C" frame, followed by count packed 12-bit mV entries of the unit's calibration table from offset
+typedef struct __attribute__((packed)) {
+    uint8_t  unit;          // 1-based ADC unit
+    uint8_t  reserved;
+    uint16_t offset;
+    uint16_t count;
+} StreamSubCalHeader_t;
+
+/**
+ * @brief Add an enabled subscription. Its first frame follows `divisor` cycles after the next snapshot.
+ *
+ * @param channels MAX_THERMISTOR_COUNT flags, NULL for all channels.
+ * @return ESP_ERR_INVALID_ARG on a bad name/format/divisor, ESP_ERR_INVALID_STATE if the name exists,
+ *         ESP_ERR_NO_MEM if all MAX_STREAM_SUBS slots are used.
+ */
+esp_err_t serial_subs_add(const char *name, StreamSubFormat_t format, int divisor, const bool *channels);
+
+esp_err_t serial_subs_remove(const char *name);
+
+esp_err_t serial_subs_set_enabled(const char *name, bool enabled);
+
+/**
+ * @brief Whether any subscription is enabled (the measurement task must keep posting cycle snapshots).
+ */
+bool serial_subs_any_enabled(void);
+
+/**
+ * @brief Feed one cycle's snapshot to every subscription and send the frames that are due.
+ *
+ * Call it with every cycle, in order: a frame is due once `divisor` cycles passed since the previous
+ * one, so a snapshot lost on the way only shortens the stats aggregate. Does nothing unless
+ * snapshot->cycle advanced since the previous call. Before its first frame after
+ * add/enable, and whenever the conversion generation changed, a raw subscription sends its descriptor:
+ * {"sub":"<name>","raw_descriptor":{...}}, one {"sub":"<name>","raw_channel":{...}} per channel, then the
+ * "$C" calibration tables of the ADC units those channels use.
+ *
+ * @param buffer Scratch buffer for one frame at a time.
+ */
+void serial_subs_feed(const TemperatureOutputData_t *snapshot, char *buffer, size_t buffer_size);
+
+/**
+ * @brief {"subs":[{"id":1, "name":..., "format":..., "divisor":..., "enabled":..., "channels":[...]}, ...]}
+ */
+esp_err_t serial_subs_format_list_json(char *buffer, size_t buffer_size);
+
+/**
+ * @brief Parse "json", "bin", "stats" or "raw".
+ */
+esp_err_t serial_subs_format_from_str(const char *str, StreamSubFormat_t *format);
+
+size_t serial_subs_get_static_ram_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
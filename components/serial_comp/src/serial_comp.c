@@ -1,31 +1,221 @@
 #include "serial_comp.h"
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stddef.h>
+#include <inttypes.h>
 #include "esp_log.h"
+#include "freertos/semphr.h"
 #include "config_comp.h"
 #include "temp_comp.h"
+#include "temp_power.h"
+#include "temp_json.h"
+#include "log_comp.h"
+#include "boot_prof.h"
+#include "serial_pool.h"
+#include "serial_subs.h"
 // #include <ctype.h>
 
 #define RECEIVE_CHUNK_SIZE 64
 
 #define MAX_COMMAND_LEN 128     // Maximum length for a command from serial
 #define COMMAND_QUEUE_LENGTH 5  // How many commands can be buffered
+#define COMMAND_POOL_SIZE (COMMAND_QUEUE_LENGTH + 2) // Queued + the one being received + the one being processed
+#define EVENT_QUEUE_LENGTH 8    // Alarm/rate events between the measurement task and serial_comp_task
+#define SNAPSHOT_QUEUE_LENGTH 3 // Cycle snapshots between the measurement task and serial_comp_task
+
+// Commands are pool blocks passed by pointer: the queue carries 4-byte pointers and
+// every buffer, queue and task below is statically allocated.
+SERIAL_POOL_STORAGE(s_command_pool, MAX_COMMAND_LEN, COMMAND_POOL_SIZE);
+static SerialPool_t s_command_pool;
 static QueueHandle_t s_command_queue = NULL;
+static StaticQueue_t s_command_queue_struct;
+static uint8_t s_command_queue_storage[COMMAND_QUEUE_LENGTH * sizeof(char *)];
 static TaskHandle_t s_serial_rx_task_handle = NULL;
+static StaticTask_t s_serial_rx_task_tcb;
+static StackType_t s_serial_rx_task_stack[SERIAL_STACK_SIZE];
 
 static const char *TAG = "serial_comp";
 
+// Replies and frames are only formatted by serial_comp_task, one at a time
 static char s_serial_buffer[SERIAL_BUFFER_SIZE] = {0};
 
+// Serializes whole frames on the link: log records are sent from the log drain task
+static SemaphoreHandle_t s_tx_mutex = NULL;
+static StaticSemaphore_t s_tx_mutex_struct;
+
+// Alarm transitions and rate changes, posted by the measurement task without blocking and sent by
+// serial_comp_task ahead of commands and stream frames. A full queue drops the event and counts it.
+typedef enum {
+    SERIAL_EVENT_ALARM = 0,
+    SERIAL_EVENT_RATE,
+} SerialEventType_t;
+
+typedef struct {
+    SerialEventType_t type;
+    union {
+        TempAlarmEvent_t alarm;
+        TempRateEvent_t  rate;      // reason points to a string literal
+    };
+} SerialEvent_t;
+
+static QueueHandle_t s_event_queue = NULL;
+static StaticQueue_t s_event_queue_struct;
+static uint8_t s_event_queue_storage[EVENT_QUEUE_LENGTH * sizeof(SerialEvent_t)];
+static volatile uint32_t s_events_dropped = 0;  // Written by the measurement task only
+static uint32_t s_events_dropped_reported = 0;
+static TaskHandle_t s_serial_task_handle = NULL; // Notified on every command and event once serial_comp_task runs
+
+// One snapshot per completed measurement cycle, posted by the measurement task while the stream, a
+// subscription or the boot report needs it. Streaming follows the cycles, not a timer of this task,
+// so commands never delay or skip them; a full queue drops the snapshot and counts it.
+static QueueHandle_t s_snapshot_queue = NULL;
+static StaticQueue_t s_snapshot_queue_struct;
+static uint8_t s_snapshot_queue_storage[SNAPSHOT_QUEUE_LENGTH * sizeof(TemperatureOutputData_t)];
+static volatile uint32_t s_snapshots_dropped = 0; // Written by the measurement task only
+static uint32_t s_snapshots_dropped_reported = 0;
+static volatile bool s_snapshots_wanted = true;   // Written by serial_comp_task only
+
+// Stream state (only touched by serial_comp_task)
+static TemperatureOutputData_t s_stream_snapshot;
+static float s_last_reported_temps[MAX_THERMISTOR_COUNT];
+static bool s_last_report_valid = false;
+static TickType_t s_last_heartbeat_tick = 0;
+// Frames go through the precompiled template like "get temps"; it is rebuilt only when the snapshot names change
+static JsonFrameTemplate_t s_stream_template;
+static char s_stream_template_names[MAX_THERMISTOR_COUNT][TEMP_JSON_NAME_SIZE];
+static bool s_stream_template_valid = false;
+static JsonFrameTemplate_t s_partial_template;  // Channels of the current report-on-change frame
+
+// Statistics stream state (only touched by serial_comp_task)
+static TemperatureStatsData_t s_stats_snapshot;
+static uint32_t s_last_streamed_stats_seq = 0;
+
+static bool s_boot_reported = false; // Boot profile sent once unsolicited, when every phase was reached
+
+// Burst dump: "$B" + base64 of the header and BURST_CHUNK_SAMPLES codes packed to 12 bits
+#define BURST_CHUNK_SAMPLES 512
+#define BURST_DUMP_CHUNKS_PER_PASS 4    // Per pass of the command loop, so a 256k-sample dump does not hold off commands and cycles
+typedef struct __attribute__((packed)) {
+    uint16_t capture_id;
+    uint16_t count;
+    uint32_t offset;        // Of the first sample in the capture
+} BurstChunkHeader_t;
+static uint16_t s_burst_chunk_codes[BURST_CHUNK_SAMPLES];
+static struct {
+    bool     active;
+    uint16_t capture_id;
+    uint32_t samples;
+    uint32_t offset;        // Next sample to send
+} s_burst_dump;             // Only touched by serial_comp_task
+static uint8_t s_burst_chunk_frame[sizeof(BurstChunkHeader_t) + (3 * BURST_CHUNK_SAMPLES + 1) / 2];
+
+#define NOISE_POLL_MS 20                // Result poll period while a noise diagnostic captures
+static int s_noise_diag_index = 0;      // 1-based thermistor of the pending noise diagnostic, 0 if none
+
+static void _wake_serial_task(void) {
+    TaskHandle_t task = s_serial_task_handle;
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+// Runs in the measurement task: only a queue copy, so a host that does not drain USB never stalls acquisition
+static void _post_event(const SerialEvent_t *event) {
+    if (xQueueSend(s_event_queue, event, 0) != pdTRUE) {
+        s_events_dropped++;
+        return;
+    }
+    _wake_serial_task();
+}
+
+static void _post_alarm_event(const TempAlarmEvent_t *alarm) {
+    SerialEvent_t event = {.type = SERIAL_EVENT_ALARM, .alarm = *alarm};
+    _post_event(&event);
+}
+
+// Reports every change of the effective sampling interval (adaptive mode or configuration)
+static void _post_rate_event(const TempRateEvent_t *rate) {
+    SerialEvent_t event = {.type = SERIAL_EVENT_RATE, .rate = *rate};
+    _post_event(&event);
+}
+
+// Runs in the measurement task once per cycle; nothing is queued while no one streams, so low power sleeps on
+static void _post_cycle_snapshot(const TemperatureOutputData_t *snapshot) {
+    if (!s_snapshots_wanted) {
+        return;
+    }
+    if (xQueueSend(s_snapshot_queue, snapshot, 0) != pdTRUE) {
+        s_snapshots_dropped++;
+        return;
+    }
+    _wake_serial_task();
+}
+
+static void _format_event_json(char *buffer, size_t buffer_size, const SerialEvent_t *event) {
+    if (event->type == SERIAL_EVENT_RATE) {
+        snprintf(buffer, buffer_size, "{\"rate\":{\"interval_ms\":%d, \"previous_ms\":%d, \"reason\":\"%s\"}}",
+                 event->rate.interval_ms, event->rate.previous_interval_ms, event->rate.reason);
+        return;
+    }
+    const TempAlarmEvent_t *alarm = &event->alarm;
+    ThermistorConfig_t therm_config;
+    const char *name = config_comp_get_thermistor_config(alarm->index, &therm_config) == ESP_OK ? therm_config.name : "";
+    snprintf(buffer, buffer_size,
+             "{\"alarm\":{\"index\":%d, \"name\":\"%s\", \"type\":\"%s\", \"raised\":%s, \"value\":%.2f}}",
+             alarm->index + 1, name, temp_alarm_type_to_str(alarm->type), alarm->raised ? "true" : "false", alarm->value);
+}
+
+// Sends every queued alarm/rate frame; called by serial_comp_task before it looks at anything else
+static void _send_pending_events(void) {
+    SerialEvent_t event;
+    while (xQueueReceive(s_event_queue, &event, 0) == pdTRUE) {
+        _format_event_json(s_serial_buffer, SERIAL_BUFFER_SIZE, &event);
+        esp_err_t ret = serial_comp_send(s_serial_buffer);
+        if (ret != ESP_OK) {
+            LOGE_RL(TAG, "Failed to send %s frame over serial: %s", event.type == SERIAL_EVENT_ALARM ? "alarm" : "rate", esp_err_to_name(ret));
+        }
+    }
+    uint32_t dropped = s_events_dropped;
+    if (dropped != s_events_dropped_reported) {
+        LOGW_RL(TAG, "%" PRIu32 " alarm/rate frames dropped, event queue full", dropped - s_events_dropped_reported);
+        s_events_dropped_reported = dropped;
+    }
+}
+
 esp_err_t serial_comp_init(void) {
     ESP_LOGI(TAG, "Initializing USB Serial/JTAG for standard blocking I/O...");
 
-    s_command_queue = xQueueCreate(COMMAND_QUEUE_LENGTH, MAX_COMMAND_LEN);
+    s_tx_mutex = xSemaphoreCreateMutexStatic(&s_tx_mutex_struct);
+    if (s_tx_mutex == NULL) {
+        ESP_LOGE(TAG, "Failed to create TX mutex");
+        return ESP_FAIL;
+    }
+
+    if (serial_pool_init(&s_command_pool, s_command_pool_blocks, MAX_COMMAND_LEN, COMMAND_POOL_SIZE, s_command_pool_free_list) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create command buffer pool");
+        return ESP_FAIL;
+    }
+
+    s_command_queue = xQueueCreateStatic(COMMAND_QUEUE_LENGTH, sizeof(char *), s_command_queue_storage, &s_command_queue_struct);
     if (s_command_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create command queue");
         return ESP_FAIL;
     }
 
+    s_event_queue = xQueueCreateStatic(EVENT_QUEUE_LENGTH, sizeof(SerialEvent_t), s_event_queue_storage, &s_event_queue_struct);
+    if (s_event_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create event queue");
+        return ESP_FAIL;
+    }
+
+    s_snapshot_queue = xQueueCreateStatic(SNAPSHOT_QUEUE_LENGTH, sizeof(TemperatureOutputData_t), s_snapshot_queue_storage, &s_snapshot_queue_struct);
+    if (s_snapshot_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create snapshot queue");
+        return ESP_FAIL;
+    }
+
     // Configuration for the USB Serial/JTAG driver
     // Default buffer sizes are usually sufficient.
     usb_serial_jtag_driver_config_t usb_serial_jtag_config = {
@@ -40,25 +230,33 @@ esp_err_t serial_comp_init(void) {
         return err;
     }
 
-    // usb_serial_jtag_vfs_set_rx_line_endings(ESP_LINE_ENDINGS_CRLF);
-    // usb_serial_jtag_vfs_set_tx_line_endings(ESP_LINE_ENDINGS_CRLF);
-
-    // // 2. Tell VFS to use the driver for stdin/stdout/stderr
-    // // This enables standard blocking behavior for reads.
-    // usb_serial_jtag_vfs_use_driver();
-
-
     ESP_LOGI(TAG, "USB Serial/JTAG driver installed.");
     // Create the serial receiver task
-    BaseType_t ret = xTaskCreate(serial_rx_task, "serial_rx_task", SERIAL_STACK_SIZE, NULL, 5, &s_serial_rx_task_handle);
-    if (ret != pdPASS) {
+    s_serial_rx_task_handle = xTaskCreateStatic(serial_rx_task, "serial_rx_task", SERIAL_STACK_SIZE, NULL, 5,
+                                                s_serial_rx_task_stack, &s_serial_rx_task_tcb);
+    if (s_serial_rx_task_handle == NULL) {
         ESP_LOGE(TAG, "Failed to create serial_rx_task");
-        vQueueDelete(s_command_queue);
         return ESP_FAIL;
     }
+
+    temp_comp_register_alarm_callback(_post_alarm_event);
+    temp_comp_register_rate_callback(_post_rate_event);
+    temp_comp_register_cycle_callback(_post_cycle_snapshot);
+    log_comp_register_sink(serial_comp_send);
     return ESP_OK;
 }
 
+size_t serial_comp_get_static_ram_bytes(void) {
+    return SERIAL_POOL_STORAGE_BYTES(MAX_COMMAND_LEN, COMMAND_POOL_SIZE) + sizeof(s_serial_buffer) +
+           sizeof(s_command_pool) + sizeof(s_command_queue_struct) + sizeof(s_command_queue_storage) +
+           sizeof(s_event_queue_struct) + sizeof(s_event_queue_storage) +
+           sizeof(s_snapshot_queue_struct) + sizeof(s_snapshot_queue_storage) +
+           sizeof(s_serial_rx_task_tcb) + sizeof(s_serial_rx_task_stack) + sizeof(s_tx_mutex_struct) +
+           sizeof(s_stream_snapshot) + sizeof(s_last_reported_temps) + sizeof(s_stream_template) + sizeof(s_stream_template_names) +
+           sizeof(s_partial_template) + sizeof(s_stats_snapshot) +
+           serial_subs_get_static_ram_bytes();
+}
+
 esp_err_t serial_comp_send(const char* str) {
     int len = strlen(str);
 
@@ -67,17 +265,14 @@ esp_err_t serial_comp_send(const char* str) {
         return ESP_ERR_INVALID_ARG;
     }
 
+    xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
     for (int i = 0; i < len; i++) {
         usb_serial_jtag_write_bytes((uint8_t *)&str[i], 1, 20 / portTICK_PERIOD_MS);
     }
     char newline = '\n';
     usb_serial_jtag_write_bytes((uint8_t *)&newline, 1, 20 / portTICK_PERIOD_MS);
+    xSemaphoreGive(s_tx_mutex);
 
-    // VFS implementation below:
-    //printf("%s\n", str);
-    // You might want to explicitly flush stdout if you're not sending newlines regularly
-    // or if you experience buffering issues. Good practice for prompt sending.
-    //fflush(stdout);
     ESP_LOGD(TAG, "Sent: %s", str);
     return ESP_OK;
 }
@@ -94,9 +289,13 @@ int serial_comp_receive(char *buffer, int max_len) {
     buffer[0] = '\0';
 
     while (1) {
+        // In low-power mode, block until data arrives instead of waking every 20 ms,
+        // so the RX task does not keep the chip out of light sleep.
+        TickType_t read_timeout = config_comp_get_low_power_mode() ? portMAX_DELAY : 20 / portTICK_PERIOD_MS;
+
         // Read a chunk of bytes into the 'chunk_buffer'.
         // The second argument to usb_serial_jtag_read_bytes is the size of the buffer
-        int bytes_read = usb_serial_jtag_read_bytes(chunk_buffer, RECEIVE_CHUNK_SIZE, 20 / portTICK_PERIOD_MS);
+        int bytes_read = usb_serial_jtag_read_bytes(chunk_buffer, RECEIVE_CHUNK_SIZE, read_timeout);
 
         if (bytes_read > 0) {
             for (int i = 0; i < bytes_read; i++) {
@@ -151,25 +350,438 @@ static void _get_and_send_latest_temps_json(char *buffer, size_t buffer_size) {
     if (strlen(buffer) > 0) {
         ret = serial_comp_send(buffer);
         if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to send temperatures JSON over serial: %s", esp_err_to_name(ret));
+            LOGE_RL(TAG, "Failed to send temperatures JSON over serial: %s", esp_err_to_name(ret));
         }
     } else if (ret == ESP_OK) {
         // This case might occur if there are no active thermistors, resulting in an empty JSON object/array.
-        ESP_LOGI(TAG, "Temperature JSON is empty, nothing to send.");
+        LOG_RL_LEVEL(ESP_LOG_INFO, TAG, "Temperature JSON is empty, nothing to send.");
+    }
+}
+
+static void _format_therm_json(char *buffer, size_t buffer_size, int index, const ThermistorConfig_t *therm_config) {
+    snprintf(buffer, buffer_size, "{\"index\":%d, \"name\":\"%s\", \"divider_R\":%d, \"adc_channel\":%d, \"adc_unit\":%d, \"mux_address\":%d, \"cal_R\":%d}",
+             index, therm_config->name, therm_config->divider_resistor_value, therm_config->adc_channel,
+             therm_config->adc_unit + 1, therm_config->mux_address, therm_config->calibration_resistance_offset);
+}
+
+static void _format_model_json(char *buffer, size_t buffer_size, int index, const ThermistorModel_t *model) {
+    if (model->type == THERM_MODEL_BETA) {
+        snprintf(buffer, buffer_size, "{\"index\":%d, \"model\":{\"type\":\"beta\", \"beta\":%.2f, \"r25\":%.2f}}",
+                 index, model->beta, model->r25);
+    } else {
+        snprintf(buffer, buffer_size, "{\"index\":%d, \"model\":{\"type\":\"sh\", \"a\":%.7e, \"b\":%.7e, \"c\":%.7e}}",
+                 index, model->a, model->b, model->c);
+    }
+}
+
+static void _format_filter_json(char *buffer, size_t buffer_size, int index, const FilterConfig_t *filter) {
+    snprintf(buffer, buffer_size, "{\"index\":%d, \"filter\":{\"median\":%d, \"iir_alpha\":%.3f, \"kalman_q\":%g, \"kalman_r\":%g}}",
+             index, filter->median_window, filter->iir_alpha, filter->kalman_q, filter->kalman_r);
+}
+
+// Appends ,"<key>":[v0,v1,...] with one value per active channel of the stats snapshot
+static int _append_stats_field(char *buffer, size_t buffer_size, size_t len, const TemperatureStatsData_t *data,
+                               const char *key, size_t field_offset) {
+    int written = snprintf(buffer + len, buffer_size - len, ",\"%s\":[", key);
+    if (written < 0 || written >= buffer_size - len) return -1;
+    len += written;
+    bool first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (data->thermistor_names[i][0] == '\0') continue;
+        float value = *(const float *)((const char *)&data->stats[i] + field_offset);
+        written = snprintf(buffer + len, buffer_size - len, "%s%.2f", first ? "" : ",", value);
+        if (written < 0 || written >= buffer_size - len) return -1;
+        len += written;
+        first = false;
+    }
+    written = snprintf(buffer + len, buffer_size - len, "]");
+    if (written < 0 || written >= buffer_size - len) return -1;
+    return len + written;
+}
+
+static esp_err_t _format_stats_json(char *buffer, size_t buffer_size, const TemperatureStatsData_t *data) {
+    int written = snprintf(buffer, buffer_size, "{\"stats\":{\"window\":%"PRIu32", \"samples\":%d, \"names\":[",
+                           data->window_seq, data->window_samples);
+    if (written < 0 || written >= buffer_size) goto fail_buffer_too_small;
+    int len = written;
+
+    bool first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (data->thermistor_names[i][0] == '\0') continue;
+        written = snprintf(buffer + len, buffer_size - len, "%s\"%s\"", first ? "" : ",", data->thermistor_names[i]);
+        if (written < 0 || written >= buffer_size - len) goto fail_buffer_too_small;
+        len += written;
+        first = false;
+    }
+    written = snprintf(buffer + len, buffer_size - len, "],\"count\":[");
+    if (written < 0 || written >= buffer_size - len) goto fail_buffer_too_small;
+    len += written;
+    first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (data->thermistor_names[i][0] == '\0') continue;
+        written = snprintf(buffer + len, buffer_size - len, "%s%"PRIu32, first ? "" : ",", data->stats[i].count);
+        if (written < 0 || written >= buffer_size - len) goto fail_buffer_too_small;
+        len += written;
+        first = false;
+    }
+    written = snprintf(buffer + len, buffer_size - len, "]");
+    if (written < 0 || written >= buffer_size - len) goto fail_buffer_too_small;
+    len += written;
+
+    if ((len = _append_stats_field(buffer, buffer_size, len, data, "min", offsetof(ChannelStats_t, min))) < 0) goto fail_buffer_too_small;
+    if ((len = _append_stats_field(buffer, buffer_size, len, data, "max", offsetof(ChannelStats_t, max))) < 0) goto fail_buffer_too_small;
+    if ((len = _append_stats_field(buffer, buffer_size, len, data, "mean", offsetof(ChannelStats_t, mean))) < 0) goto fail_buffer_too_small;
+    if ((len = _append_stats_field(buffer, buffer_size, len, data, "stddev", offsetof(ChannelStats_t, stddev))) < 0) goto fail_buffer_too_small;
+
+    written = snprintf(buffer + len, buffer_size - len, "}}");
+    if (written < 0 || written >= buffer_size - len) goto fail_buffer_too_small;
+    return ESP_OK;
+
+    fail_buffer_too_small:
+        ESP_LOGE(TAG, "Buffer too small for stats JSON output");
+        buffer[0] = '\0';
+        return ESP_ERR_NO_MEM;
+}
+
+// Sends the last completed statistics window. With only_new, nothing is sent unless a window
+// completed since the previous call (used by the stats stream mode).
+static void _send_stats(char *buffer, size_t buffer_size, bool only_new) {
+    if (temp_comp_get_stats(&s_stats_snapshot) != ESP_OK) {
+        return;
+    }
+    if (only_new && s_stats_snapshot.window_seq == s_last_streamed_stats_seq) {
+        return;
+    }
+    s_last_streamed_stats_seq = s_stats_snapshot.window_seq;
+
+    if (s_stats_snapshot.window_seq == 0) {
+        snprintf(buffer, buffer_size, "{\"stats\":null}");
+    } else if (_format_stats_json(buffer, buffer_size, &s_stats_snapshot) != ESP_OK) {
+        return;
+    }
+    esp_err_t ret = serial_comp_send(buffer);
+    if (ret != ESP_OK) {
+        LOGE_RL(TAG, "Failed to send stats JSON over serial: %s", esp_err_to_name(ret));
+    }
+}
+
+static bool _exceeds_deadband(float last, float now, float abs_c, float rel) {
+    if (isnan(last) || isnan(now)) {
+        return isnan(last) != isnan(now); // Channel dropped out or came back
+    }
+    float delta = fabsf(now - last);
+    if (abs_c <= 0.0f && rel <= 0.0f) {
+        return delta > 0.0f; // No deadband configured: report any change
+    }
+    return (abs_c > 0.0f && delta >= abs_c) || (rel > 0.0f && delta >= rel * fabsf(last));
+}
+
+static void _send_stream_frame(char *buffer) {
+    esp_err_t ret = serial_comp_send(buffer);
+    if (ret != ESP_OK) {
+        LOGE_RL(TAG, "Failed to send temperatures JSON over serial: %s", esp_err_to_name(ret));
+    }
+}
+
+// Full snapshot of every active channel, same frame as "get temps"
+static void _stream_full(const TemperatureOutputData_t *snapshot, char *buffer, size_t buffer_size) {
+    if (!s_stream_template_valid || memcmp(s_stream_template_names, snapshot->thermistor_names, sizeof(s_stream_template_names)) != 0) {
+        memcpy(s_stream_template_names, snapshot->thermistor_names, sizeof(s_stream_template_names));
+        temp_json_build_template_names(snapshot->thermistor_names, NULL, &s_stream_template);
+        s_stream_template_valid = true;
+    }
+    if (temp_json_format_frame(&s_stream_template, snapshot->temperatures, snapshot->health, buffer, buffer_size) != ESP_OK) {
+        LOGE_RL(TAG, "Buffer too small for JSON output");
+        return;
+    }
+    _send_stream_frame(buffer);
+}
+
+// Report-on-change streaming: sends only the channels that moved beyond the deadband since their
+// last report. A full snapshot is sent as heartbeat every heartbeat_ms (and on the first call after
+// the stream is (re)enabled), so silence on the link always means "nothing moved".
+static void _stream_on_change(const TemperatureOutputData_t *snapshot, char *buffer, size_t buffer_size) {
+    bool mask[MAX_THERMISTOR_COUNT];
+    bool any = false;
+    TickType_t now = xTaskGetTickCount();
+    bool heartbeat_due = !s_last_report_valid ||
+                         (now - s_last_heartbeat_tick) >= pdMS_TO_TICKS(config_comp_get_heartbeat());
+
+    float abs_c, rel;
+    config_comp_get_deadband(&abs_c, &rel);
+
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        bool active = snapshot->thermistor_names[i][0] != '\0';
+        mask[i] = active && (heartbeat_due ||
+                             _exceeds_deadband(s_last_reported_temps[i], snapshot->temperatures[i], abs_c, rel));
+        if (mask[i]) {
+            s_last_reported_temps[i] = snapshot->temperatures[i];
+            any = true;
+        }
+    }
+
+    if (heartbeat_due) {
+        s_last_report_valid = true;
+        s_last_heartbeat_tick = now;
+        if (any) {
+            _stream_full(snapshot, buffer, buffer_size);
+        }
+        return;
+    }
+    if (!any) {
+        return;
+    }
+
+    // Partial frames carry an extra "partial":true member (and no health) so the host can merge them
+    static const char partial_member[] = ",\"partial\":true}";
+    temp_json_build_template_names(snapshot->thermistor_names, mask, &s_partial_template);
+    if (temp_json_format_frame(&s_partial_template, snapshot->temperatures, NULL, buffer, buffer_size - (sizeof(partial_member) - 2)) != ESP_OK) {
+        LOGE_RL(TAG, "Buffer too small for JSON output");
+        return;
+    }
+    memcpy(buffer + strlen(buffer) - 1, partial_member, sizeof(partial_member)); // Replaces the closing '}'
+    _send_stream_frame(buffer);
+}
+
+static void _format_stream_config_json(char *buffer, size_t buffer_size) {
+    float abs_c = 0.0f, rel = 0.0f;
+    config_comp_get_deadband(&abs_c, &rel);
+    StreamMode_t mode = config_comp_get_stream_mode();
+    snprintf(buffer, buffer_size, "{\"stream_mode\":\"%s\", \"deadband_abs_c\":%.3f, \"deadband_rel\":%.3f, \"heartbeat_ms\":%d, \"stats_window_samples\":%d}",
+             mode == STREAM_MODE_ON_CHANGE ? "change" : mode == STREAM_MODE_STATS ? "stats" : "full",
+             abs_c, rel, config_comp_get_heartbeat(), config_comp_get_stats_window());
+}
+
+// {"boot":{"<phase>_us":<us since esp_timer start or null>, ...}}
+static void _format_boot_json(char *buffer, size_t buffer_size) {
+    int len = snprintf(buffer, buffer_size, "{\"boot\":{");
+    for (int p = 0; p < BOOT_PHASE_COUNT && len < buffer_size; ++p) {
+        int64_t us = boot_prof_get_us((BootPhase_t)p);
+        len += us < 0 ? snprintf(buffer + len, buffer_size - len, "%s\"%s_us\":null", p ? ", " : "", boot_prof_phase_name((BootPhase_t)p))
+                      : snprintf(buffer + len, buffer_size - len, "%s\"%s_us\":%" PRId64, p ? ", " : "", boot_prof_phase_name((BootPhase_t)p), us);
+    }
+    if (len < buffer_size) {
+        snprintf(buffer + len, buffer_size - len, "}}");
+    }
+}
+
+// "all" or a comma-separated list of 1-based indices, e.g. "1,2,5"
+static void _format_burst_json(char *buffer, size_t buffer_size) {
+    static const char *const state_names[] = {"idle", "armed", "triggered", "done"};
+    static const char *const trigger_names[] = {"command", "rise", "fall"};
+    TempBurstStatus_t status;
+    temp_comp_burst_get_status(&status);
+    snprintf(buffer, buffer_size,
+             "{\"burst\":{\"state\":\"%s\", \"index\":%d, \"capture\":%u, \"capacity\":%" PRIu32 ", \"pre\":%" PRIu32 ", \"post\":%" PRIu32 ", "
+             "\"trigger\":\"%s\", \"level\":%.2f, \"manual\":%s, \"samples\":%" PRIu32 ", \"trigger_offset\":%" PRIu32 ", "
+             "\"gap_free_from\":%" PRIu32 ", \"period_ns\":%" PRIu32 "}}",
+             state_names[status.state], status.index + 1, (unsigned)status.capture_id, status.capacity, status.pre, status.post,
+             trigger_names[status.trigger], status.level_c, status.manual ? "true" : "false", status.samples,
+             status.trigger_offset, status.gap_free_from, status.period_ns);
+}
+
+// Status line of the frozen capture; its "$B" chunks follow from _send_burst_dump_slice()
+static esp_err_t _start_burst_dump(char *buffer, size_t buffer_size) {
+    TempBurstStatus_t status;
+    temp_comp_burst_get_status(&status);
+    if (status.state != BURST_DONE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    _format_burst_json(buffer, buffer_size);
+    esp_err_t ret = serial_comp_send(buffer);
+    s_burst_dump.active = ret == ESP_OK && status.samples > 0;
+    s_burst_dump.capture_id = status.capture_id;
+    s_burst_dump.samples = status.samples;
+    s_burst_dump.offset = 0;
+    return ret;
+}
+
+// Up to BURST_DUMP_CHUNKS_PER_PASS chunks of the dump in progress. The host places them by capture id
+// and offset, so alarm, stream and command frames may come in between.
+static void _send_burst_dump_slice(void) {
+    if (!s_burst_dump.active) {
+        return;
+    }
+    char *frame = s_serial_buffer;
+    TempBurstStatus_t status;
+    temp_comp_burst_get_status(&status);
+    if (status.state != BURST_DONE || status.capture_id != s_burst_dump.capture_id) {
+        s_burst_dump.active = false; // Re-armed or stopped meanwhile
+        LOGW_RL(TAG, "Burst capture %u changed during its dump, stopped at sample %" PRIu32,
+                (unsigned)s_burst_dump.capture_id, s_burst_dump.offset);
+        snprintf(frame, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ESP_ERR_INVALID_STATE));
+        serial_comp_send(frame);
+    }
+    for (int n = 0; n < BURST_DUMP_CHUNKS_PER_PASS && s_burst_dump.active; ++n) {
+        uint32_t count = temp_comp_burst_read(s_burst_dump.offset, s_burst_chunk_codes, BURST_CHUNK_SAMPLES);
+        if (count == 0) {
+            s_burst_dump.active = false;
+            break;
+        }
+        BurstChunkHeader_t header = {.capture_id = s_burst_dump.capture_id, .count = (uint16_t)count, .offset = s_burst_dump.offset};
+        memcpy(s_burst_chunk_frame, &header, sizeof(header));
+        size_t frame_len = sizeof(header) + temp_burst_pack12(s_burst_chunk_codes, count, s_burst_chunk_frame + sizeof(header));
+        frame[0] = '$';
+        frame[1] = 'B';
+        log_comp_base64_encode(s_burst_chunk_frame, frame_len, frame + 2);
+        esp_err_t ret = serial_comp_send(frame);
+        if (ret != ESP_OK) {
+            LOGE_RL(TAG, "Failed to send burst chunk over serial: %s", esp_err_to_name(ret));
+        }
+        s_burst_dump.offset += count;
+        s_burst_dump.active = s_burst_dump.offset < s_burst_dump.samples;
+    }
+}
+
+static void _format_noise_json(char *buffer, size_t buffer_size, int index, const NoiseAnalysis_t *noise) {
+    int len = snprintf(buffer, buffer_size,
+                       "{\"noise\":{\"index\":%d, \"samples\":%d, \"rate_hz\":%.1f, \"mean_code\":%.2f, \"rms_lsb\":%.3f, \"p2p_lsb\":%d, "
+                       "\"rms_c\":%.4f, \"enob\":%.2f, \"tone_fraction\":%.2f, \"peaks\":[",
+                       index, noise->samples, noise->sample_rate_hz, noise->mean_code, noise->rms_lsb, noise->p2p_lsb,
+                       noise->rms_c, noise->enob, noise->tone_fraction);
+    for (int i = 0; i < noise->peak_count && len < buffer_size; ++i) {
+        len += snprintf(buffer + len, buffer_size - len, "%s{\"hz\":%.2f, \"lsb\":%.3f}", i ? ", " : "",
+                        noise->peaks[i].frequency_hz, noise->peaks[i].amplitude_lsb);
+    }
+    if (len < buffer_size) {
+        snprintf(buffer + len, buffer_size - len, "]}}");
+    }
+}
+
+// Sends the noise diagnostic result once its capture is complete (or failed)
+static void _send_noise_result(void) {
+    if (s_noise_diag_index == 0) {
+        return;
+    }
+    NoiseAnalysis_t noise;
+    esp_err_t ret = temp_comp_diag_noise_result(&noise);
+    if (ret == ESP_ERR_NOT_FINISHED) {
+        return;
+    }
+    char *frame = s_serial_buffer;
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Noise diagnostic of thermistor %d failed. Error: %s", s_noise_diag_index, esp_err_to_name(ret));
+        snprintf(frame, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+    } else {
+        _format_noise_json(frame, SERIAL_BUFFER_SIZE, s_noise_diag_index, &noise);
+    }
+    s_noise_diag_index = 0;
+    esp_err_t send_ret = serial_comp_send(frame);
+    if (send_ret != ESP_OK) {
+        LOGE_RL(TAG, "Failed to send noise result over serial: %s", esp_err_to_name(send_ret));
+    }
+}
+
+static esp_err_t _parse_channel_list(const char *str, bool *mask) {
+    if (strcmp(str, "all") == 0) {
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) mask[i] = true;
+        return ESP_OK;
+    }
+    memset(mask, 0, MAX_THERMISTOR_COUNT * sizeof(bool));
+    const char *p = str;
+    while (*p != '\0') {
+        char *end;
+        long index = strtol(p, &end, 10);
+        if (end == p || index < 1 || index > MAX_THERMISTOR_COUNT || (*end != ',' && *end != '\0')) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        mask[index - 1] = true;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return ESP_OK;
+}
+
+static void _format_alarm_json(char *buffer, size_t buffer_size, int index, const AlarmConfig_t *alarm) {
+    bool active[TEMP_ALARM_TYPE_COUNT] = {false};
+    temp_comp_get_alarm_state(index - 1, active);
+    snprintf(buffer, buffer_size,
+             "{\"index\":%d, \"alarm\":{\"enabled\":%s, \"low_c\":%.2f, \"high_c\":%.2f, \"hysteresis_c\":%.2f, \"max_rate_c_per_min\":%.2f, "
+             "\"active\":{\"high\":%s, \"low\":%s, \"rate\":%s}}}",
+             index, alarm->enabled ? "true" : "false", alarm->low_c, alarm->high_c, alarm->hysteresis_c, alarm->max_rate_c_per_min,
+             active[TEMP_ALARM_HIGH] ? "true" : "false", active[TEMP_ALARM_LOW] ? "true" : "false", active[TEMP_ALARM_RATE] ? "true" : "false");
+}
+
+// Everything that follows the measurement cycles: the stream in its mode, the boot report and the subscriptions
+static void _stream_cycle(const TemperatureOutputData_t *snapshot, char *buffer, size_t buffer_size) {
+    if (config_comp_get_serial_stream_active()) {
+        StreamMode_t mode = config_comp_get_stream_mode();
+        if (mode == STREAM_MODE_ON_CHANGE) {
+            _stream_on_change(snapshot, buffer, buffer_size);
+        } else if (mode == STREAM_MODE_STATS) {
+            s_last_report_valid = false;
+            _send_stats(buffer, buffer_size, true);
+        } else {
+            s_last_report_valid = false;
+            _stream_full(snapshot, buffer, buffer_size);
+        }
+    }
+    if (!s_boot_reported && boot_prof_complete()) {
+        s_boot_reported = true; // Lets the host log boot-to-first-sample of every power cycle
+        _format_boot_json(buffer, buffer_size);
+        serial_comp_send(buffer);
+    }
+    if (serial_subs_any_enabled()) {
+        serial_subs_feed(snapshot, buffer, buffer_size); // One snapshot for all subscriptions
+    }
+}
+
+// Streams every queued cycle snapshot in order; called by serial_comp_task after the pending events
+static void _send_pending_cycles(void) {
+    if (uxQueueMessagesWaiting(s_snapshot_queue) == 0 && s_snapshots_dropped == s_snapshots_dropped_reported) {
+        return;
+    }
+    char *frame = s_serial_buffer;
+    while (xQueueReceive(s_snapshot_queue, &s_stream_snapshot, 0) == pdTRUE) {
+        _stream_cycle(&s_stream_snapshot, frame, SERIAL_BUFFER_SIZE);
+    }
+    uint32_t dropped = s_snapshots_dropped;
+    if (dropped != s_snapshots_dropped_reported) {
+        LOGW_RL(TAG, "%" PRIu32 " cycle snapshots dropped, the link is slower than the sampling rate", dropped - s_snapshots_dropped_reported);
+        s_snapshots_dropped_reported = dropped;
+    }
+}
+
+// Snapshots are only posted while something consumes them
+static void _update_snapshots_wanted(void) {
+    bool stream_active = config_comp_get_serial_stream_active();
+    if (!stream_active) {
+        s_last_report_valid = false; // Re-enabling the stream starts with a full snapshot
+    }
+    s_snapshots_wanted = stream_active || serial_subs_any_enabled() || !s_boot_reported;
+}
+
+// Waits for a command, sending alarm/rate frames and streaming the cycles as soon as they are posted,
+// so neither a busy nor a silent host delays them. A burst dump in progress goes out one slice per pass,
+// and a pending noise diagnostic is polled until its result is sent.
+static void _wait_command(char **cmd) {
+    while (1) {
+        _send_pending_events();
+        _send_pending_cycles();
+        _update_snapshots_wanted();
+        _send_burst_dump_slice();
+        _send_noise_result();
+        if (xQueueReceive(s_command_queue, cmd, 0) == pdTRUE) {
+            return;
+        }
+        ulTaskNotifyTake(pdTRUE, s_burst_dump.active ? 0 : s_noise_diag_index > 0 ? pdMS_TO_TICKS(NOISE_POLL_MS) : portMAX_DELAY);
     }
 }
 
 void serial_rx_task(void *arg) {
-    char command_buffer[MAX_COMMAND_LEN];
     ESP_LOGI(TAG, "Serial RX task started.");
+    // The line is received straight into a pool block and only its pointer is queued.
+    // The pool holds one block more than the queue and the processing task can own, so this never waits.
+    char *command_buffer = serial_pool_get(&s_command_pool, portMAX_DELAY);
     while(1) {
         int len = serial_comp_receive(command_buffer, MAX_COMMAND_LEN);
         if (len > 0) {
             // Send the received command to the queue
-            if (xQueueSend(s_command_queue, command_buffer, pdMS_TO_TICKS(100)) != pdTRUE) {
+            if (xQueueSend(s_command_queue, &command_buffer, pdMS_TO_TICKS(100)) != pdTRUE) {
                 ESP_LOGE(TAG, "Failed to send command to queue (queue full or timeout).");
             } else {
                 ESP_LOGD(TAG, "Command '%s' sent to queue.", command_buffer);
+                command_buffer = serial_pool_get(&s_command_pool, portMAX_DELAY); // Processing task returns the sent one
+                _wake_serial_task();
             }
         } else if (len == 0) {
             // Timeout in serial_comp_receive, no full line yet, or empty line.
@@ -184,211 +796,804 @@ void serial_rx_task(void *arg) {
 }
 
 void serial_comp_task(void *arg) {
-    char rcv_cmd[MAX_COMMAND_LEN];
-    TickType_t queue_timeout_ticks;
+    char *rcv_cmd = NULL;
 
+    s_serial_task_handle = xTaskGetCurrentTaskHandle(); // Commands, events and snapshots queued before now are picked up below
     while(1) {
-        queue_timeout_ticks = pdMS_TO_TICKS(config_comp_get_sampling_interval());
-
-        if (xQueueReceive(s_command_queue, rcv_cmd, queue_timeout_ticks) == pdTRUE) { // cmd received
-            ESP_LOGI(TAG, "Processing command: %s (raw len: %d)", rcv_cmd, strlen(rcv_cmd));
-
-            // // --- Begin Detailed Debugging ---
-            // const char* target_prefix_debug = "set sampling interval ";
-            // int prefix_len_debug = strlen(target_prefix_debug); // Should be 23
-
-            // ESP_LOGI(TAG, "Comparing rcv_cmd with target_prefix_debug: '%s' (len: %d)", target_prefix_debug, prefix_len_debug);
-            // bool mismatch_found = false;
-            // int compare_len = strlen(rcv_cmd) < prefix_len_debug ? strlen(rcv_cmd) : prefix_len_debug;
-
-            // for (int k = 0; k < prefix_len_debug; ++k) { // Iterate up to the full prefix length
-            //     if (k >= strlen(rcv_cmd) || rcv_cmd[k] != target_prefix_debug[k]) {
-            //         ESP_LOGE(TAG, "Mismatch at index %d:", k);
-            //         if (k < strlen(rcv_cmd)) {
-            //             ESP_LOGE(TAG, "  rcv_cmd[%d] = 0x%02X ('%c')", k, (unsigned char)rcv_cmd[k], isprint((unsigned char)rcv_cmd[k]) ? rcv_cmd[k] : '?');
-            //         } else {
-            //             ESP_LOGE(TAG, "  rcv_cmd is shorter, ends at index %d", strlen(rcv_cmd) -1);
-            //         }
-            //         ESP_LOGE(TAG, "  target_prefix_debug[%d] = 0x%02X ('%c')", k, (unsigned char)target_prefix_debug[k], isprint((unsigned char)target_prefix_debug[k]) ? target_prefix_debug[k] : '?');
-            //         mismatch_found = true;
-            //         break;
-            //     }
-            // }
-            // if (!mismatch_found) {
-            //     ESP_LOGI(TAG, "Manual byte-by-byte comparison for prefix PASSED.");
-            // }
-            // // --- End Detailed Debugging ---
+        _wait_command(&rcv_cmd);
+        char *reply = s_serial_buffer;
+        ESP_LOGI(TAG, "Processing command: %s (raw len: %d)", rcv_cmd, strlen(rcv_cmd));
+
+        // // --- Begin Detailed Debugging ---
+        // const char* target_prefix_debug = "set sampling interval ";
+        // int prefix_len_debug = strlen(target_prefix_debug); // Should be 23
+
+        // ESP_LOGI(TAG, "Comparing rcv_cmd with target_prefix_debug: '%s' (len: %d)", target_prefix_debug, prefix_len_debug);
+        // bool mismatch_found = false;
+        // int compare_len = strlen(rcv_cmd) < prefix_len_debug ? strlen(rcv_cmd) : prefix_len_debug;
+
+        // for (int k = 0; k < prefix_len_debug; ++k) { // Iterate up to the full prefix length
+        //     if (k >= strlen(rcv_cmd) || rcv_cmd[k] != target_prefix_debug[k]) {
+        //         ESP_LOGE(TAG, "Mismatch at index %d:", k);
+        //         if (k < strlen(rcv_cmd)) {
+        //             ESP_LOGE(TAG, "  rcv_cmd[%d] = 0x%02X ('%c')", k, (unsigned char)rcv_cmd[k], isprint((unsigned char)rcv_cmd[k]) ? rcv_cmd[k] : '?');
+        //         } else {
+        //             ESP_LOGE(TAG, "  rcv_cmd is shorter, ends at index %d", strlen(rcv_cmd) -1);
+        //         }
+        //         ESP_LOGE(TAG, "  target_prefix_debug[%d] = 0x%02X ('%c')", k, (unsigned char)target_prefix_debug[k], isprint((unsigned char)target_prefix_debug[k]) ? target_prefix_debug[k] : '?');
+        //         mismatch_found = true;
+        //         break;
+        //     }
+        // }
+        // if (!mismatch_found) {
+        //     ESP_LOGI(TAG, "Manual byte-by-byte comparison for prefix PASSED.");
+        // }
+        // // --- End Detailed Debugging ---
+        
+        if (strcmp(rcv_cmd, "help") == 0) {
+            serial_comp_send(
+                "Available commands:\n"
+                "  help - Show this help message\n"
+                "  get temps - Get latest temperature readings in JSON format\n"
+                "  status - same as get temps\n"
+                "  toggle serial stream - Toggle streaming of temp measurements (taking place every 'sampling_interval_ms' ms) to the serial\n"
+                "  toggle temp log - Toggle logging of temperature measurements to the connected ESP32 device console\n"
+                "  force cache refresh - Make the measurement task re-read its whole configuration and ADC channels before its next cycle\n"
+                "  set sampling interval <ms> - Set the sampling interval for temperature measurements (default is 1000 ms)\n"
+                "  get sampling interval - Get the current sampling interval in milliseconds\n"
+                "  incr cal res <index> - Increment the calibration resistance offset for a specific thermistor index (min index is 1)\n"
+                "  decr cal res <index> - Decrement the calibration resistance offset for a specific thermistor index (min index is 1)\n"
+                "  set cal res <index> <value> - Set the calibration resistance offset for a specific thermistor index (min index is 1)\n"
+                "  set therm <index> <name> <divider_R> <adc_channel> <mux_address> [adc_unit] - Configure a thermistor slot (name UNUSED frees it, mux_address -1: direct, adc_unit 1 (default) or 2)\n"
+                "  get therm <index> - Get the configuration of a thermistor slot\n"
+                "  set mux settle <us> - Set the delay between switching the mux address and converting\n"
+                "  get mux - Get the multiplexer address lines and settling delay\n"
+                "  set model sh <index> <A> <B> <C> - Set the Steinhart-Hart coefficients of a thermistor\n"
+                "  set model beta <index> <beta> <R25> - Set a Beta model (beta in K, resistance at 25 C in Ohm) for a thermistor\n"
+                "  get model <index> - Get the resistance-to-temperature model of a thermistor\n"
+                "  calibrate point <index> <T_C> [R] - Record a reference temperature against the current (or given) resistance, up to 3 points\n"
+                "  calibrate solve <index> - Fit the recorded points (3: Steinhart-Hart, 2: Beta) and apply the model\n"
+                "  calibrate clear <index> - Discard the recorded calibration points\n"
+                "  calibrate status <index> - List the recorded calibration points\n"
+                "  set filter median <index> <window> - Set the median (spike rejection) window of a thermistor (0: off, odd up to 7)\n"
+                "  set filter iir <index> <alpha> - Set the first-order IIR smoothing factor of a thermistor (0: off, 0 < alpha < 1)\n"
+                "  set filter kalman <index> <q> <r> - Set the scalar Kalman process/measurement noise variances of a thermistor (q = 0: off)\n"
+                "  get filter <index> - Get the filter chain configuration of a thermistor\n"
+                "  set stream mode <full|change|stats> - Stream full snapshots, only channels that moved beyond the deadband, or window statistics\n"
+                "  set deadband <abs_C> <rel> - Set the report-on-change deadband (absolute in C, relative as a fraction; 0: off)\n"
+                "  set heartbeat <ms> - Set the full-snapshot heartbeat period of the report-on-change stream\n"
+                "  get stream config - Get the stream mode, deadband, heartbeat and statistics window\n"
+                "  sub add <name> <json|bin|stats|raw> <divisor> [all|<i,j,...>] - Add a stream subscription: a frame every <divisor> measurement cycles\n"
+                "  sub <remove|enable|disable> <name> - Remove, resume or pause a stream subscription\n"
+                "  sub list - List the stream subscriptions\n"
+                "  set low power <on|off> - Enable/disable automatic light sleep between samples (USB RX polling stops while on)\n"
+                "  get power stats - Get wake-to-sample latency, awake time and estimated average current per sample\n"
+                "  burst arm <index> <pre> <post> [rise|fall <level_C>] - Sample one directly wired thermistor back to back, keep <pre> samples before the trigger and <post> from it on\n"
+                "  trigger - Fire the trigger of the armed burst capture now\n"
+                "  burst <status|stop> - Get the burst capture state, or abort/discard the capture\n"
+                "  burst dump - Send the frozen capture: a status line, then $B frames of packed 12-bit raw codes, in slices between other frames\n"
+                "  diag noise <index> - Sample a directly wired thermistor at 1 kHz for ~1 s and report noise RMS, ENOB and the dominant interference frequencies (the result follows once the capture is complete; refused while a burst capture is not dumped)\n"
+                "  boot stats - Get the time of each boot phase (app_main, config/ADC, first sample, serial link) in us since start\n"
+                "  get stats - Get min/max/mean/stddev per thermistor over the last completed window\n"
+                "  set stats window <samples> - Set the tumbling statistics window length in measurement cycles\n"
+                "  set alarm <index> <low_C> <high_C> <hyst_C> - Enable low/high threshold alarms with hysteresis on a thermistor\n"
+                "  set alarm rate <index> <C_per_min> - Set the |dT/dt| alarm limit of a thermistor (0: off)\n"
+                "  clear alarm <index> - Disable all alarm rules of a thermistor\n"
+                "  get alarm <index> - Get the alarm rules and active alarms of a thermistor\n"
+                "  set adaptive <min_ms> <max_ms> <rate_C_per_min> <stddev_C> - Enable adaptive sampling between the bounds (threshold 0: unused)\n"
+                "  set adaptive hysteresis <factor> <calm_cycles> - Calm below threshold*factor for calm_cycles cycles doubles the interval\n"
+                "  set adaptive off - Disable adaptive sampling (back to the fixed sampling interval)\n"
+                "  get adaptive - Get the adaptive sampling configuration and the current interval\n"
+                "  get health - Get the health (ok/suspect/open/short/noisy), fault count and re-probe back-off of every thermistor\n"
+                "  set log mode <text|binary> - Format hot-path logs on the device, or queue them as $L records decoded by the host\n"
+                "  get log stats - Get the queued/dropped binary records and rate-limited log messages\n"
+            );
+
+        } else if (strcmp(rcv_cmd, "status") == 0 || strcmp(rcv_cmd, "get temps") == 0) {
+            _get_and_send_latest_temps_json(reply, SERIAL_BUFFER_SIZE);
+            ESP_LOGI("", "%s", reply);
+
+        } else if (strcmp(rcv_cmd, "toggle serial stream") == 0) {
+            bool current_serial_stream_state = config_comp_get_serial_stream_active();
+            esp_err_t ret = config_comp_set_serial_stream_active(!current_serial_stream_state);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to toggle serial stream state. Error: %s", esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"serial_stream_active\":%s}", !current_serial_stream_state ? "true": "false");
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            } 
+
+        } else if (strcmp(rcv_cmd, "toggle temp log") == 0) {
+            bool current_log_temp_state = config_comp_get_log_temps_active();
+            esp_err_t ret = config_comp_set_log_temps_active(!current_log_temp_state);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to toggle temperature logging at the device console.\nError: %s", esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"temp_log_active\":%s}", !current_log_temp_state ? "true": "false");
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            } 
+
+        } else if (strcmp(rcv_cmd, "force cache refresh") == 0) {
+            // The measurement task re-reads everything in _apply_config_changes; never touch its caches from here
+            esp_err_t ret = config_comp_request_refresh();
+
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to request a configuration refresh of the temperature measurement component.\nError: %s", esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"temp_component_cache_refresh_ok\":%s}", "true");
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            } 
+
+        } else if (strncmp(rcv_cmd, "set sampling interval ", 22) == 0) {
+            int new_interval = atoi(rcv_cmd + 22);
+           
+            esp_err_t ret = config_comp_set_sampling_interval(new_interval);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set new sampling interval: %s", esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"sampling_interval_ms\":%d}", new_interval);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            } else {
+                ESP_LOGI(TAG, "Sampling interval set to %d ms", new_interval);
+            }
             
-            if (strcmp(rcv_cmd, "help") == 0) {
-                serial_comp_send(
-                    "Available commands:\n"
-                    "  help - Show this help message\n"
-                    "  get temps - Get latest temperature readings in JSON format\n"
-                    "  status - same as get temps\n"
-                    "  toggle serial stream - Toggle streaming of temp measurements (taking place every 'sampling_interval_ms' ms) to the serial\n"
-                    "  toggle temp log - Toggle logging of temperature measurements to the connected ESP32 device console\n"
-                    "  force cache refresh - Force a refresh of the temperature component configuration and ADC channels\n"
-                    "  set sampling interval <ms> - Set the sampling interval for temperature measurements (default is 1000 ms)\n"
-                    "  get sampling interval - Get the current sampling interval in milliseconds\n"
-                    "  incr cal res <index> - Increment the calibration resistance offset for a specific thermistor index (min index is 1)\n"
-                    "  decr cal res <index> - Decrement the calibration resistance offset for a specific thermistor index (min index is 1)\n"
-                    "  set cal res <index> <value> - Set the calibration resistance offset for a specific thermistor index (min index is 1)\n"
-                );
-
-            } else if (strcmp(rcv_cmd, "status") == 0 || strcmp(rcv_cmd, "get temps") == 0) {
-                _get_and_send_latest_temps_json(s_serial_buffer, SERIAL_BUFFER_SIZE);
-                ESP_LOGI("", "%s", s_serial_buffer);
-
-            } else if (strcmp(rcv_cmd, "toggle serial stream") == 0) {
-                bool current_serial_stream_state = config_comp_get_serial_stream_active();
-                esp_err_t ret = config_comp_set_serial_stream_active(!current_serial_stream_state);
-                if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to toggle serial stream state. Error: %s", esp_err_to_name(ret));
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
-                } else {
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"serial_stream_active\":%s}", !current_serial_stream_state ? "true": "false");
+        } else if (strcmp(rcv_cmd, "get sampling interval") == 0) {
+            int ret = config_comp_get_sampling_interval();
+
+            snprintf(reply, SERIAL_BUFFER_SIZE, "{\"sampling_interval_ms\":%d}", ret);
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            } else {
+                ESP_LOGI(TAG, "Sampling interval: %d ms", ret);
+            }
+            
+        } else if (strncmp(rcv_cmd, "incr cal res ", 13) == 0) {
+            int index = atoi(rcv_cmd + 13);
+            int cal_R;
+
+            esp_err_t ret = config_comp_incr_calibration_resistance_offset(index - 1);
+            ret = ret == ESP_OK ? config_comp_get_calibration_resistance_offset(index - 1, &cal_R) : ret;
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to increment calibration resistance offset at index %d.\nError: %s", index, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_R\":%d}", index, cal_R);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+            
+        } else if (strncmp(rcv_cmd, "decr cal res ", 13) == 0) {
+            int index = atoi(rcv_cmd + 13);
+            int cal_R;
+
+            esp_err_t ret = config_comp_decr_calibration_resistance_offset(index - 1);
+            ret = ret == ESP_OK ? config_comp_get_calibration_resistance_offset(index - 1, &cal_R) : ret;
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to decrement calibration resistance offset at index %d.\nError: %s", index, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_R\":%d}", index, cal_R);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+            
+        } else if (strncmp(rcv_cmd, "set cal res ", 12) == 0) {
+            char *args_ptr = rcv_cmd + 12;
+            int index;
+            int cal_R;
+            int items_scanned = sscanf(args_ptr, "%d %d", &index, &cal_R);
+
+            if (items_scanned == 2) {
+                // Command expects 1-based index, function takes 0-based.
+                // (e.g., user types "set cal res 1 100", index is 1, we pass 0 to function)
+                int fetched_cal_R;
+                esp_err_t ret_set = config_comp_set_calibration_resistance_offset(index - 1, cal_R);
+                esp_err_t ret_get = ESP_FAIL; 
+
+                if (ret_set == ESP_OK) {
+                    ret_get = config_comp_get_calibration_resistance_offset(index - 1, &fetched_cal_R);
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
-                } 
 
-            } else if (strcmp(rcv_cmd, "toggle temp log") == 0) {
-                bool current_log_temp_state = config_comp_get_log_temps_active();
-                esp_err_t ret = config_comp_set_log_temps_active(!current_log_temp_state);
-                if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to toggle temperature logging at the device console.\nError: %s", esp_err_to_name(ret));
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+                esp_err_t final_ret = (ret_set == ESP_OK) ? ret_get : ret_set;
+
+                if (final_ret != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to set/get calibration resistance offset for index %d to %d. Error: %s", index, cal_R, esp_err_to_name(final_ret));
+                    snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(final_ret));
                 } else {
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"temp_log_active\":%s}", !current_log_temp_state ? "true": "false");
+                    snprintf(reply, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_R\":%d}", index, fetched_cal_R);
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
-                } 
+            } else {
+                ESP_LOGE(TAG, "Malformed 'set cal res' command: '%s'. Expected: set cal res <index> <value>", rcv_cmd);
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"malformed command syntax for set cal res\"}");
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+            
+        } else if (strncmp(rcv_cmd, "set therm ", 10) == 0) {
+            int index = 0;
+            ThermistorConfig_t therm_config;
+            char name[sizeof(therm_config.name)];
+            int divider_R, adc_channel, mux_address;
+            int adc_unit = 1; // 1-based as printed on the pinout; legacy commands without it mean ADC1
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
 
-            } else if (strcmp(rcv_cmd, "force cache refresh") == 0) {
-                esp_err_t ret = config_comp_update_thermistor_count();
-                ret = ret == ESP_OK ? temp_comp_refresh_cached_config_and_adc() : ret; 
-                
-                if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to force configuration refrech of the temperature measurement component.\nError: %s", esp_err_to_name(ret));
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
-                } else {
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"temp_component_cache_refresh_ok\":%s}", "true");
+            if (sscanf(rcv_cmd + 10, "%d %9s %d %d %d %d", &index, name, &divider_R, &adc_channel, &mux_address, &adc_unit) >= 5) {
+                ret = config_comp_get_thermistor_config(index - 1, &therm_config); // Keep calibration, filter and alarm settings
+                if (ret == ESP_OK) {
+                    strncpy(therm_config.name, name, sizeof(therm_config.name));
+                    therm_config.divider_resistor_value = divider_R;
+                    therm_config.adc_channel = adc_channel;
+                    therm_config.adc_unit = adc_unit - 1;
+                    therm_config.mux_address = mux_address;
+                    ret = config_comp_set_thermistor_config(index - 1, &therm_config);
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
-                } 
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process '%s'. Expected: set therm <index> <name> <divider_R> <adc_channel> <mux_address> [adc_unit]. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_therm_json(reply, SERIAL_BUFFER_SIZE, index, &therm_config);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
 
-            } else if (strncmp(rcv_cmd, "set sampling interval ", 22) == 0) {
-                int new_interval = atoi(rcv_cmd + 22);
-               
-                esp_err_t ret = config_comp_set_sampling_interval(new_interval);
-                if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to set new sampling interval: %s", esp_err_to_name(ret));
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
-                } else {
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"sampling_interval_ms\":%d}", new_interval);
+        } else if (strncmp(rcv_cmd, "get therm ", 10) == 0) {
+            int index = atoi(rcv_cmd + 10);
+            ThermistorConfig_t therm_config;
+
+            esp_err_t ret = config_comp_get_thermistor_config(index - 1, &therm_config);
+            if (ret != ESP_OK) {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_therm_json(reply, SERIAL_BUFFER_SIZE, index, &therm_config);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set mux settle ", 15) == 0 || strcmp(rcv_cmd, "get mux") == 0) {
+            esp_err_t ret = ESP_OK;
+            if (rcv_cmd[0] == 's') {
+                ret = config_comp_set_mux_settle_us(atoi(rcv_cmd + 15));
+            }
+            MuxConfig_t mux;
+            ret = ret == ESP_OK ? config_comp_get_mux_config(&mux) : ret;
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process mux command '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                int len = snprintf(reply, SERIAL_BUFFER_SIZE, "{\"mux\":{\"addr_bits\":%d, \"settle_us\":%d, \"addr_gpios\":[",
+                                   mux.addr_bits, mux.settle_us);
+                for (int b = 0; b < mux.addr_bits; ++b) {
+                    len += snprintf(reply + len, SERIAL_BUFFER_SIZE - len, "%s%d", b ? "," : "", mux.addr_gpios[b]);
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
-                } else {
-                    ESP_LOGI(TAG, "Sampling interval set to %d ms", new_interval);
+                snprintf(reply + len, SERIAL_BUFFER_SIZE - len, "]}}");
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set model ", 10) == 0 || strncmp(rcv_cmd, "get model ", 10) == 0) {
+            char *args_ptr = rcv_cmd + 10;
+            int index = 0;
+            ThermistorModel_t model;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+            float a, b, c, beta, r25;
+            if (rcv_cmd[0] == 'g') {
+                index = atoi(args_ptr);
+                ret = config_comp_get_thermistor_model(index - 1, &model);
+            } else if (sscanf(args_ptr, "sh %d %f %f %f", &index, &a, &b, &c) == 4) {
+                ret = config_comp_get_thermistor_model(index - 1, &model); // Keep the Beta parameters
+                if (ret == ESP_OK) {
+                    model.type = THERM_MODEL_STEINHART_HART;
+                    model.a = a;
+                    model.b = b;
+                    model.c = c;
+                    ret = config_comp_set_thermistor_model(index - 1, &model);
                 }
-                
-            } else if (strcmp(rcv_cmd, "get sampling interval") == 0) {
-                int ret = config_comp_get_sampling_interval();
+            } else if (sscanf(args_ptr, "beta %d %f %f", &index, &beta, &r25) == 3) {
+                ret = config_comp_get_thermistor_model(index - 1, &model); // Keep the Steinhart-Hart coefficients
+                if (ret == ESP_OK) {
+                    model.type = THERM_MODEL_BETA;
+                    model.beta = beta;
+                    model.r25 = r25;
+                    ret = config_comp_set_thermistor_model(index - 1, &model);
+                }
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process model command '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_model_json(reply, SERIAL_BUFFER_SIZE, index, &model);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
 
-                snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"sampling_interval_ms\":%d}", ret);
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
-                } else {
-                    ESP_LOGI(TAG, "Sampling interval: %d ms", ret);
+        } else if (strncmp(rcv_cmd, "calibrate ", 10) == 0) {
+            char *args_ptr = rcv_cmd + 10;
+            int index = 0;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+            float reference_c, resistance;
+            int n;
+            bool reply_points = false;
+            if ((n = sscanf(args_ptr, "point %d %f %f", &index, &reference_c, &resistance)) >= 2) {
+                ret = temp_comp_cal_add_point(index - 1, reference_c, n == 3 ? resistance : NAN);
+                reply_points = true;
+            } else if (sscanf(args_ptr, "solve %d", &index) == 1) {
+                ThermistorModel_t model;
+                ret = temp_comp_cal_solve(index - 1, &model);
+                if (ret == ESP_OK) {
+                    _format_model_json(reply, SERIAL_BUFFER_SIZE, index, &model);
                 }
-                
-            } else if (strncmp(rcv_cmd, "incr cal res ", 13) == 0) {
-                int index = atoi(rcv_cmd + 13);
-                int cal_R;
+            } else if (sscanf(args_ptr, "clear %d", &index) == 1) {
+                ret = temp_comp_cal_clear(index - 1);
+                reply_points = true;
+            } else if (sscanf(args_ptr, "status %d", &index) == 1) {
+                ret = ESP_OK;
+                reply_points = true;
+            }
 
-                esp_err_t ret = config_comp_incr_calibration_resistance_offset(index - 1);
-                ret = ret == ESP_OK ? config_comp_get_calibration_resistance_offset(index - 1, &cal_R) : ret;
-                if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to increment calibration resistance offset at index %d.\nError: %s", index, esp_err_to_name(ret));
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+            if (ret == ESP_OK && reply_points) {
+                CalPoint_t points[MAX_CAL_POINTS];
+                int count = 0;
+                ret = temp_comp_cal_get_points(index - 1, points, &count);
+                if (ret == ESP_OK) {
+                    int len = snprintf(reply, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_points\":[", index);
+                    for (int p = 0; p < count; ++p) {
+                        len += snprintf(reply + len, SERIAL_BUFFER_SIZE - len, "%s{\"R\":%.2f, \"T\":%.3f}",
+                                        p ? "," : "", points[p].resistance_ohm, points[p].temperature_c);
+                    }
+                    snprintf(reply + len, SERIAL_BUFFER_SIZE - len, "]}");
+                }
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process calibration command '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set adaptive ", 13) == 0 || strcmp(rcv_cmd, "get adaptive") == 0) {
+            char *args_ptr = rcv_cmd + 13;
+            AdaptiveConfig_t adaptive;
+            esp_err_t ret = config_comp_get_adaptive_config(&adaptive);
+
+            int min_ms, max_ms, calm_cycles;
+            float rate, stddev, hysteresis;
+            if (ret == ESP_OK && rcv_cmd[0] == 's') {
+                if (strcmp(args_ptr, "off") == 0) {
+                    adaptive.enabled = false;
+                } else if (sscanf(args_ptr, "hysteresis %f %d", &hysteresis, &calm_cycles) == 2) {
+                    adaptive.hysteresis = hysteresis;
+                    adaptive.calm_cycles = calm_cycles;
+                } else if (sscanf(args_ptr, "%d %d %f %f", &min_ms, &max_ms, &rate, &stddev) == 4) {
+                    adaptive.enabled = true;
+                    adaptive.min_interval_ms = min_ms;
+                    adaptive.max_interval_ms = max_ms;
+                    adaptive.rate_c_per_min = rate;
+                    adaptive.stddev_c = stddev;
                 } else {
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_R\":%d}", index, cal_R);
+                    ret = ESP_ERR_INVALID_ARG;
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+                ret = ret == ESP_OK ? config_comp_set_adaptive_config(&adaptive) : ret;
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process adaptive command '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                // interval_ms is the one in effect now; a change made above is applied on the next cycle
+                snprintf(reply, SERIAL_BUFFER_SIZE,
+                         "{\"adaptive\":{\"enabled\":%s, \"min_ms\":%d, \"max_ms\":%d, \"rate_c_per_min\":%.2f, \"stddev_c\":%.2f, "
+                         "\"hysteresis\":%.2f, \"calm_cycles\":%d, \"interval_ms\":%d}}",
+                         adaptive.enabled ? "true" : "false", adaptive.min_interval_ms, adaptive.max_interval_ms,
+                         adaptive.rate_c_per_min, adaptive.stddev_c, adaptive.hysteresis, adaptive.calm_cycles,
+                         temp_comp_get_sampling_interval_ms());
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strcmp(rcv_cmd, "get health") == 0) {
+            HealthState_t health[MAX_THERMISTOR_COUNT];
+            esp_err_t ret = temp_comp_get_health(health);
+            if (ret == ESP_OK) {
+                ret = temp_comp_get_latest_temps(&s_stream_snapshot) == ESP_OK ? ESP_OK : ESP_FAIL; // For the names
+            }
+            if (ret != ESP_OK) {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                int len = snprintf(reply, SERIAL_BUFFER_SIZE, "{\"health\":[");
+                bool first = true;
+                for (int i = 0; i < MAX_THERMISTOR_COUNT && len < SERIAL_BUFFER_SIZE; ++i) {
+                    if (s_stream_snapshot.thermistor_names[i][0] == '\0') continue;
+                    len += snprintf(reply + len, SERIAL_BUFFER_SIZE - len,
+                                    "%s{\"index\":%d, \"name\":\"%s\", \"state\":\"%s\", \"faults\":%"PRIu32", \"backoff_cycles\":%d}",
+                                    first ? "" : ",", i + 1, s_stream_snapshot.thermistor_names[i],
+                                    temp_health_to_str(health[i].state), health[i].fault_count, health[i].backoff_cycles);
+                    first = false;
                 }
-                
-            } else if (strncmp(rcv_cmd, "decr cal res ", 13) == 0) {
-                int index = atoi(rcv_cmd + 13);
-                int cal_R;
+                if (len < SERIAL_BUFFER_SIZE) {
+                    snprintf(reply + len, SERIAL_BUFFER_SIZE - len, "]}");
+                }
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
 
-                esp_err_t ret = config_comp_decr_calibration_resistance_offset(index - 1);
-                ret = ret == ESP_OK ? config_comp_get_calibration_resistance_offset(index - 1, &cal_R) : ret;
+        } else if (strncmp(rcv_cmd, "set log mode ", 13) == 0 || strcmp(rcv_cmd, "get log stats") == 0) {
+            esp_err_t ret = ESP_OK;
+            if (rcv_cmd[0] == 's') {
+                const char *mode_arg = rcv_cmd + 13;
+                if (strcmp(mode_arg, "text") == 0) {
+                    ret = log_comp_set_mode(LOG_MODE_TEXT);
+                } else if (strcmp(mode_arg, "binary") == 0) {
+                    ret = log_comp_set_mode(LOG_MODE_BINARY);
+                } else {
+                    ret = ESP_ERR_INVALID_ARG;
+                }
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process log command '%s'. Expected: set log mode <text|binary>. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                LogStats_t log_stats;
+                log_comp_get_stats(&log_stats);
+                snprintf(reply, SERIAL_BUFFER_SIZE,
+                         "{\"log\":{\"mode\":\"%s\", \"binary_queued\":%"PRIu32", \"binary_dropped\":%"PRIu32", \"rate_suppressed\":%"PRIu32"}}",
+                         log_comp_get_mode() == LOG_MODE_BINARY ? "binary" : "text",
+                         log_stats.binary_queued, log_stats.binary_dropped, log_stats.rate_suppressed);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set filter ", 11) == 0) {
+            char *args_ptr = rcv_cmd + 11;
+            int index = 0;
+            FilterConfig_t filter;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+            bool parsed = false;
+
+            int window;
+            float alpha, q, r;
+            if (sscanf(args_ptr, "median %d %d", &index, &window) == 2) {
+                ret = config_comp_get_filter_config(index - 1, &filter);
+                filter.median_window = window;
+                parsed = true;
+            } else if (sscanf(args_ptr, "iir %d %f", &index, &alpha) == 2) {
+                ret = config_comp_get_filter_config(index - 1, &filter);
+                filter.iir_alpha = alpha;
+                parsed = true;
+            } else if (sscanf(args_ptr, "kalman %d %f %f", &index, &q, &r) == 3) {
+                ret = config_comp_get_filter_config(index - 1, &filter);
+                filter.kalman_q = q;
+                filter.kalman_r = r;
+                parsed = true;
+            }
+
+            if (!parsed) {
+                ESP_LOGE(TAG, "Malformed 'set filter' command: '%s'", rcv_cmd);
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"malformed command syntax for set filter\"}");
+            } else {
+                ret = ret == ESP_OK ? config_comp_set_filter_config(index - 1, &filter) : ret;
                 if (ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to decrement calibration resistance offset at index %d.\nError: %s", index, esp_err_to_name(ret));
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":%s}", esp_err_to_name(ret));
+                    ESP_LOGE(TAG, "Failed to set filter for index %d. Error: %s", index, esp_err_to_name(ret));
+                    snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
                 } else {
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_R\":%d}", index, cal_R);
+                    _format_filter_json(reply, SERIAL_BUFFER_SIZE, index, &filter);
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set stream mode ", 16) == 0) {
+            const char *mode_str = rcv_cmd + 16;
+            esp_err_t ret;
+            if (strcmp(mode_str, "full") == 0) {
+                ret = config_comp_set_stream_mode(STREAM_MODE_FULL);
+            } else if (strcmp(mode_str, "change") == 0) {
+                ret = config_comp_set_stream_mode(STREAM_MODE_ON_CHANGE);
+            } else if (strcmp(mode_str, "stats") == 0) {
+                ret = config_comp_set_stream_mode(STREAM_MODE_STATS);
+            } else {
+                ret = ESP_ERR_INVALID_ARG;
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set stream mode '%s'. Error: %s", mode_str, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_stream_config_json(reply, SERIAL_BUFFER_SIZE);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set deadband ", 13) == 0) {
+            float abs_c, rel;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+            if (sscanf(rcv_cmd + 13, "%f %f", &abs_c, &rel) == 2) {
+                ret = config_comp_set_deadband(abs_c, rel);
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set deadband from '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_stream_config_json(reply, SERIAL_BUFFER_SIZE);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set heartbeat ", 14) == 0) {
+            esp_err_t ret = config_comp_set_heartbeat(atoi(rcv_cmd + 14));
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set heartbeat. Error: %s", esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_stream_config_json(reply, SERIAL_BUFFER_SIZE);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set low power ", 14) == 0) {
+            const char *arg_str = rcv_cmd + 14;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+            if (strcmp(arg_str, "on") == 0 && !temp_power_low_power_supported()) {
+                ret = ESP_ERR_NOT_SUPPORTED; // Refused here: once configured, the mode could cut off this link
+            } else if (strcmp(arg_str, "on") == 0 || strcmp(arg_str, "off") == 0) {
+                ret = config_comp_set_low_power_mode(strcmp(arg_str, "on") == 0);
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set low-power mode '%s'. Error: %s", arg_str, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"low_power_mode\":%s}", config_comp_get_low_power_mode() ? "true" : "false");
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "burst ", 6) == 0 || strcmp(rcv_cmd, "trigger") == 0) {
+            int index = 0;
+            unsigned long pre = 0, post = 0;
+            char edge_str[8] = "";
+            float level = 0.0f;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+            int fields = sscanf(rcv_cmd, "burst arm %d %lu %lu %7s %f", &index, &pre, &post, edge_str, &level);
+            if (fields == 3) {
+                ret = temp_comp_burst_arm(index - 1, pre, post, TEMP_BURST_TRIGGER_COMMAND, 0.0f);
+            } else if (fields == 5 && (strcmp(edge_str, "rise") == 0 || strcmp(edge_str, "fall") == 0)) {
+                ret = temp_comp_burst_arm(index - 1, pre, post, edge_str[0] == 'r' ? TEMP_BURST_TRIGGER_RISE : TEMP_BURST_TRIGGER_FALL, level);
+            } else if (strcmp(rcv_cmd, "trigger") == 0) {
+                ret = temp_comp_burst_trigger();
+            } else if (strcmp(rcv_cmd, "burst stop") == 0) {
+                ret = temp_comp_burst_stop();
+            } else if (strcmp(rcv_cmd, "burst status") == 0) {
+                ret = ESP_OK;
+            } else if (strcmp(rcv_cmd, "burst dump") == 0) {
+                ret = _start_burst_dump(reply, SERIAL_BUFFER_SIZE);
+            }
+            esp_err_t send_ret = ESP_OK;
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process burst command '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+                send_ret = serial_comp_send(reply);
+            } else if (strcmp(rcv_cmd, "burst dump") != 0) {
+                _format_burst_json(reply, SERIAL_BUFFER_SIZE);
+                send_ret = serial_comp_send(reply);
+            }
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "diag noise ", 11) == 0) {
+            int index = atoi(rcv_cmd + 11);
+
+            esp_err_t ret = s_noise_diag_index > 0 ? ESP_ERR_INVALID_STATE : temp_comp_diag_noise_start(index - 1);
+            if (ret == ESP_OK) {
+                s_noise_diag_index = index; // The result is sent by _wait_command once the capture is complete
+            } else {
+                ESP_LOGE(TAG, "Noise diagnostic of thermistor %d failed. Error: %s", index, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+                esp_err_t send_ret = serial_comp_send(reply);
                 if (send_ret != ESP_OK) {
                     ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
                 }
-                
-            } else if (strncmp(rcv_cmd, "set cal res ", 12) == 0) {
-                char *args_ptr = rcv_cmd + 12;
-                int index;
-                int cal_R;
-                int items_scanned = sscanf(args_ptr, "%d %d", &index, &cal_R);
-
-                if (items_scanned == 2) {
-                    // Command expects 1-based index, function takes 0-based.
-                    // (e.g., user types "set cal res 1 100", index is 1, we pass 0 to function)
-                    int fetched_cal_R;
-                    esp_err_t ret_set = config_comp_set_calibration_resistance_offset(index - 1, cal_R);
-                    esp_err_t ret_get = ESP_FAIL; 
-
-                    if (ret_set == ESP_OK) {
-                        ret_get = config_comp_get_calibration_resistance_offset(index - 1, &fetched_cal_R);
-                    }
+            }
 
-                    esp_err_t final_ret = (ret_set == ESP_OK) ? ret_get : ret_set;
+        } else if (strcmp(rcv_cmd, "boot stats") == 0) {
+            _format_boot_json(reply, SERIAL_BUFFER_SIZE);
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
 
-                    if (final_ret != ESP_OK) {
-                        ESP_LOGE(TAG, "Failed to set/get calibration resistance offset for index %d to %d. Error: %s", index, cal_R, esp_err_to_name(final_ret));
-                        snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(final_ret));
-                    } else {
-                        snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"index\":%d, \"cal_R\":%d}", index, fetched_cal_R);
-                    }
-                } else {
-                    ESP_LOGE(TAG, "Malformed 'set cal res' command: '%s'. Expected: set cal res <index> <value>", rcv_cmd);
-                    snprintf(s_serial_buffer, SERIAL_BUFFER_SIZE, "{\"error\":\"malformed command syntax for set cal res\"}");
+        } else if (strcmp(rcv_cmd, "get power stats") == 0) {
+            TempPowerStats_t stats;
+            temp_power_get_stats(&stats);
+            snprintf(reply, SERIAL_BUFFER_SIZE,
+                     "{\"power\":{\"low_power\":%s, \"samples\":%"PRIu32", \"wake_latency_avg_us\":%"PRIu32", \"wake_latency_max_us\":%"PRIu32", "
+                     "\"awake_avg_us\":%"PRIu32", \"est_avg_current_ua\":%"PRIu32", \"est_charge_per_sample_uc\":%"PRIu32"}}",
+                     stats.low_power ? "true" : "false", stats.samples, stats.wake_latency_avg_us, stats.wake_latency_max_us,
+                     stats.awake_avg_us, stats.est_avg_current_ua, stats.est_charge_per_sample_uc);
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strcmp(rcv_cmd, "get stats") == 0) {
+            _send_stats(reply, SERIAL_BUFFER_SIZE, false);
+
+        } else if (strncmp(rcv_cmd, "set stats window ", 17) == 0) {
+            esp_err_t ret = config_comp_set_stats_window(atoi(rcv_cmd + 17));
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to set statistics window. Error: %s", esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_stream_config_json(reply, SERIAL_BUFFER_SIZE);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "sub ", 4) == 0) {
+            char action[8] = "";
+            char name[STREAM_SUB_NAME_LEN + 1] = ""; // One more than allowed, so overlong names are rejected
+            char format_str[8] = "";
+            char channels_str[MAX_COMMAND_LEN] = "all";
+            int divisor = 0;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+            int fields = sscanf(rcv_cmd + 4, "%7s %12s %7s %d %127s", action, name, format_str, &divisor, channels_str);
+            if (strcmp(action, "add") == 0 && fields >= 4) {
+                StreamSubFormat_t format;
+                bool channels[MAX_THERMISTOR_COUNT];
+                ret = serial_subs_format_from_str(format_str, &format);
+                if (ret == ESP_OK) {
+                    ret = _parse_channel_list(channels_str, channels);
                 }
-                esp_err_t send_ret = serial_comp_send(s_serial_buffer);
-                if (send_ret != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+                if (ret == ESP_OK) {
+                    ret = serial_subs_add(name, format, divisor, channels);
                 }
-                
+            } else if (strcmp(action, "remove") == 0 && fields >= 2) {
+                ret = serial_subs_remove(name);
+            } else if ((strcmp(action, "enable") == 0 || strcmp(action, "disable") == 0) && fields >= 2) {
+                ret = serial_subs_set_enabled(name, action[0] == 'e');
+            } else if (strcmp(action, "list") == 0 && fields == 1) {
+                ret = ESP_OK;
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process '%s'. Expected: sub add <name> <json|bin|stats|raw> <divisor> [all|<i,j,...>], sub <remove|enable|disable> <name> or sub list. Error: %s",
+                         rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
             } else {
-                ESP_LOGW(TAG, "Unknown command received: '%s'", rcv_cmd);
+                serial_subs_format_list_json(reply, SERIAL_BUFFER_SIZE);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
             }
 
-        } else {
-            if (config_comp_get_serial_stream_active()) { // xQueueReceive timed out / do periodic tasks
-                _get_and_send_latest_temps_json(s_serial_buffer, SERIAL_BUFFER_SIZE);
-                // if (config_comp_get_log_temps_active()) {
-                //     ESP_LOGI("", "%s", s_serial_buffer);
-                // }                
+        } else if (strcmp(rcv_cmd, "get stream config") == 0) {
+            _format_stream_config_json(reply, SERIAL_BUFFER_SIZE);
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "set alarm rate ", 15) == 0 || strncmp(rcv_cmd, "set alarm ", 10) == 0 ||
+                   strncmp(rcv_cmd, "clear alarm ", 12) == 0) {
+            int index = 0;
+            float low, high, hyst, rate;
+            AlarmConfig_t alarm;
+            esp_err_t ret = ESP_ERR_INVALID_ARG;
+
+            if (sscanf(rcv_cmd, "set alarm rate %d %f", &index, &rate) == 2) {
+                ret = config_comp_get_alarm_config(index - 1, &alarm);
+                alarm.max_rate_c_per_min = rate;
+            } else if (sscanf(rcv_cmd, "set alarm %d %f %f %f", &index, &low, &high, &hyst) == 4) {
+                ret = config_comp_get_alarm_config(index - 1, &alarm);
+                alarm.enabled = true;
+                alarm.low_c = low;
+                alarm.high_c = high;
+                alarm.hysteresis_c = hyst;
+            } else if (sscanf(rcv_cmd, "clear alarm %d", &index) == 1) {
+                memset(&alarm, 0, sizeof(alarm));
+                ret = ESP_OK;
+            }
+            ret = ret == ESP_OK ? config_comp_set_alarm_config(index - 1, &alarm) : ret;
+
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to process alarm command '%s'. Error: %s", rcv_cmd, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_alarm_json(reply, SERIAL_BUFFER_SIZE, index, &alarm);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "get alarm ", 10) == 0) {
+            int index = atoi(rcv_cmd + 10);
+            AlarmConfig_t alarm;
+
+            esp_err_t ret = config_comp_get_alarm_config(index - 1, &alarm);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to get alarm for index %d. Error: %s", index, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_alarm_json(reply, SERIAL_BUFFER_SIZE, index, &alarm);
             }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else if (strncmp(rcv_cmd, "get filter ", 11) == 0) {
+            int index = atoi(rcv_cmd + 11);
+            FilterConfig_t filter;
+
+            esp_err_t ret = config_comp_get_filter_config(index - 1, &filter);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to get filter for index %d. Error: %s", index, esp_err_to_name(ret));
+                snprintf(reply, SERIAL_BUFFER_SIZE, "{\"error\":\"%s\"}", esp_err_to_name(ret));
+            } else {
+                _format_filter_json(reply, SERIAL_BUFFER_SIZE, index, &filter);
+            }
+            esp_err_t send_ret = serial_comp_send(reply);
+            if (send_ret != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to send command processing result over serial.\nError: %s", esp_err_to_name(send_ret));;
+            }
+
+        } else {
+            ESP_LOGW(TAG, "Unknown command received: '%s'", rcv_cmd);
         }
+        serial_pool_put(&s_command_pool, rcv_cmd);
     }
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "serial_pool.h"
+#include "esp_log.h"
+
+static const char *TAG = "serial_pool";
+
+esp_err_t serial_pool_init(SerialPool_t *pool, void *blocks, size_t block_size, int block_count, uint8_t *free_list_storage) {
+    if (pool == NULL || blocks == NULL || free_list_storage == NULL || block_size == 0 || block_count < 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pool->free_list = xQueueCreateStatic(block_count, sizeof(void *), free_list_storage, &pool->free_list_queue);
+    if (pool->free_list == NULL) {
+        ESP_LOGE(TAG, "Failed to create the free list of a %d x %d byte pool", block_count, (int)block_size);
+        return ESP_FAIL;
+    }
+    pool->block_size = block_size;
+    pool->block_count = block_count;
+    pool->min_free = block_count;
+    pool->exhausted = 0;
+    for (int i = 0; i < block_count; ++i) {
+        void *block = (char *)blocks + (size_t)i * block_size;
+        xQueueSend(pool->free_list, &block, 0);
+    }
+    return ESP_OK;
+}
+
+void *serial_pool_get(SerialPool_t *pool, TickType_t timeout) {
+    void *block = NULL;
+    if (xQueueReceive(pool->free_list, &block, timeout) != pdTRUE) {
+        pool->exhausted++;
+        return NULL;
+    }
+    int free_blocks = (int)uxQueueMessagesWaiting(pool->free_list);
+    if (free_blocks < pool->min_free) {
+        pool->min_free = free_blocks; // Approximate under contention, only used for the report
+    }
+    return block;
+}
+
+void serial_pool_put(SerialPool_t *pool, void *block) {
+    if (block != NULL) {
+        xQueueSend(pool->free_list, &block, 0); // Never blocks: the queue holds every block
+    }
+}
+
+int serial_pool_free_count(const SerialPool_t *pool) {
+    return (int)uxQueueMessagesWaiting(pool->free_list);
+}
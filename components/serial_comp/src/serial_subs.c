@@ -0,0 +1,470 @@
+#include "serial_subs.h"
+#include "serial_comp.h"
+#include "temp_json.h"
+#include "temp_stats.h"
+#include "log_comp.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <inttypes.h>
+
+static const char *TAG = "serial_subs";
+
+static const char *const s_format_names[STREAM_SUB_FORMAT_COUNT] = {"json", "bin", "stats", "raw"};
+
+// Subscriptions and their state are only touched by serial_comp_task (commands and cycle snapshots)
+static StreamSub_t s_subs[MAX_STREAM_SUBS];
+static StatsAccumulator_t s_sub_stats[MAX_STREAM_SUBS][MAX_THERMISTOR_COUNT];
+static bool s_fed = false;
+static uint32_t s_fed_cycle = 0;
+
+// Encodings of the current cycle, produced once for every due subscription that needs them
+static char s_value_text[MAX_THERMISTOR_COUNT][TEMP_JSON_VALUE_MAX];
+static uint8_t s_value_text_len[MAX_THERMISTOR_COUNT];
+static int16_t s_value_centi[MAX_THERMISTOR_COUNT];
+static uint8_t s_bin_frame[sizeof(StreamSubRawHeader_t) + MAX_THERMISTOR_COUNT + 1 + MAX_THERMISTOR_COUNT * sizeof(int16_t)];
+
+// Raw format: conversion parameters, fetched at most once per cycle and only when a descriptor is due
+static TempRawDescriptor_t s_raw_descriptor;
+static uint16_t s_cal_chunk[STREAM_SUB_CAL_CHUNK];
+static uint8_t s_cal_frame[sizeof(StreamSubCalHeader_t) + (3 * STREAM_SUB_CAL_CHUNK + 1) / 2];
+
+static StreamSub_t *_find(const char *name) {
+    for (int s = 0; s < MAX_STREAM_SUBS; ++s) {
+        if (s_subs[s].name[0] != '\0' && strcmp(s_subs[s].name, name) == 0) {
+            return &s_subs[s];
+        }
+    }
+    return NULL;
+}
+
+// Names end up verbatim in JSON frames: letters, digits, '_' and '-' only
+static bool _valid_name(const char *name) {
+    size_t len = strlen(name);
+    if (len == 0 || len >= STREAM_SUB_NAME_LEN) {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '-') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void _prime(int s) {
+    s_subs[s].primed = false;
+    s_subs[s].described = false; // A host joining at the enable gets the conversion parameters again
+    s_subs[s].aggregated = 0;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        temp_stats_reset(&s_sub_stats[s][i]);
+    }
+}
+
+esp_err_t serial_subs_add(const char *name, StreamSubFormat_t format, int divisor, const bool *channels) {
+    if (name == NULL || !_valid_name(name) || format < 0 || format >= STREAM_SUB_FORMAT_COUNT ||
+        divisor < 1 || divisor > STREAM_SUB_MAX_DIVISOR) {
+        ESP_LOGE(TAG, "Invalid subscription: name must be 1..%d chars of [A-Za-z0-9_-], divisor 1..%d",
+                 STREAM_SUB_NAME_LEN - 1, STREAM_SUB_MAX_DIVISOR);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (_find(name) != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (int s = 0; s < MAX_STREAM_SUBS; ++s) {
+        StreamSub_t *sub = &s_subs[s];
+        if (sub->name[0] != '\0') {
+            continue;
+        }
+        memset(sub, 0, sizeof(*sub));
+        strncpy(sub->name, name, sizeof(sub->name) - 1);
+        sub->format = format;
+        sub->divisor = divisor;
+        sub->enabled = true;
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            sub->channels[i] = channels == NULL || channels[i];
+        }
+        _prime(s);
+        ESP_LOGI(TAG, "Subscription %d '%s' added: %s every %d cycles", s + 1, name, s_format_names[format], divisor);
+        return ESP_OK;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t serial_subs_remove(const char *name) {
+    StreamSub_t *sub = _find(name);
+    if (sub == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    sub->name[0] = '\0';
+    sub->enabled = false;
+    ESP_LOGI(TAG, "Subscription '%s' removed", name);
+    return ESP_OK;
+}
+
+esp_err_t serial_subs_set_enabled(const char *name, bool enabled) {
+    StreamSub_t *sub = _find(name);
+    if (sub == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (enabled && !sub->enabled) {
+        _prime(sub - s_subs); // A stats window never spans the disabled period
+    }
+    sub->enabled = enabled;
+    return ESP_OK;
+}
+
+bool serial_subs_any_enabled(void) {
+    for (int s = 0; s < MAX_STREAM_SUBS; ++s) {
+        if (s_subs[s].name[0] != '\0' && s_subs[s].enabled) {
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t serial_subs_format_from_str(const char *str, StreamSubFormat_t *format) {
+    for (int f = 0; f < STREAM_SUB_FORMAT_COUNT; ++f) {
+        if (strcmp(str, s_format_names[f]) == 0) {
+            *format = (StreamSubFormat_t)f;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+static bool _append(char *buffer, size_t buffer_size, size_t *len, const char *src, size_t n) {
+    if (*len + n >= buffer_size) {
+        return false;
+    }
+    memcpy(buffer + *len, src, n);
+    *len += n;
+    buffer[*len] = '\0';
+    return true;
+}
+
+static bool _appendf(char *buffer, size_t buffer_size, size_t *len, const char *fmt, ...) __attribute__((format(printf, 4, 5)));
+static bool _appendf(char *buffer, size_t buffer_size, size_t *len, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf(buffer + *len, buffer_size - *len, fmt, args);
+    va_end(args);
+    if (written < 0 || written >= buffer_size - *len) {
+        return false;
+    }
+    *len += written;
+    return true;
+}
+
+static bool _append_names(char *buffer, size_t buffer_size, size_t *len, const TemperatureOutputData_t *snapshot, const bool *mask) {
+    if (!_append(buffer, buffer_size, len, "\"names\":[", 9)) return false;
+    bool first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!mask[i]) continue;
+        if (!_appendf(buffer, buffer_size, len, "%s\"%s\"", first ? "" : ",", snapshot->thermistor_names[i])) return false;
+        first = false;
+    }
+    return _append(buffer, buffer_size, len, "]", 1);
+}
+
+static bool _build_json(const StreamSub_t *sub, const TemperatureOutputData_t *snapshot, const bool *mask,
+                        char *buffer, size_t buffer_size) {
+    size_t len = 0;
+    if (!_appendf(buffer, buffer_size, &len, "{\"sub\":\"%s\",", sub->name)) return false;
+    if (!_append_names(buffer, buffer_size, &len, snapshot, mask)) return false;
+    if (!_append(buffer, buffer_size, &len, ",\"temperatures\":[", 17)) return false;
+    bool first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!mask[i]) continue;
+        if (!first && !_append(buffer, buffer_size, &len, ",", 1)) return false;
+        if (!_append(buffer, buffer_size, &len, s_value_text[i], s_value_text_len[i])) return false;
+        first = false;
+    }
+    return _append(buffer, buffer_size, &len, "]}", 2);
+}
+
+// "$<type>" + base64 of frame
+static bool _encode_frame(char type, const uint8_t *frame, size_t frame_len, char *buffer, size_t buffer_size) {
+    if (4 * ((frame_len + 2) / 3) + 3 > buffer_size) {
+        return false;
+    }
+    buffer[0] = '$';
+    buffer[1] = type;
+    log_comp_base64_encode(frame, frame_len, buffer + 2);
+    return true;
+}
+
+// Header and 1-based index list shared by "$T" and "$R" frames; header_len leaves room for the "$R"
+// generation after the common header. Returns the offset of the values.
+static size_t _put_bin_header(const StreamSub_t *sub, int sub_id, uint32_t cycle, size_t header_len, const bool *mask, int *count) {
+    StreamSubBinHeader_t header = {.sub_id = (uint8_t)sub_id, .count = 0, .seq = sub->seq, .cycle = cycle};
+    uint8_t *indices = s_bin_frame + header_len;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (mask[i]) indices[header.count++] = (uint8_t)(i + 1);
+    }
+    indices[header.count] = 0;
+    memcpy(s_bin_frame, &header, sizeof(header));
+    *count = header.count;
+    return header_len + header.count + (header.count & 1); // Keeps int16 values 2-byte aligned for the host
+}
+
+static bool _build_bin(const StreamSub_t *sub, int sub_id, uint32_t cycle, const bool *mask, char *buffer, size_t buffer_size) {
+    int count;
+    size_t frame_len = _put_bin_header(sub, sub_id, cycle, sizeof(StreamSubBinHeader_t), mask, &count);
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!mask[i]) continue;
+        memcpy(s_bin_frame + frame_len, &s_value_centi[i], sizeof(int16_t)); // Little-endian like the host decoder
+        frame_len += sizeof(int16_t);
+    }
+    return _encode_frame('T', s_bin_frame, frame_len, buffer, buffer_size);
+}
+
+// The codes go out as converted, 1.5 bytes each: no float math or formatting on the device
+static bool _build_raw(const StreamSub_t *sub, int sub_id, const TemperatureOutputData_t *snapshot, const bool *mask,
+                       char *buffer, size_t buffer_size) {
+    int count;
+    size_t frame_len = _put_bin_header(sub, sub_id, snapshot->cycle, sizeof(StreamSubRawHeader_t), mask, &count);
+    uint32_t generation = snapshot->conversion_generation;
+    memcpy(s_bin_frame + offsetof(StreamSubRawHeader_t, generation), &generation, sizeof(generation));
+    uint16_t codes[MAX_THERMISTOR_COUNT];
+    for (int i = 0, n = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (mask[i]) codes[n++] = snapshot->raw_codes[i];
+    }
+    frame_len += temp_burst_pack12(codes, count, s_bin_frame + frame_len);
+    return _encode_frame('R', s_bin_frame, frame_len, buffer, buffer_size);
+}
+
+static bool _send_line(const StreamSub_t *sub, const char *buffer) {
+    esp_err_t ret = serial_comp_send(buffer);
+    if (ret != ESP_OK) {
+        LOGE_RL(TAG, "Failed to send descriptor of subscription '%s': %s", sub->name, esp_err_to_name(ret));
+    }
+    return ret == ESP_OK;
+}
+
+static bool _send_raw_channel(const StreamSub_t *sub, int i, const char *name, char *buffer, size_t buffer_size) {
+    const TempRawChannel_t *channel = &s_raw_descriptor.channels[i];
+    size_t len = 0;
+    if (!_appendf(buffer, buffer_size, &len, "{\"sub\":\"%s\",\"raw_channel\":{\"index\":%d,\"name\":\"%s\",\"unit\":%d,"
+                  "\"divider_r\":%d,\"cal_r\":%d,", sub->name, i + 1, name, channel->adc_unit + 1, channel->divider_r,
+                  channel->calibration_offset)) return false;
+    bool ok = channel->model.type == THERM_MODEL_BETA
+            ? _appendf(buffer, buffer_size, &len, "\"model\":{\"type\":\"beta\",\"beta\":%.2f,\"r25\":%.2f},",
+                       channel->model.beta, channel->model.r25)
+            : _appendf(buffer, buffer_size, &len, "\"model\":{\"type\":\"sh\",\"a\":%.7e,\"b\":%.7e,\"c\":%.7e},",
+                       channel->model.a, channel->model.b, channel->model.c);
+    // k holds the coefficients the firmware actually evaluates, at full float precision
+    if (!ok || !_appendf(buffer, buffer_size, &len, "\"k\":[%.9e,%.9e,%.9e]}}", channel->conversion.k0,
+                         channel->conversion.k1, channel->conversion.k3)) return false;
+    return _send_line(sub, buffer);
+}
+
+static bool _send_cal_table(const StreamSub_t *sub, int unit, char *buffer, size_t buffer_size) {
+    uint32_t offset = 0;
+    uint32_t count;
+    while ((count = temp_comp_get_adc_cal_mv(unit, offset, s_cal_chunk, STREAM_SUB_CAL_CHUNK)) > 0) {
+        StreamSubCalHeader_t header = {.unit = (uint8_t)(unit + 1), .reserved = 0, .offset = (uint16_t)offset, .count = (uint16_t)count};
+        memcpy(s_cal_frame, &header, sizeof(header));
+        size_t frame_len = sizeof(header) + temp_burst_pack12(s_cal_chunk, count, s_cal_frame + sizeof(header)); // mV < 4096
+        if (!_encode_frame('C', s_cal_frame, frame_len, buffer, buffer_size) || !_send_line(sub, buffer)) {
+            return false;
+        }
+        offset += count;
+    }
+    return true;
+}
+
+// Header line, one line per channel, then the calibration tables of the units in use
+static bool _send_raw_descriptor(const StreamSub_t *sub, const TemperatureOutputData_t *snapshot, const bool *mask,
+                                 char *buffer, size_t buffer_size) {
+    bool units[ADC_UNIT_COUNT] = {false};
+    size_t len = 0;
+    if (!_appendf(buffer, buffer_size, &len, "{\"sub\":\"%s\",\"raw_descriptor\":{\"id\":%d,\"generation\":%"PRIu32","
+                  "\"max_code\":%d,\"channels\":[", sub->name, (int)(sub - s_subs) + 1,
+                  s_raw_descriptor.generation, s_raw_descriptor.max_code)) return false;
+    bool first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!mask[i]) continue;
+        int unit = s_raw_descriptor.channels[i].adc_unit;
+        if (unit >= 0 && unit < ADC_UNIT_COUNT && s_raw_descriptor.adc_calibrated[unit]) units[unit] = true;
+        if (!_appendf(buffer, buffer_size, &len, "%s%d", first ? "" : ",", i + 1)) return false;
+        first = false;
+    }
+    if (!_append(buffer, buffer_size, &len, "],\"adc_cal\":[", 13)) return false;
+    first = true;
+    for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+        if (!units[unit]) continue;
+        if (!_appendf(buffer, buffer_size, &len, "%s%d", first ? "" : ",", unit + 1)) return false;
+        first = false;
+    }
+    if (!_append(buffer, buffer_size, &len, "]}}", 3) || !_send_line(sub, buffer)) return false;
+
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (mask[i] && !_send_raw_channel(sub, i, snapshot->thermistor_names[i], buffer, buffer_size)) return false;
+    }
+    for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+        if (units[unit] && !_send_cal_table(sub, unit, buffer, buffer_size)) return false;
+    }
+    return true;
+}
+
+static bool _build_stats(int s, const TemperatureOutputData_t *snapshot, const bool *mask, char *buffer, size_t buffer_size) {
+    const StreamSub_t *sub = &s_subs[s];
+    ChannelStats_t stats[MAX_THERMISTOR_COUNT];
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (mask[i]) temp_stats_summarize(&s_sub_stats[s][i], &stats[i]);
+    }
+    size_t len = 0;
+    if (!_appendf(buffer, buffer_size, &len, "{\"sub\":\"%s\",\"stats\":{\"window\":%u,\"samples\":%"PRIu32",",
+                  sub->name, (unsigned)sub->seq, sub->aggregated)) return false;
+    if (!_append_names(buffer, buffer_size, &len, snapshot, mask)) return false;
+    static const char *const keys[] = {"count", "min", "max", "mean", "stddev"};
+    for (int k = 0; k < 5; ++k) {
+        if (!_appendf(buffer, buffer_size, &len, ",\"%s\":[", keys[k])) return false;
+        bool first = true;
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            if (!mask[i]) continue;
+            const ChannelStats_t *st = &stats[i];
+            bool ok = k == 0 ? _appendf(buffer, buffer_size, &len, "%s%"PRIu32, first ? "" : ",", st->count)
+                             : _appendf(buffer, buffer_size, &len, "%s%.2f", first ? "" : ",",
+                                        k == 1 ? st->min : k == 2 ? st->max : k == 3 ? st->mean : st->stddev);
+            if (!ok) return false;
+            first = false;
+        }
+        if (!_append(buffer, buffer_size, &len, "]", 1)) return false;
+    }
+    return _append(buffer, buffer_size, &len, "}}", 2);
+}
+
+static int16_t _to_centi(float value) {
+    if (!isfinite(value) || value <= INT16_MIN / 100.0f || value >= INT16_MAX / 100.0f) {
+        return STREAM_SUB_BIN_NAN;
+    }
+    return (int16_t)lroundf(value * 100.0f);
+}
+
+void serial_subs_feed(const TemperatureOutputData_t *snapshot, char *buffer, size_t buffer_size) {
+    if (s_fed && snapshot->cycle == s_fed_cycle) {
+        return; // Same cycle as last time: nothing new to aggregate or send
+    }
+    s_fed = true;
+    s_fed_cycle = snapshot->cycle;
+
+    bool due[MAX_STREAM_SUBS] = {false};
+    bool need_text[MAX_THERMISTOR_COUNT] = {false};
+    bool need_centi[MAX_THERMISTOR_COUNT] = {false};
+    for (int s = 0; s < MAX_STREAM_SUBS; ++s) {
+        StreamSub_t *sub = &s_subs[s];
+        if (sub->name[0] == '\0' || !sub->enabled) {
+            continue;
+        }
+        if (!sub->primed) {
+            sub->primed = true;
+            sub->last_cycle = snapshot->cycle;
+            continue;
+        }
+        if (sub->format == STREAM_SUB_STATS) {
+            for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+                if (!sub->channels[i] || snapshot->thermistor_names[i][0] == '\0') continue;
+                temp_stats_add(&s_sub_stats[s][i], snapshot->temperatures[i]);
+            }
+            sub->aggregated++;
+        }
+        due[s] = snapshot->cycle - sub->last_cycle >= (uint32_t)sub->divisor;
+        if (!due[s]) {
+            continue;
+        }
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            if (!sub->channels[i] || snapshot->thermistor_names[i][0] == '\0') continue;
+            need_text[i] |= sub->format == STREAM_SUB_JSON;
+            need_centi[i] |= sub->format == STREAM_SUB_BIN;
+        }
+    }
+
+    // One conversion per channel and cycle, shared by every subscription that sends it (raw ones need none)
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (need_text[i]) s_value_text_len[i] = (uint8_t)temp_json_format_centi(snapshot->temperatures[i], s_value_text[i]);
+        if (need_centi[i]) s_value_centi[i] = _to_centi(snapshot->temperatures[i]);
+    }
+
+    bool have_descriptor = false;
+    for (int s = 0; s < MAX_STREAM_SUBS; ++s) {
+        if (!due[s]) {
+            continue;
+        }
+        StreamSub_t *sub = &s_subs[s];
+        bool mask[MAX_THERMISTOR_COUNT];
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            mask[i] = sub->channels[i] && snapshot->thermistor_names[i][0] != '\0';
+        }
+        if (sub->format == STREAM_SUB_RAW && (!sub->described || sub->described_generation != snapshot->conversion_generation)) {
+            if (!have_descriptor) {
+                have_descriptor = temp_comp_get_raw_descriptor(&s_raw_descriptor) == ESP_OK;
+            }
+            // Frames still go out without it: the host can store them and convert once a descriptor arrives
+            if (have_descriptor && _send_raw_descriptor(sub, snapshot, mask, buffer, buffer_size)) {
+                sub->described = true;
+                sub->described_generation = s_raw_descriptor.generation;
+            } else {
+                LOGE_RL(TAG, "Descriptor of subscription '%s' not sent, retrying with its next frame", sub->name);
+            }
+        }
+        bool built = sub->format == STREAM_SUB_JSON ? _build_json(sub, snapshot, mask, buffer, buffer_size)
+                   : sub->format == STREAM_SUB_BIN  ? _build_bin(sub, s + 1, snapshot->cycle, mask, buffer, buffer_size)
+                   : sub->format == STREAM_SUB_RAW  ? _build_raw(sub, s + 1, snapshot, mask, buffer, buffer_size)
+                                                    : _build_stats(s, snapshot, mask, buffer, buffer_size);
+        if (sub->format == STREAM_SUB_STATS) {
+            for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+                temp_stats_reset(&s_sub_stats[s][i]);
+            }
+            sub->aggregated = 0;
+        }
+        sub->last_cycle = snapshot->cycle;
+        sub->seq++;
+        if (!built) {
+            LOGE_RL(TAG, "Frame of subscription '%s' does not fit the buffer", sub->name);
+            continue;
+        }
+        esp_err_t ret = serial_comp_send(buffer);
+        if (ret != ESP_OK) {
+            LOGE_RL(TAG, "Failed to send frame of subscription '%s': %s", sub->name, esp_err_to_name(ret));
+        }
+    }
+}
+
+esp_err_t serial_subs_format_list_json(char *buffer, size_t buffer_size) {
+    size_t len = 0;
+    if (!_append(buffer, buffer_size, &len, "{\"subs\":[", 9)) goto fail_buffer_too_small;
+    bool first = true;
+    for (int s = 0; s < MAX_STREAM_SUBS; ++s) {
+        const StreamSub_t *sub = &s_subs[s];
+        if (sub->name[0] == '\0') continue;
+        if (!_appendf(buffer, buffer_size, &len, "%s{\"id\":%d, \"name\":\"%s\", \"format\":\"%s\", \"divisor\":%d, \"enabled\":%s, \"channels\":[",
+                      first ? "" : ",", s + 1, sub->name, s_format_names[sub->format], sub->divisor, sub->enabled ? "true" : "false")) {
+            goto fail_buffer_too_small;
+        }
+        bool first_channel = true;
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            if (!sub->channels[i]) continue;
+            if (!_appendf(buffer, buffer_size, &len, "%s%d", first_channel ? "" : ",", i + 1)) goto fail_buffer_too_small;
+            first_channel = false;
+        }
+        if (!_append(buffer, buffer_size, &len, "]}", 2)) goto fail_buffer_too_small;
+        first = false;
+    }
+    if (!_append(buffer, buffer_size, &len, "]}", 2)) goto fail_buffer_too_small;
+    return ESP_OK;
+
+    fail_buffer_too_small:
+        ESP_LOGE(TAG, "Buffer too small for subscription list");
+        buffer[0] = '\0';
+        return ESP_ERR_NO_MEM;
+}
+
+size_t serial_subs_get_static_ram_bytes(void) {
+    return sizeof(s_subs) + sizeof(s_sub_stats) + sizeof(s_value_text) + sizeof(s_value_text_len) +
+           sizeof(s_value_centi) + sizeof(s_bin_frame) + sizeof(s_raw_descriptor) + sizeof(s_cal_chunk) + sizeof(s_cal_frame);
+}
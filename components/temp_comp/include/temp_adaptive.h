@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config_comp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADAPTIVE_EW_ALPHA   0.2f    // Weight of the new sample in the short-term mean/variance
+#define ADAPTIVE_RATE_TAU_S 5.0f    // Time constant of the signed dT/dt average (independent of the interval)
+
+typedef enum {
+    ADAPTIVE_HOLD = 0,      // Inside the hysteresis band: keep the interval
+    ADAPTIVE_ACTIVE,        // Above a threshold: sample fast
+    ADAPTIVE_CALM,          // Below threshold * hysteresis
+} AdaptiveActivity_t;
+
+/**
+ * @brief Short-term dynamics of one channel: smoothed dT/dt and exponentially weighted variance.
+ */
+typedef struct {
+    bool    has_previous;
+    float   previous_temp;
+    int64_t previous_time_us;
+    float   rate_c_per_min;         // Smoothed signed dT/dt: sample noise cancels, a trend does not
+    float   ew_mean;
+    float   ew_var;
+} AdaptiveChannel_t;
+
+/**
+ * @brief Interval controller shared by all channels.
+ */
+typedef struct {
+    int interval_ms;
+    int calm_streak;
+} AdaptiveState_t;
+
+void temp_adaptive_reset_channel(AdaptiveChannel_t *channel);
+
+/**
+ * @brief Feed a sample and classify the channel's activity.
+ *
+ * Non-finite samples break the history and count as calm.
+ */
+AdaptiveActivity_t temp_adaptive_observe(AdaptiveChannel_t *channel, const AdaptiveConfig_t *config,
+                                         float temp, int64_t time_us);
+
+/**
+ * @brief Combine the activity of all channels (any active wins, calm only if all are calm).
+ */
+static inline AdaptiveActivity_t temp_adaptive_combine(AdaptiveActivity_t a, AdaptiveActivity_t b) {
+    if (a == ADAPTIVE_ACTIVE || b == ADAPTIVE_ACTIVE) return ADAPTIVE_ACTIVE;
+    if (a == ADAPTIVE_HOLD || b == ADAPTIVE_HOLD) return ADAPTIVE_HOLD;
+    return ADAPTIVE_CALM;
+}
+
+/**
+ * @brief Apply one cycle's combined activity: jump to the minimum interval on activity,
+ * double toward the maximum after calm_cycles calm cycles.
+ *
+ * @return The interval for the next cycle (ms).
+ */
+int temp_adaptive_next_interval(AdaptiveState_t *state, const AdaptiveConfig_t *config, AdaptiveActivity_t activity);
+
+#ifdef __cplusplus
+}
+#endif
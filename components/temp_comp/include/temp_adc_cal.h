@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_adc/adc_oneshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADC_CAL_TABLE_SIZE  4096    // One entry per code of a 12-bit conversion
+
+// Calibrated raw code → mV response of one ADC unit at one attenuation.
+// Built once from the eFuse curve-fitting scheme so conversion is a single lookup per sample.
+typedef struct {
+    bool        valid;              // false: no eFuse calibration, callers fall back to the raw ratio
+    adc_unit_t  unit;
+    adc_atten_t atten;
+    int         max_code;
+    uint16_t    mv[ADC_CAL_TABLE_SIZE];
+} AdcCalTable_t;
+
+/**
+ * @brief Build the raw → mV table with the adc_cali curve-fitting scheme.
+ *
+ * The calibration handle is only needed while the table is filled and is deleted afterwards.
+ *
+ * @param table    Output table; table->valid tells whether it can be used.
+ * @param unit     ADC unit the codes come from.
+ * @param atten    Attenuation the channels are configured with.
+ * @param bitwidth Conversion width (at most 12 bits).
+ * @param max_code Largest code of that width.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_NOT_SUPPORTED if the chip has no calibration scheme or its eFuses are not burnt
+ *      - other errors from the calibration driver
+ */
+esp_err_t temp_adc_cal_build(AdcCalTable_t *table, adc_unit_t unit, adc_atten_t atten, adc_bitwidth_t bitwidth, int max_code);
+
+/**
+ * @brief Calibrated voltage of a raw code (table must be valid, 0 <= raw <= max_code).
+ */
+static inline int temp_adc_cal_to_mv(const AdcCalTable_t *table, int raw) {
+    return table->mv[raw];
+}
+
+#ifdef __cplusplus
+}
+#endif
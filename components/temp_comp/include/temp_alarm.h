@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config_comp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEMP_ALARM_TYPE_COUNT 3
+
+typedef enum {
+    TEMP_ALARM_HIGH = 0,
+    TEMP_ALARM_LOW,
+    TEMP_ALARM_RATE,
+} TempAlarmType_t;
+
+/**
+ * @brief An alarm transition (raised or cleared) on one channel.
+ */
+typedef struct {
+    int             index;      // 0-based thermistor index
+    TempAlarmType_t type;
+    bool            raised;     // true: alarm raised, false: alarm cleared
+    float           value;      // Temperature (C) for HIGH/LOW, dT/dt (C/min) for RATE
+} TempAlarmEvent_t;
+
+/**
+ * @brief Per-channel alarm state: active flags plus the previous sample for dT/dt.
+ */
+typedef struct {
+    bool    active[TEMP_ALARM_TYPE_COUNT];
+    bool    has_previous;
+    float   previous_temp;
+    int64_t previous_time_us;
+} AlarmState_t;
+
+/**
+ * @brief Clear all active alarms and the dT/dt history of a channel.
+ *
+ * @param state Alarm state to reset.
+ */
+void temp_alarm_reset(AlarmState_t *state);
+
+/**
+ * @brief Evaluate a channel's alarm rules against a new sample.
+ *
+ * Only transitions are reported: a rule that stays raised produces no further events.
+ * Non-finite samples are ignored and break the dT/dt history.
+ *
+ * @param state   Alarm state of the channel.
+ * @param config  Alarm rules of the channel.
+ * @param index   0-based thermistor index, copied into the events.
+ * @param temp    New temperature (C).
+ * @param time_us Sample timestamp (us, monotonic).
+ * @param events  Output array with room for TEMP_ALARM_TYPE_COUNT events.
+ * @return Number of events written.
+ */
+int temp_alarm_evaluate(AlarmState_t *state, const AlarmConfig_t *config, int index,
+                        float temp, int64_t time_us, TempAlarmEvent_t *events);
+
+/**
+ * @brief Short lowercase name of an alarm type ("high", "low", "rate").
+ */
+const char *temp_alarm_type_to_str(TempAlarmType_t type);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    BURST_IDLE = 0,         // Nothing captured
+    BURST_ARMED,            // Filling the ring, waiting for the trigger
+    BURST_TRIGGERED,        // Trigger seen, filling the post-trigger samples
+    BURST_DONE,             // Capture frozen, readable until the next arm/stop
+} BurstState_t;
+
+// Trigger edge in raw code terms (the caller maps a temperature edge onto it)
+typedef enum {
+    BURST_EDGE_NONE = 0,    // Command trigger only
+    BURST_EDGE_UP,          // Code moves from below level_code to level_code or above
+    BURST_EDGE_DOWN,        // Code moves from level_code or above to below it
+} BurstEdge_t;
+
+/**
+ * @brief Pre-trigger capture over a caller-owned ring of raw codes.
+ *
+ * Samples are pushed continuously while armed. The trigger sample is the first post-trigger sample,
+ * so a frozen capture holds up to `pre` samples before it and exactly `post` from it on.
+ */
+typedef struct {
+    uint16_t    *codes;
+    uint32_t     capacity;
+    uint32_t     head;              // Next write position
+    uint32_t     filled;            // Valid samples in the ring, saturates at capacity
+    uint32_t     since_gap;         // Samples since the last temp_burst_note_gap(), saturating
+    uint32_t     pre;
+    uint32_t     post;
+    BurstEdge_t  edge;
+    int          level_code;
+    int          previous_code;     // -1: none yet
+    volatile BurstState_t state;    // Read by other tasks
+    bool         manual;            // Fired by temp_burst_push(..., true)
+    uint32_t     trigger_pos;       // Ring position of the trigger sample
+    uint32_t     pre_count;         // Pre-trigger samples actually captured (<= pre)
+    uint32_t     post_remaining;
+    uint32_t     gap_free;          // Frozen: samples at the end of the capture without a gap
+} BurstCapture_t;
+
+/**
+ * @brief Attach the ring storage and reset to BURST_IDLE.
+ */
+void temp_burst_init(BurstCapture_t *burst, uint16_t *codes, uint32_t capacity);
+
+/**
+ * @brief Start a new capture: empties the ring and moves to BURST_ARMED.
+ *
+ * An edge trigger only fires once `pre` samples are in the ring; a command trigger fires at once.
+ *
+ * @return ESP_ERR_INVALID_ARG if post is 0 or pre + post exceeds the capacity.
+ */
+esp_err_t temp_burst_arm(BurstCapture_t *burst, uint32_t pre, uint32_t post, BurstEdge_t edge, int level_code);
+
+/**
+ * @brief Store one sample and advance the state machine.
+ *
+ * @param force_trigger Command trigger: fires on this sample if still armed.
+ * @return true if this sample completed the capture (state is now BURST_DONE).
+ */
+bool temp_burst_push(BurstCapture_t *burst, uint16_t code, bool force_trigger);
+
+/**
+ * @brief The sampler paused (e.g. yielded to the scheduler) before the next sample.
+ */
+void temp_burst_note_gap(BurstCapture_t *burst);
+
+/**
+ * @brief Samples in the frozen capture (pre_count + post), 0 unless BURST_DONE.
+ */
+uint32_t temp_burst_length(const BurstCapture_t *burst);
+
+/**
+ * @brief Copy frozen samples in chronological order, starting at offset.
+ *
+ * @return Number of samples copied (0 past the end or unless BURST_DONE).
+ */
+uint32_t temp_burst_read(const BurstCapture_t *burst, uint32_t offset, uint16_t *out, uint32_t max);
+
+/**
+ * @brief Pack 12-bit codes two per three bytes (little-endian nibble order), an odd last code takes two bytes.
+ *
+ * out must hold (3 * count + 1) / 2 bytes.
+ *
+ * @return Bytes written.
+ */
+size_t temp_burst_pack12(const uint16_t *codes, size_t count, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
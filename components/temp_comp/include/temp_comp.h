@@ -3,16 +3,101 @@
 #include "esp_err.h"
 #include <stdbool.h>
 #include "config_comp.h"
+#include "temp_alarm.h"
+#include "temp_stats.h"
+#include "temp_model.h"
+#include "temp_health.h"
+#include "temp_burst.h"
+#include "temp_noise.h"
+
+#define TEMP_MEASUREMENT_STACK_SIZE 4096
+#define TEMP_MEASUREMENT_CORE       0       // ADC1 conversions, control loop
+#define TEMP_ADC_WORKER_STACK_SIZE  3072
+#define TEMP_ADC_WORKER_PRIORITY    5       // Same as the measurement task, it only runs while that one waits
+#define TEMP_ADC_WORKER_CORE        1       // ADC2 conversions, in parallel with ADC1
+#define TEMP_BURST_STACK_SIZE       3072
+#define TEMP_BURST_PRIORITY         1       // Just above idle: it spins on the ADC while armed
+#define TEMP_BURST_CORE             1       // Away from the measurement task
+#define TEMP_BURST_INTERNAL_SAMPLES 8192    // Static ring without PSRAM (16 KB)
+#define TEMP_BURST_PSRAM_SAMPLES    (256 * 1024) // Ring allocated from PSRAM once at startup when it is enabled (512 KB)
+#define TEMP_BURST_YIELD_US         100000  // Longest stretch the sampler spins before giving the idle task a tick
+#define TEMP_RAW_CODE_NONE          0x0FFF  // No conversion of the channel this cycle; the top code is out of range anyway
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct {
-    char thermistor_names[MAX_THERMISTOR_COUNT][10];
+    char thermistor_names[MAX_THERMISTOR_COUNT][10];    // Empty string for unused slots
     float temperatures[MAX_THERMISTOR_COUNT];
+    ChannelHealth_t health[MAX_THERMISTOR_COUNT];
+    uint16_t raw_codes[MAX_THERMISTOR_COUNT];           // ADC codes converted in this cycle, TEMP_RAW_CODE_NONE if none
+    uint32_t conversion_generation;                     // Changes whenever a TempRawDescriptor_t input changes
+    uint32_t cycle;                                     // Completed measurement cycles: tells pollers whether the values are new
 } TemperatureOutputData_t;
 
+typedef struct {
+    int               adc_unit;                         // 0-based
+    int               divider_r;                        // Ohm
+    int               calibration_offset;               // Ohm, added to the divider resistance
+    ThermistorModel_t model;
+    ConversionState_t conversion;                       // What the firmware evaluates: 1/T = k0 + k1 ln(R) + k3 ln(R)^3
+} TempRawChannel_t;
+
+/**
+ * @brief Everything needed to turn raw codes into temperatures off the device, exactly as temp_comp does.
+ *
+ * code -> R: divider_r * v / (full - v) + calibration_offset, with v the code (full = max_code) or, on a
+ * calibrated unit, the unit's mV table entry (full = entry of max_code). Codes 0 and >= max_code are invalid.
+ */
+typedef struct {
+    uint32_t         generation;                        // Same counter as TemperatureOutputData_t.conversion_generation
+    int              max_code;
+    bool             adc_calibrated[ADC_UNIT_COUNT];    // temp_comp_get_adc_cal_mv() has a table for the unit
+    TempRawChannel_t channels[MAX_THERMISTOR_COUNT];
+} TempRawDescriptor_t;
+
+typedef struct {
+    uint32_t window_seq;                                // Sequence number of the completed window, 0: none yet
+    int      window_samples;                            // Window length in measurement cycles
+    char thermistor_names[MAX_THERMISTOR_COUNT][10];    // Empty string for unused slots
+    ChannelStats_t stats[MAX_THERMISTOR_COUNT];
+} TemperatureStatsData_t;
+
+typedef void (*temp_alarm_callback_t)(const TempAlarmEvent_t *event);
+
+typedef struct {
+    int         interval_ms;                            // New effective sampling interval
+    int         previous_interval_ms;
+    const char *reason;                                 // "activity", "calm" or "config"
+} TempRateEvent_t;
+
+typedef void (*temp_rate_callback_t)(const TempRateEvent_t *event);
+
+typedef void (*temp_cycle_callback_t)(const TemperatureOutputData_t *snapshot);
+
+typedef enum {
+    TEMP_BURST_TRIGGER_COMMAND = 0,     // Only temp_comp_burst_trigger()
+    TEMP_BURST_TRIGGER_RISE,            // Temperature rises through level_c (or the command)
+    TEMP_BURST_TRIGGER_FALL,            // Temperature falls through level_c (or the command)
+} TempBurstTrigger_t;
+
+typedef struct {
+    BurstState_t       state;
+    int                index;           // 0-based thermistor, -1 before the first arm
+    uint16_t           capture_id;      // Incremented on every arm, carried by the dump frames
+    uint32_t           capacity;        // Ring size in samples, 0: no buffer
+    uint32_t           pre;             // Requested pre-trigger samples
+    uint32_t           post;            // Requested samples from the trigger on
+    TempBurstTrigger_t trigger;
+    float              level_c;
+    bool               manual;          // Fired by the command rather than the level
+    uint32_t           samples;         // BURST_DONE: capture length, otherwise samples in the ring
+    uint32_t           trigger_offset;  // BURST_DONE: offset of the trigger sample in the capture
+    uint32_t           gap_free_from;   // BURST_DONE: offset from which no scheduler pause interrupts the samples
+    uint32_t           period_ns;       // BURST_DONE: mean sample spacing over that gap-free part
+} TempBurstStatus_t;
+
 // typedef struct {
 //     TemperatureData_t temperature_data[MAX_THERMISTOR_COUNT]; //MAX_THERMISTOR_COUNT defined in config_comp.h
 // } MeasurementData_t;
@@ -51,10 +136,220 @@ void temp_comp_measurement_task(void *arg);
  */
 esp_err_t temp_comp_get_latest_temps_json(char *buffer, size_t buffer_size);
 
+/**
+ * @brief Get a consistent copy of the latest temperature readings.
+ *
+ * Slots of unused thermistors get an empty name, so callers do not need to know about
+ * the "UNUSED" naming convention.
+ *
+ * @param out Pointer to the structure to fill.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if out is NULL
+ */
+esp_err_t temp_comp_get_latest_temps(TemperatureOutputData_t *out);
+
+/**
+ * @brief Get the conversion parameters of every slot, for host-side conversion of raw codes.
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if out is NULL
+ */
+esp_err_t temp_comp_get_raw_descriptor(TempRawDescriptor_t *out);
+
+/**
+ * @brief Copy part of an ADC unit's calibrated code -> mV table.
+ *
+ * @param unit   0-based ADC unit.
+ * @param offset First code.
+ * @return Entries copied, 0 past max_code or if the unit is not calibrated.
+ */
+uint32_t temp_comp_get_adc_cal_mv(int unit, uint32_t offset, uint16_t *mv, uint32_t max);
+
+/**
+ * @brief Get the aggregate statistics (min/max/mean/stddev) of the last completed window.
+ *
+ * Windows are tumbling and counted in measurement cycles (see config_comp_set_stats_window).
+ * Poll window_seq to detect when a new window has completed.
+ *
+ * @param out Pointer to the structure to fill.
+ * @return
+ *      - ESP_OK on success (window_seq is 0 until the first window completes)
+ *      - ESP_ERR_INVALID_ARG if out is NULL
+ */
+esp_err_t temp_comp_get_stats(TemperatureStatsData_t *out);
+
+/**
+ * @brief Register the callback invoked on every alarm transition.
+ *
+ * The callback runs in the measurement task, right after the conversion that caused the
+ * transition, so it must hand the event off without blocking (e.g. post it to a queue with a
+ * zero timeout); any I/O here stalls acquisition.
+ * Only one callback is supported; registering again replaces it, NULL unregisters.
+ *
+ * @param callback Function to call on alarm transitions.
+ * @return ESP_OK
+ */
+esp_err_t temp_comp_register_alarm_callback(temp_alarm_callback_t callback);
+
+/**
+ * @brief Register the callback invoked whenever the effective sampling interval changes.
+ *
+ * Both adaptive and configuration changes are reported from the measurement task (configuration
+ * changes are applied there from the config event bus). Same constraints as the alarm callback;
+ * NULL unregisters.
+ */
+esp_err_t temp_comp_register_rate_callback(temp_rate_callback_t callback);
+
+/**
+ * @brief Register the callback invoked once per completed measurement cycle with that cycle's snapshot.
+ *
+ * Runs in the measurement task right after the values are published, so consumers are phase-locked
+ * to acquisition instead of polling. The snapshot is only valid during the call: copy it out
+ * (e.g. into a queue with a zero timeout). Same constraints as the alarm callback; NULL unregisters.
+ */
+esp_err_t temp_comp_register_cycle_callback(temp_cycle_callback_t callback);
+
+/**
+ * @brief Effective sampling interval (ms): the configured one, or the adaptive controller's.
+ */
+int temp_comp_get_sampling_interval_ms(void);
+
+/**
+ * @brief Get which alarms are currently active on a thermistor.
+ *
+ * @param index  0-based thermistor index.
+ * @param active Output array of TEMP_ALARM_TYPE_COUNT flags, indexed by TempAlarmType_t.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG on bad index or NULL pointer
+ */
+esp_err_t temp_comp_get_alarm_state(int index, bool *active);
+
+/**
+ * @brief Get a consistent copy of the health state machines of all slots.
+ *
+ * @param out Output array of MAX_THERMISTOR_COUNT entries.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG if out is NULL
+ */
+esp_err_t temp_comp_get_health(HealthState_t *out);
+
+/**
+ * @brief Record a calibration reference point for a thermistor.
+ *
+ * @param index          0-based thermistor index.
+ * @param reference_c    Reference temperature (C) the probe is held at.
+ * @param resistance_ohm Probe resistance at that temperature, or NAN to use the latest reading.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG on bad index or reference
+ *      - ESP_ERR_INVALID_STATE if MAX_CAL_POINTS are already stored or no valid reading exists
+ */
+esp_err_t temp_comp_cal_add_point(int index, float reference_c, float resistance_ohm);
+
+/**
+ * @brief Get the calibration points collected so far (up to MAX_CAL_POINTS).
+ */
+esp_err_t temp_comp_cal_get_points(int index, CalPoint_t *points, int *count);
+
+/**
+ * @brief Discard the calibration points of a thermistor.
+ */
+esp_err_t temp_comp_cal_clear(int index);
+
+/**
+ * @brief Fit the collected points (3: Steinhart-Hart, 2: Beta) and store the model in config_comp.
+ *
+ * The points are cleared on success.
+ *
+ * @param index 0-based thermistor index.
+ * @param model Output: the fitted model.
+ */
+esp_err_t temp_comp_cal_solve(int index, ThermistorModel_t *model);
+
+/**
+ * @brief Start a burst capture: one channel sampled back to back into the pre-trigger ring.
+ *
+ * The channel must be wired directly (the scan owns the mux address lines). Its ADC unit is shared
+ * with the measurement task, which takes precedence, so the burst spacing stretches slightly while
+ * a scan converts on the same unit.
+ *
+ * @param index   0-based thermistor index.
+ * @param pre     Samples kept before the trigger.
+ * @param post    Samples captured from the trigger on (>= 1); pre + post must fit the ring.
+ * @param trigger Level edge to fire on, besides temp_comp_burst_trigger().
+ * @param level_c Trigger level (C), converted once to a raw code with the channel's model.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG on bad index, sizes, or a level outside the channel's range
+ *      - ESP_ERR_INVALID_STATE if a capture is running or the channel is unused
+ *      - ESP_ERR_NOT_SUPPORTED for a multiplexed channel
+ *      - ESP_ERR_NO_MEM if no ring could be allocated
+ */
+esp_err_t temp_comp_burst_arm(int index, uint32_t pre, uint32_t post, TempBurstTrigger_t trigger, float level_c);
+
+/**
+ * @brief Fire the trigger of the armed capture now. Fewer than `pre` samples are kept if the ring is not full yet.
+ *
+ * @return ESP_ERR_INVALID_STATE unless armed.
+ */
+esp_err_t temp_comp_burst_trigger(void);
+
+/**
+ * @brief Abort a running capture or discard a frozen one.
+ *
+ * @return ESP_ERR_TIMEOUT if the sampler did not stop within 100 ms.
+ */
+esp_err_t temp_comp_burst_stop(void);
+
+esp_err_t temp_comp_burst_get_status(TempBurstStatus_t *out);
+
+/**
+ * @brief Copy raw codes of the frozen capture in chronological order.
+ *
+ * Reading the last sample marks the capture as dumped (see temp_comp_diag_noise_start()).
+ *
+ * @return Samples copied, 0 past the end or unless the capture is BURST_DONE.
+ */
+uint32_t temp_comp_burst_read(uint32_t offset, uint16_t *codes, uint32_t max);
+
+/**
+ * @brief Start the noise diagnostic: TEMP_NOISE_SAMPLES raw codes of one channel at TEMP_NOISE_PERIOD_US
+ *        on the burst sampler, about 1 s. temp_comp_diag_noise_result() collects the analysis.
+ *
+ * A frozen burst capture is only replaced once it was read to its end with temp_comp_burst_read()
+ * (or discarded with temp_comp_burst_stop()); the channel has the same constraints as temp_comp_burst_arm().
+ *
+ * @param index 0-based thermistor index.
+ * @return
+ *      - ESP_OK if the capture started
+ *      - ESP_ERR_INVALID_STATE if a burst capture is frozen and has not been dumped
+ *      - ESP_ERR_NO_MEM if the sampler has no pace timer
+ *      - errors of temp_comp_burst_arm()
+ */
+esp_err_t temp_comp_diag_noise_start(int index);
+
+/**
+ * @brief Result of the started noise diagnostic: RMS noise, ENOB and the dominant interference tones
+ *        (see temp_noise_analyze). Does not wait; the analysis runs in the caller once the capture is complete.
+ *
+ * @return
+ *      - ESP_OK on success, with rms_c set when the channel's curve is defined at the mean code
+ *      - ESP_ERR_NOT_FINISHED while the capture runs
+ *      - ESP_ERR_INVALID_STATE if no diagnostic was started, or its capture was stopped
+ *      - ESP_ERR_TIMEOUT if the capture did not complete within twice its length
+ */
+esp_err_t temp_comp_diag_noise_result(NoiseAnalysis_t *out);
+
 /**
  * @brief Refresh cached configuration and ADC readings.
  *
  * This function reloads configuration parameters and updates cached ADC values used for temperature compensation.
+ * The caches belong to the measurement task: call it only from temp_comp_init() or that task. Other tasks
+ * request a refresh with config_comp_request_refresh().
  *
  * @return
  *      - ESP_OK on success
@@ -62,6 +357,11 @@ esp_err_t temp_comp_get_latest_temps_json(char *buffer, size_t buffer_size);
  */
 esp_err_t temp_comp_refresh_cached_config_and_adc();
 
+/**
+ * @brief RAM reserved at build time by the component (per-channel state, caches, subscription), for the boot memory report.
+ */
+size_t temp_comp_get_static_ram_bytes(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+#include "config_comp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Per-channel filter chain state.
+ *
+ * Sized for the largest supported median window, so a channel's state never needs
+ * (re)allocation; it is simply reset when the channel's FilterConfig_t changes.
+ */
+typedef struct {
+    float   median_buf[MAX_FILTER_MEDIAN_WINDOW];   // Ring of the most recent raw samples
+    int     median_count;                           // Valid samples in median_buf (<= window)
+    int     median_head;                            // Next write position in median_buf
+    bool    iir_primed;
+    float   iir_value;
+    bool    kalman_primed;
+    float   kalman_x;                               // State estimate (C)
+    float   kalman_p;                               // Estimate variance (C^2)
+} FilterState_t;
+
+/**
+ * @brief Reset a filter chain so the next sample re-seeds every stage.
+ *
+ * @param state Filter state to reset.
+ */
+void temp_filter_reset(FilterState_t *state);
+
+/**
+ * @brief Push one sample through the filter chain (median -> IIR -> Kalman).
+ *
+ * Non-finite samples (failed conversions) are passed through unchanged and do not
+ * touch the filter state, so a single bad read does not poison the history.
+ *
+ * @param state  Filter state of the channel.
+ * @param config Filter configuration of the channel.
+ * @param sample New raw temperature sample (C).
+ * @return The filtered temperature (C).
+ */
+float temp_filter_apply(FilterState_t *state, const FilterConfig_t *config, float sample);
+
+#ifdef __cplusplus
+}
+#endif
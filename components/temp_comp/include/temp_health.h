@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HEALTH_DEBOUNCE_SAMPLES     3       // Consecutive observations needed to enter/leave a fault
+#define HEALTH_BACKOFF_MIN_CYCLES   2       // Scan cycles skipped after the first confirmed fault
+#define HEALTH_BACKOFF_MAX_CYCLES   64      // Cap of the doubling re-probe interval (bounds reconnect latency)
+#define HEALTH_NOISY_STEP_C         5.0f    // Sample-to-sample jump counted as noise
+#define HEALTH_NOISY_SCORE          6       // Jumps add 2, calm samples subtract 1; NOISY at this score
+
+typedef enum {
+    HEALTH_OK = 0,
+    HEALTH_SUSPECT,     // Fault seen but not debounced yet, or recovering from a fault
+    HEALTH_OPEN,        // Code at full scale: probe disconnected
+    HEALTH_SHORT,       // Code at zero: probe shorted
+    HEALTH_NOISY,       // Readings valid but jumping; still reported
+} ChannelHealth_t;
+
+typedef enum {
+    HEALTH_OBS_VALID = 0,
+    HEALTH_OBS_OPEN,
+    HEALTH_OBS_SHORT,
+    HEALTH_OBS_NONE,    // No usable observation (e.g. ADC driver error)
+} HealthObservation_t;
+
+/**
+ * @brief Per-channel health state machine.
+ */
+typedef struct {
+    ChannelHealth_t     state;
+    HealthObservation_t pending;            // Fault kind being debounced in SUSPECT
+    uint8_t             streak;             // Consecutive observations agreeing with the pending transition
+    uint8_t             noise_score;
+    uint16_t            backoff_cycles;     // Current re-probe interval of a faulted channel, 0: none
+    uint16_t            skip_remaining;     // Scan cycles left before the next re-probe
+    uint32_t            fault_count;        // Confirmed faults since reset
+    bool                has_previous;
+    float               previous_temp;
+} HealthState_t;
+
+void temp_health_reset(HealthState_t *state);
+
+/**
+ * @brief Classify a raw conversion (thermistor on the low side of the divider).
+ *
+ * @param raw      Raw code, negative if the read failed.
+ * @param max_code Full-scale code.
+ */
+HealthObservation_t temp_health_classify(int raw, int max_code);
+
+/**
+ * @brief Whether the channel is due for a conversion this scan cycle.
+ *
+ * Faulted channels are converted only every backoff_cycles cycles; the call counts the skip down.
+ */
+bool temp_health_should_sample(HealthState_t *state);
+
+/**
+ * @brief Feed one observation (and the unfiltered temperature of valid ones).
+ *
+ * @return true if the state changed.
+ */
+bool temp_health_update(HealthState_t *state, HealthObservation_t obs, float temp);
+
+/**
+ * @brief Short lowercase name of a health state ("ok", "suspect", "open", "short", "noisy").
+ */
+const char *temp_health_to_str(ChannelHealth_t state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "config_comp.h"
+#include "temp_health.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEMP_JSON_NAME_SIZE     sizeof(((ThermistorConfig_t *)0)->name)
+// {"names":[ + one quoted name and comma per slot + ],"temperatures":[
+#define TEMP_JSON_PREFIX_MAX    (32 + (TEMP_JSON_NAME_SIZE + 3) * MAX_THERMISTOR_COUNT)
+#define TEMP_JSON_VALUE_MAX     48  // Longest "%.2f" of a finite float, plus sign and terminator
+
+/**
+ * @brief Constant part of a snapshot frame, rebuilt only when the thermistor table changes.
+ */
+typedef struct {
+    char   prefix[TEMP_JSON_PREFIX_MAX];    // {"names":["a","b"],"temperatures":[
+    size_t prefix_len;
+    int    indices[MAX_THERMISTOR_COUNT];   // Slots serialized, in table order
+    int    count;
+} JsonFrameTemplate_t;
+
+/**
+ * @brief Build the frame template from the active slots of the thermistor table.
+ */
+void temp_json_build_template(const ThermistorConfig_t *configs, JsonFrameTemplate_t *tpl);
+
+/**
+ * @brief Build a frame template from snapshot names (empty: unused slot), e.g. TemperatureOutputData_t.
+ *
+ * @param names Names of all MAX_THERMISTOR_COUNT slots.
+ * @param mask  Slots to serialize among the named ones, or NULL for all of them.
+ * @param tpl   Output template.
+ */
+void temp_json_build_template_names(const char (*names)[TEMP_JSON_NAME_SIZE], const bool *mask, JsonFrameTemplate_t *tpl);
+
+/**
+ * @brief Format a value exactly like printf("%.2f") without going through printf.
+ *
+ * Finite values below 1e7 in magnitude take the fixed-point path; others fall back to snprintf.
+ *
+ * @param value Value to format.
+ * @param out   Output buffer of at least TEMP_JSON_VALUE_MAX bytes (not null-terminated).
+ * @return Number of characters written.
+ */
+size_t temp_json_format_centi(float value, char *out);
+
+/**
+ * @brief Serialize a snapshot frame in a single pass: template prefix, values, closing "]}".
+ *
+ * A "health" array is appended only while one of the serialized channels is not OK.
+ *
+ * @param tpl         Frame template.
+ * @param temps       Values of all MAX_THERMISTOR_COUNT slots (only tpl->indices are read).
+ * @param health      Health of all slots, or NULL to leave it out.
+ * @param buffer      Output buffer, null-terminated on success.
+ * @param buffer_size Size of the output buffer.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_NO_MEM if the frame does not fit (buffer is emptied)
+ */
+esp_err_t temp_json_format_frame(const JsonFrameTemplate_t *tpl, const float *temps, const ChannelHealth_t *health,
+                                 char *buffer, size_t buffer_size);
+
+/**
+ * @brief Append ,"health":["ok",...] for the selected slots if any of them is not OK.
+ *
+ * @param health      Health of all slots.
+ * @param indices     Slots to list, in output order.
+ * @param count       Number of slots.
+ * @param buffer      Output buffer (written from buffer[len], null-terminated).
+ * @param buffer_size Size of the output buffer.
+ * @param len         Current length of the content in buffer.
+ * @return New length, or -1 if it does not fit.
+ */
+int temp_json_append_health(const ChannelHealth_t *health, const int *indices, int count,
+                            char *buffer, size_t buffer_size, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
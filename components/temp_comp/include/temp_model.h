@@ -0,0 +1,61 @@
+#pragma once
+
+#include "esp_err.h"
+#include "config_comp.h"
+
+#define MAX_CAL_POINTS 3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Precomputed conversion state: 1/T = k0 + k1 ln(R) + k3 ln(R)^3 for either model.
+ *
+ * Rebuilt only when a channel's ThermistorModel_t changes, so the per-sample cost is the same
+ * (one logf and a cubic) whatever the model.
+ */
+typedef struct {
+    float k0;
+    float k1;
+    float k3;
+} ConversionState_t;
+
+/**
+ * @brief A calibration reference point: measured resistance at a known temperature.
+ */
+typedef struct {
+    float resistance_ohm;
+    float temperature_c;
+} CalPoint_t;
+
+/**
+ * @brief Reduce a model to its ConversionState_t.
+ */
+void temp_model_build(const ThermistorModel_t *model, ConversionState_t *state);
+
+/**
+ * @brief Convert a thermistor resistance to degrees Celsius.
+ *
+ * @return Temperature in C, NAN if resistance <= 0.
+ */
+float temp_model_to_celsius(const ConversionState_t *state, float resistance_ohm);
+
+/**
+ * @brief Fit a model to calibration points.
+ *
+ * Three points solve the Steinhart-Hart system exactly; two points give a Beta model.
+ *
+ * @param points Reference points with distinct resistances and temperatures.
+ * @param count  2 or 3.
+ * @param model  Output model.
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_ARG on a wrong point count
+ *      - ESP_ERR_INVALID_STATE if the points are degenerate or give a non-physical model
+ */
+esp_err_t temp_model_fit(const CalPoint_t *points, int count, ThermistorModel_t *model);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define TEMP_NOISE_SAMPLES      1024    // FFT length (power of two)
+#define TEMP_NOISE_PERIOD_US    1000    // 1 kHz: ~1 Hz bins up to 500 Hz, covers 50/60 Hz mains and harmonics
+#define TEMP_NOISE_PEAKS        3       // Strongest interference tones reported
+#define TEMP_NOISE_PEAK_RATIO   10.0f   // A tone's bin power must exceed this multiple of the mean bin power
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    float frequency_hz;     // Interpolated between bins
+    float amplitude_lsb;    // Sine amplitude (Hann-window corrected)
+} NoisePeak_t;
+
+/**
+ * @brief Noise figures of one block of raw codes.
+ */
+typedef struct {
+    int         samples;
+    float       sample_rate_hz;
+    float       mean_code;
+    float       rms_lsb;            // Standard deviation of the codes: ADC noise, pickup and probe together
+    int         p2p_lsb;
+    float       enob;               // bits - log2(rms_lsb * sqrt(12)), clamped to [0, bits]
+    float       tone_fraction;      // Share of the AC power in the reported tones (1: pickup, 0: broadband)
+    int         peak_count;
+    NoisePeak_t peaks[TEMP_NOISE_PEAKS];    // Strongest first
+    float       rms_c;              // rms_lsb through the channel's slope at mean_code (filled by temp_comp, NAN if unknown)
+} NoiseAnalysis_t;
+
+/**
+ * @brief Analyze a block of samples: statistics, Hann-windowed FFT, dominant tones.
+ *
+ * The FFT runs on esp-dsp when CONFIG_THERMISTRON_NOISE_ESP_DSP is set, on a portable radix-2
+ * implementation otherwise (and off target).
+ *
+ * @param work           In: count samples (raw codes as floats) in work[0..count-1].
+ *                       Used as 2 * count floats of complex scratch; destroyed.
+ * @param count          Power of two, 8..TEMP_NOISE_SAMPLES.
+ * @param sample_rate_hz Rate the samples were taken at.
+ * @param bits           Resolution of the codes, for the ENOB estimate.
+ * @return ESP_ERR_INVALID_ARG on a bad count or rate.
+ */
+esp_err_t temp_noise_analyze(float *work, int count, float sample_rate_hz, int bits, NoiseAnalysis_t *out);
+
+#ifdef __cplusplus
+}
+#endif
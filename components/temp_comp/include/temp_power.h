@@ -0,0 +1,64 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rough ESP32-S3 module figures used to *estimate* the average supply current per sample.
+// They are not measurements; adjust them to the board's datasheet/bench values.
+#define POWER_EST_ACTIVE_CURRENT_UA     30000   // CPU running, ADC converting
+#define POWER_EST_SLEEP_CURRENT_UA      240     // Automatic light sleep
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    bool     low_power;                 // Automatic light sleep currently configured
+    uint32_t samples;                   // Measurement cycles since the last mode change
+    uint32_t wake_latency_avg_us;       // Scheduled wake time -> start of acquisition
+    uint32_t wake_latency_max_us;
+    uint32_t awake_avg_us;              // Acquisition time per cycle (power locks held)
+    uint32_t est_avg_current_ua;        // Estimated average supply current over a sampling period
+    uint32_t est_charge_per_sample_uc;  // Estimated charge per sampling period
+} TempPowerStats_t;
+
+/**
+ * @brief Create the power-management locks held during acquisition.
+ *
+ * Without CONFIG_PM_ENABLE this succeeds and the power layer becomes a no-op.
+ */
+esp_err_t temp_power_init(void);
+
+/**
+ * @brief Whether the build can enter low-power mode: CONFIG_PM_ENABLE, plus CONFIG_USJ_NO_AUTO_LS_ON_CONNECTION
+ *        so light sleep never cuts off a connected USB Serial/JTAG host.
+ */
+bool temp_power_low_power_supported(void);
+
+/**
+ * @brief Switch automatic light sleep on or off and restart the statistics.
+ *
+ * @return ESP_ERR_NOT_SUPPORTED if low_power is requested and temp_power_low_power_supported() is false.
+ */
+esp_err_t temp_power_set_mode(bool low_power);
+
+/**
+ * @brief Mark the start of an acquisition cycle (takes the power locks).
+ *
+ * @param scheduled_us esp_timer time at which the cycle was due.
+ */
+void temp_power_sample_begin(int64_t scheduled_us);
+
+/**
+ * @brief Mark the end of an acquisition cycle (releases the power locks).
+ *
+ * @param interval_ms Sampling period, used for the current estimate.
+ */
+void temp_power_sample_end(int interval_ms);
+
+void temp_power_get_stats(TempPowerStats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
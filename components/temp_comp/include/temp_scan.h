@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include "config_comp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One acquisition step: at most one thermistor per ADC unit, all on the same mux address,
+// so the units convert at the same time.
+typedef struct {
+    int index[ADC_UNIT_COUNT];      // 0-based thermistor read on each unit, -1: unit idle in this step
+    int mux_address;                // Address selected for the step (MUX_ADDRESS_DIRECT: none)
+} ScanStep_t;
+
+/**
+ * @brief Whether a thermistor slot is in use (non-empty name other than "UNUSED").
+ */
+bool temp_scan_is_active(const ThermistorConfig_t *config);
+
+/**
+ * @brief Build the acquisition order of the active thermistors.
+ *
+ * Directly wired channels come first, then multiplexed channels grouped by mux address
+ * (and by ADC unit and channel within an address), so every address is selected once per scan
+ * and all muxes sharing the address lines are read while it is settled.
+ *
+ * @param configs   Thermistor table of MAX_THERMISTOR_COUNT entries.
+ * @param order_out Output array of MAX_THERMISTOR_COUNT 0-based thermistor indices.
+ * @return Number of active thermistors written to order_out.
+ */
+int temp_scan_build_order(const ThermistorConfig_t *configs, int *order_out);
+
+/**
+ * @brief Pair the scan order into steps that keep both ADC units busy.
+ *
+ * Within each mux address group the n-th thermistor on ADC1 is paired with the n-th one on ADC2;
+ * the surplus of the busier unit gets steps of its own. The order and mux switches are unchanged,
+ * a balanced wiring halves the number of steps.
+ *
+ * @param configs   Thermistor table of MAX_THERMISTOR_COUNT entries.
+ * @param order     Order from temp_scan_build_order.
+ * @param count     Entries in order.
+ * @param steps_out Output array of MAX_THERMISTOR_COUNT steps.
+ * @return Number of steps written.
+ */
+int temp_scan_build_steps(const ThermistorConfig_t *configs, const int *order, int count, ScanStep_t *steps_out);
+
+/**
+ * @brief Number of mux address changes one pass over the given order costs.
+ */
+int temp_scan_count_mux_switches(const ThermistorConfig_t *configs, const int *order, int count);
+
+#ifdef __cplusplus
+}
+#endif
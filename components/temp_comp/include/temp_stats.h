@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Running aggregates of one channel (Welford's algorithm for the variance).
+ */
+typedef struct {
+    uint32_t count;
+    float    min;
+    float    max;
+    float    mean;
+    float    m2;        // Sum of squared deviations from the running mean
+} StatsAccumulator_t;
+
+/**
+ * @brief Summary of a completed window.
+ */
+typedef struct {
+    uint32_t count;     // Valid (finite) samples in the window, 0: no data (all other fields NAN)
+    float    min;
+    float    max;
+    float    mean;
+    float    stddev;    // Sample standard deviation, 0 for a single sample
+} ChannelStats_t;
+
+/**
+ * @brief Clear an accumulator for a new window.
+ */
+void temp_stats_reset(StatsAccumulator_t *acc);
+
+/**
+ * @brief Add one sample in O(1). Non-finite samples are ignored.
+ */
+void temp_stats_add(StatsAccumulator_t *acc, float sample);
+
+/**
+ * @brief Summarize the accumulator into a ChannelStats_t.
+ */
+void temp_stats_summarize(const StatsAccumulator_t *acc, ChannelStats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
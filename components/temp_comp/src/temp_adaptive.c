@@ -0,0 +1,77 @@
+#include "temp_adaptive.h"
+#include <math.h>
+
+void temp_adaptive_reset_channel(AdaptiveChannel_t *channel) {
+    channel->has_previous = false;
+    channel->rate_c_per_min = 0.0f;
+    channel->ew_mean = 0.0f;
+    channel->ew_var = 0.0f;
+}
+
+AdaptiveActivity_t temp_adaptive_observe(AdaptiveChannel_t *channel, const AdaptiveConfig_t *config,
+                                         float temp, int64_t time_us) {
+    if (!isfinite(temp)) {
+        temp_adaptive_reset_channel(channel);
+        return ADAPTIVE_CALM;
+    }
+    if (!channel->has_previous) {
+        channel->has_previous = true;
+        channel->previous_temp = temp;
+        channel->previous_time_us = time_us;
+        channel->rate_c_per_min = 0.0f;
+        channel->ew_mean = temp;
+        channel->ew_var = 0.0f;
+        return ADAPTIVE_CALM;
+    }
+
+    if (time_us > channel->previous_time_us) {
+        // Time-based weight, so the averaging span stays the same when the interval changes
+        float dt_s = (float)(time_us - channel->previous_time_us) * 1e-6f;
+        float instant = (temp - channel->previous_temp) * 60.0f / dt_s;
+        channel->rate_c_per_min += dt_s / (ADAPTIVE_RATE_TAU_S + dt_s) * (instant - channel->rate_c_per_min);
+    }
+    float rate = fabsf(channel->rate_c_per_min);
+    channel->previous_temp = temp;
+    channel->previous_time_us = time_us;
+
+    float diff = temp - channel->ew_mean;
+    channel->ew_mean += ADAPTIVE_EW_ALPHA * diff;
+    channel->ew_var = (1.0f - ADAPTIVE_EW_ALPHA) * (channel->ew_var + ADAPTIVE_EW_ALPHA * diff * diff);
+    float stddev = sqrtf(channel->ew_var);
+
+    bool use_rate = config->rate_c_per_min > 0.0f;
+    bool use_std = config->stddev_c > 0.0f;
+    if ((use_rate && rate > config->rate_c_per_min) || (use_std && stddev > config->stddev_c)) {
+        return ADAPTIVE_ACTIVE;
+    }
+    if ((!use_rate || rate < config->rate_c_per_min * config->hysteresis) &&
+        (!use_std || stddev < config->stddev_c * config->hysteresis)) {
+        return ADAPTIVE_CALM;
+    }
+    return ADAPTIVE_HOLD;
+}
+
+int temp_adaptive_next_interval(AdaptiveState_t *state, const AdaptiveConfig_t *config, AdaptiveActivity_t activity) {
+    switch (activity) {
+        case ADAPTIVE_ACTIVE:
+            // Fast attack: a transient is captured from the next cycle on
+            state->interval_ms = config->min_interval_ms;
+            state->calm_streak = 0;
+            break;
+        case ADAPTIVE_CALM:
+            // Slow decay: double only after a sustained calm period
+            if (++state->calm_streak >= config->calm_cycles) {
+                state->calm_streak = 0;
+                int doubled = state->interval_ms > config->max_interval_ms / 2 ? config->max_interval_ms : state->interval_ms * 2;
+                state->interval_ms = doubled;
+            }
+            break;
+        case ADAPTIVE_HOLD:
+        default:
+            state->calm_streak = 0;
+            break;
+    }
+    if (state->interval_ms < config->min_interval_ms) state->interval_ms = config->min_interval_ms;
+    if (state->interval_ms > config->max_interval_ms) state->interval_ms = config->max_interval_ms;
+    return state->interval_ms;
+}
@@ -0,0 +1,53 @@
+#include "temp_adc_cal.h"
+#include "esp_log.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+
+static const char *TAG = "TEMP_ADC_CAL";
+
+esp_err_t temp_adc_cal_build(AdcCalTable_t *table, adc_unit_t unit, adc_atten_t atten, adc_bitwidth_t bitwidth, int max_code) {
+    if (table == NULL || max_code <= 0 || max_code >= ADC_CAL_TABLE_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    table->valid = false;
+    table->unit = unit;
+    table->atten = atten;
+    table->max_code = max_code;
+
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_handle_t handle = NULL;
+    adc_cali_curve_fitting_config_t cali_config = {
+        .unit_id = unit,
+        .chan = ADC_CHANNEL_0,  // The S3 calibration is per unit and attenuation, the channel is not used
+        .atten = atten,
+        .bitwidth = bitwidth,
+    };
+    esp_err_t ret = adc_cali_create_scheme_curve_fitting(&cali_config, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Curve fitting calibration unavailable for unit %d atten %d: %s", unit + 1, atten, esp_err_to_name(ret));
+        return ret;
+    }
+
+    for (int raw = 0; raw <= max_code; ++raw) {
+        int mv = 0;
+        ret = adc_cali_raw_to_voltage(handle, raw, &mv);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Calibrated conversion of code %d failed: %s", raw, esp_err_to_name(ret));
+            break;
+        }
+        table->mv[raw] = (uint16_t)(mv < 0 ? 0 : mv);
+    }
+    adc_cali_delete_scheme_curve_fitting(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    table->valid = true;
+    ESP_LOGI(TAG, "Calibration table built for unit %d atten %d: code 0 → %u mV, code %d → %u mV",
+             unit + 1, atten, table->mv[0], max_code, table->mv[max_code]);
+    return ESP_OK;
+#else
+    ESP_LOGW(TAG, "No ADC calibration scheme on this chip, using the uncalibrated code ratio.");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,63 @@
+#include "temp_alarm.h"
+#include <string.h>
+#include <math.h>
+
+#define RATE_ALARM_CLEAR_RATIO 0.8f // Rate alarm clears once |dT/dt| drops below 80% of the limit
+
+void temp_alarm_reset(AlarmState_t *state) {
+    memset(state, 0, sizeof(AlarmState_t));
+}
+
+static int _update(AlarmState_t *state, TempAlarmType_t type, bool raise, bool clear,
+                   int index, float value, TempAlarmEvent_t *events, int count) {
+    if (!state->active[type] && raise) {
+        state->active[type] = true;
+    } else if (state->active[type] && clear) {
+        state->active[type] = false;
+    } else {
+        return count;
+    }
+    events[count].index = index;
+    events[count].type = type;
+    events[count].raised = state->active[type];
+    events[count].value = value;
+    return count + 1;
+}
+
+int temp_alarm_evaluate(AlarmState_t *state, const AlarmConfig_t *config, int index,
+                        float temp, int64_t time_us, TempAlarmEvent_t *events) {
+    if (!isfinite(temp)) {
+        state->has_previous = false;
+        return 0;
+    }
+
+    int count = 0;
+    if (config->enabled) {
+        count = _update(state, TEMP_ALARM_HIGH, temp > config->high_c, temp < config->high_c - config->hysteresis_c,
+                        index, temp, events, count);
+        count = _update(state, TEMP_ALARM_LOW, temp < config->low_c, temp > config->low_c + config->hysteresis_c,
+                        index, temp, events, count);
+    }
+
+    if (config->max_rate_c_per_min > 0.0f && state->has_previous && time_us > state->previous_time_us) {
+        float rate = (temp - state->previous_temp) * 60e6f / (float)(time_us - state->previous_time_us);
+        float magnitude = fabsf(rate);
+        count = _update(state, TEMP_ALARM_RATE, magnitude > config->max_rate_c_per_min,
+                        magnitude < RATE_ALARM_CLEAR_RATIO * config->max_rate_c_per_min,
+                        index, rate, events, count);
+    }
+
+    state->has_previous = true;
+    state->previous_temp = temp;
+    state->previous_time_us = time_us;
+    return count;
+}
+
+const char *temp_alarm_type_to_str(TempAlarmType_t type) {
+    switch (type) {
+        case TEMP_ALARM_HIGH: return "high";
+        case TEMP_ALARM_LOW:  return "low";
+        case TEMP_ALARM_RATE: return "rate";
+        default:              return "unknown";
+    }
+}
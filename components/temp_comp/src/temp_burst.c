@@ -0,0 +1,111 @@
+#include "temp_burst.h"
+#include <string.h>
+
+void temp_burst_init(BurstCapture_t *burst, uint16_t *codes, uint32_t capacity) {
+    memset(burst, 0, sizeof(BurstCapture_t));
+    burst->codes = codes;
+    burst->capacity = codes != NULL ? capacity : 0;
+    burst->previous_code = -1;
+}
+
+esp_err_t temp_burst_arm(BurstCapture_t *burst, uint32_t pre, uint32_t post, BurstEdge_t edge, int level_code) {
+    if (post == 0 || pre > burst->capacity || post > burst->capacity - pre) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    burst->head = 0;
+    burst->filled = 0;
+    burst->since_gap = 0;
+    burst->pre = pre;
+    burst->post = post;
+    burst->edge = edge;
+    burst->level_code = level_code;
+    burst->previous_code = -1;
+    burst->manual = false;
+    burst->pre_count = 0;
+    burst->gap_free = 0;
+    burst->state = BURST_ARMED;
+    return ESP_OK;
+}
+
+static bool _crossed(const BurstCapture_t *burst, int code) {
+    if (burst->previous_code < 0 || burst->filled <= burst->pre) { // Not enough history before this sample yet
+        return false;
+    }
+    switch (burst->edge) {
+    case BURST_EDGE_UP:   return burst->previous_code < burst->level_code && code >= burst->level_code;
+    case BURST_EDGE_DOWN: return burst->previous_code >= burst->level_code && code < burst->level_code;
+    default:              return false;
+    }
+}
+
+bool temp_burst_push(BurstCapture_t *burst, uint16_t code, bool force_trigger) {
+    BurstState_t state = burst->state;
+    if (state != BURST_ARMED && state != BURST_TRIGGERED) {
+        return false;
+    }
+    uint32_t pos = burst->head;
+    burst->codes[pos] = code;
+    burst->head = pos + 1 < burst->capacity ? pos + 1 : 0;
+    if (burst->filled < burst->capacity) burst->filled++;
+    if (burst->since_gap < UINT32_MAX) burst->since_gap++;
+
+    if (state == BURST_ARMED && (force_trigger || _crossed(burst, code))) {
+        burst->manual = force_trigger;
+        burst->trigger_pos = pos;
+        burst->pre_count = burst->filled - 1 < burst->pre ? burst->filled - 1 : burst->pre;
+        burst->post_remaining = burst->post;
+        state = BURST_TRIGGERED;
+        burst->state = state;
+    }
+    burst->previous_code = code;
+    if (state == BURST_TRIGGERED && --burst->post_remaining == 0) {
+        uint32_t length = burst->pre_count + burst->post;
+        burst->gap_free = burst->since_gap < length ? burst->since_gap : length;
+        burst->state = BURST_DONE;
+        return true;
+    }
+    return false;
+}
+
+void temp_burst_note_gap(BurstCapture_t *burst) {
+    burst->since_gap = 0;
+}
+
+uint32_t temp_burst_length(const BurstCapture_t *burst) {
+    return burst->state == BURST_DONE ? burst->pre_count + burst->post : 0;
+}
+
+uint32_t temp_burst_read(const BurstCapture_t *burst, uint32_t offset, uint16_t *out, uint32_t max) {
+    uint32_t length = temp_burst_length(burst);
+    if (offset >= length) {
+        return 0;
+    }
+    uint32_t count = length - offset < max ? length - offset : max;
+    // Start of the capture is pre_count samples before the trigger, modulo the ring
+    uint32_t start = burst->trigger_pos >= burst->pre_count ? burst->trigger_pos - burst->pre_count
+                                                            : burst->trigger_pos + burst->capacity - burst->pre_count;
+    uint32_t pos = start + offset;
+    if (pos >= burst->capacity) pos -= burst->capacity;
+    for (uint32_t n = 0; n < count; ++n) {
+        out[n] = burst->codes[pos];
+        if (++pos == burst->capacity) pos = 0;
+    }
+    return count;
+}
+
+size_t temp_burst_pack12(const uint16_t *codes, size_t count, uint8_t *out) {
+    size_t len = 0;
+    size_t n = 0;
+    for (; n + 1 < count; n += 2) {
+        uint16_t a = codes[n] & 0x0FFF;
+        uint16_t b = codes[n + 1] & 0x0FFF;
+        out[len++] = (uint8_t)a;
+        out[len++] = (uint8_t)((a >> 8) | (b << 4));
+        out[len++] = (uint8_t)(b >> 4);
+    }
+    if (n < count) {
+        out[len++] = (uint8_t)codes[n];
+        out[len++] = (uint8_t)((codes[n] >> 8) & 0x0F);
+    }
+    return len;
+}
@@ -1,8 +1,24 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "temp_comp.h"
+#include "temp_filter.h"
+#include "temp_power.h"
+#include "temp_scan.h"
+#include "temp_model.h"
+#include "temp_adc_cal.h"
+#include "temp_json.h"
+#include "log_comp.h"
+#include "boot_prof.h"
+#include "temp_health.h"
+#include "temp_adaptive.h"
+#include "temp_noise.h"
+#include "driver/gpio.h"
+#include "esp_rom_sys.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_adc/adc_oneshot.h"
+#include "esp_heap_caps.h"
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
@@ -13,81 +29,492 @@ static ThermistorConfig_t s_cached_therm_configs[MAX_THERMISTOR_COUNT];
 static int s_cached_active_therm_count = 0;
 static int s_cached_sampling_interval_ms = DEFAULT_MEASUREMENT_INTERVAL_MS; // Default from config_comp.h
 static bool s_log_temp_measurements = false;
-static adc_oneshot_unit_handle_t s_adc_handle = NULL;
+static bool s_low_power_mode = false;
+
+// Adaptive sampling: s_effective_interval_ms is what the task actually sleeps
+static AdaptiveConfig_t s_cached_adaptive;
+static AdaptiveState_t s_adaptive_state;
+static AdaptiveChannel_t s_adaptive_channels[MAX_THERMISTOR_COUNT];
+static volatile int s_effective_interval_ms = DEFAULT_MEASUREMENT_INTERVAL_MS;
+static temp_rate_callback_t s_rate_callback = NULL;
+static adc_oneshot_unit_handle_t s_adc_handles[ADC_UNIT_COUNT]; // ADC2 stays NULL if unavailable
+
+// Scan schedule: active thermistors ordered to minimize mux address changes, paired across the ADC units
+static ScanStep_t s_scan_steps[MAX_THERMISTOR_COUNT];
+static int s_scan_step_count = 0;
+static MuxConfig_t s_cached_mux_config;
+static bool s_mux_gpios_configured = false;
+static int s_current_mux_address = MUX_ADDRESS_DIRECT;
 
 // static char temp_buffer[2048] = {0}; //TEMPORARY for DEBUGGING
 
 static float s_latest_temperatures[MAX_THERMISTOR_COUNT];
+static float s_latest_resistances[MAX_THERMISTOR_COUNT];    // Ohm, incl. calibration offset (for calibration)
+static ConversionState_t s_conversion_states[MAX_THERMISTOR_COUNT];
+static CalPoint_t s_cal_points[MAX_THERMISTOR_COUNT][MAX_CAL_POINTS];
+static int s_cal_point_counts[MAX_THERMISTOR_COUNT];
+static FilterState_t s_filter_states[MAX_THERMISTOR_COUNT];
+static AlarmState_t s_alarm_states[MAX_THERMISTOR_COUNT];
+static HealthState_t s_health_states[MAX_THERMISTOR_COUNT];     // Measurement task only
+static HealthState_t s_health_snapshot[MAX_THERMISTOR_COUNT];   // Guarded by s_temp_data_mutex
+static uint32_t s_cycle_count = 0;                                // Guarded by s_temp_data_mutex
+static uint16_t s_cycle_raw_codes[MAX_THERMISTOR_COUNT];          // Measurement task only, published at the end of the cycle
+static uint16_t s_latest_raw_codes[MAX_THERMISTOR_COUNT];         // Guarded by s_temp_data_mutex
+static uint32_t s_conversion_generation = 0;                      // Guarded by s_temp_data_mutex
+static temp_alarm_callback_t s_alarm_callback = NULL;
+static temp_cycle_callback_t s_cycle_callback = NULL;
+static TemperatureOutputData_t s_cycle_snapshot; // Only touched by the measurement task
+
+static StatsAccumulator_t s_stats_accumulators[MAX_THERMISTOR_COUNT];
+static int s_cached_stats_window_samples = DEFAULT_STATS_WINDOW_SAMPLES;
+static int s_stats_window_cycles = 0;
+static TemperatureStatsData_t s_completed_stats; // Guarded by s_temp_data_mutex
+static JsonFrameTemplate_t s_json_template;       // Guarded by s_temp_data_mutex
 static SemaphoreHandle_t s_temp_data_mutex = NULL;
+static StaticSemaphore_t s_temp_data_mutex_struct;
 
-static volatile bool s_config_needs_refresh = false;
+// Config changes wake the measurement task through this notification bit and are applied as deltas
+#define CONFIG_EVENT_NOTIFY_BIT (1UL << 0)
+#define TEMP_CONFIG_FIELDS      (CONFIG_FIELD_MASK_ALL & ~(CONFIG_FIELD_BIT(CONFIG_FIELD_STREAM_ACTIVE) | CONFIG_FIELD_BIT(CONFIG_FIELD_STREAM_MODE) | \
+                                                           CONFIG_FIELD_BIT(CONFIG_FIELD_DEADBAND) | CONFIG_FIELD_BIT(CONFIG_FIELD_HEARTBEAT)))
+static ConfigSubscription_t s_config_subscription;
+static ConfigChangeEvent_t s_config_events[DEFAULT_CONFIG_EVENT_DEPTH];
+static bool s_config_needs_refresh = false; // A full refresh failed and is retried every cycle
+static bool s_conversion_ready = false; // Conversion states built at least once
 
 static const adc_oneshot_chan_cfg_t s_channel_config = {
     .bitwidth = ADC_BITWIDTH,
     .atten = ADC_ATTENUATION,
 };
+static AdcCalTable_t s_adc_cal_tables[ADC_UNIT_COUNT]; // Built once in init for s_channel_config.atten
 
-esp_err_t temp_comp_refresh_cached_config_and_adc() {
+// One conversion, filled in by whichever task reads it
+typedef struct {
+    int index;                      // 0-based thermistor, -1: nothing to read
     esp_err_t ret;
+    float temperature;
+    float resistance;
+    int raw;
+} AdcJob_t;
 
-    // If ADC unit is re-initialized by config_comp, old handle is invalid.
-    ret = config_comp_get_adc_unit_handle(&s_adc_handle);
-    if (ret != ESP_OK || s_adc_handle == NULL) {
-        ESP_LOGE(TAG, "[CACHE REFRESH] Failed to get ADC unit handle: %s", esp_err_to_name(ret));
+// ADC2 conversions run on the other core while this task converts on ADC1 (adc_oneshot_read busy-waits).
+// The task notification is taken by config events, so the handshake uses two binary semaphores.
+static AdcJob_t s_adc2_job;                 // Owned by the worker between start and done
+static SemaphoreHandle_t s_adc2_start = NULL;
+static SemaphoreHandle_t s_adc2_done = NULL;
+static StaticSemaphore_t s_adc2_start_struct;
+static StaticSemaphore_t s_adc2_done_struct;
+static TaskHandle_t s_adc2_worker = NULL;
+static StaticTask_t s_adc2_worker_tcb;
+static StackType_t s_adc2_worker_stack[TEMP_ADC_WORKER_STACK_SIZE];
+
+// adc_oneshot_read fails with ESP_ERR_TIMEOUT instead of waiting while another task converts on the unit.
+// The scan claims the unit so the burst sampler backs off, then retries over the sampler's conversion.
+#define ADC_BUSY_SPINS      5       // Sampler on the other core: done within microseconds
+#define ADC_BUSY_SPIN_US    20
+#define ADC_BUSY_RETRIES    7       // Then a tick each, for a sampler preempted on this core
+static volatile bool s_adc_claimed[ADC_UNIT_COUNT];
+
+// Burst capture: a low-priority task on the other core converts one channel back to back while armed
+#define BURST_YIELD_CHECK_MASK  63  // Reads between two looks at the clock
+#define BURST_PACED_RETRY_US    5   // Retry spacing while a scan holds the unit during a paced sample
+#if CONFIG_SPIRAM
+static uint16_t *s_burst_codes = NULL;  // TEMP_BURST_PSRAM_SAMPLES from PSRAM, allocated once
+#else
+static uint16_t s_burst_codes[TEMP_BURST_INTERNAL_SAMPLES];
+#endif
+static BurstCapture_t s_burst;              // Owned by the sampler while armed/triggered
+static ThermistorConfig_t s_burst_channel;  // Wiring taken at arm time
+static TempBurstTrigger_t s_burst_trigger_mode = TEMP_BURST_TRIGGER_COMMAND;
+static float s_burst_level_c = 0.0f;
+static int s_burst_index = -1;
+static uint16_t s_burst_capture_id = 0;
+static volatile bool s_burst_trigger_request = false;
+static volatile bool s_burst_stop_request = false;
+static volatile uint32_t s_burst_period_ns = 0;
+static uint32_t s_burst_pace_us = 0;        // 0: back to back, else one sample per period (noise diagnostic)
+static bool s_burst_dumped = true;          // The frozen capture was read to its end, or is a noise capture already analyzed
+static float s_noise_work[2 * TEMP_NOISE_SAMPLES]; // Samples in, complex FFT scratch
+static bool s_noise_pending = false;        // Noise capture started, result not collected yet
+static uint16_t s_noise_capture_id = 0;
+static TickType_t s_noise_start_tick = 0;
+static TaskHandle_t s_burst_task = NULL;
+static esp_timer_handle_t s_burst_pace_timer = NULL; // Wakes the sampler once per period of a paced capture
+static StaticTask_t s_burst_task_tcb;
+static StackType_t s_burst_task_stack[TEMP_BURST_STACK_SIZE];
+
+static void _reset_stats_window(void) {
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        temp_stats_reset(&s_stats_accumulators[i]);
+    }
+    s_stats_window_cycles = 0;
+}
+
+// Called once per measurement cycle; publishes the window summary when the window is full.
+static void _advance_stats_window(void) {
+    if (++s_stats_window_cycles < s_cached_stats_window_samples) {
+        return;
+    }
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) == pdTRUE) {
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            bool active = temp_scan_is_active(&s_cached_therm_configs[i]);
+            strncpy(s_completed_stats.thermistor_names[i], active ? s_cached_therm_configs[i].name : "", sizeof(s_completed_stats.thermistor_names[i]));
+            s_completed_stats.thermistor_names[i][sizeof(s_completed_stats.thermistor_names[i]) - 1] = '\0';
+            temp_stats_summarize(&s_stats_accumulators[i], &s_completed_stats.stats[i]);
+        }
+        s_completed_stats.window_samples = s_stats_window_cycles;
+        s_completed_stats.window_seq++;
+        xSemaphoreGive(s_temp_data_mutex);
+    }
+    _reset_stats_window();
+}
+
+static esp_err_t _configure_mux_gpios(void) {
+    s_current_mux_address = MUX_ADDRESS_DIRECT; // Unknown after (re)configuration: force a switch on next use
+    if (s_cached_mux_config.addr_bits == 0) {
+        return ESP_OK;
+    }
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 0,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    for (int b = 0; b < s_cached_mux_config.addr_bits; ++b) {
+        io_conf.pin_bit_mask |= 1ULL << s_cached_mux_config.addr_gpios[b];
+    }
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure mux address GPIOs: %s", esp_err_to_name(ret));
         return ret;
     }
-    ESP_LOGI(TAG, "[CACHE REFRESH] ADC unit handle obtained.");
+    ESP_LOGI(TAG, "Mux address lines configured: %d bits, settle %d us", s_cached_mux_config.addr_bits, s_cached_mux_config.settle_us);
+    return ESP_OK;
+}
+
+// Drives the shared mux address lines and waits for the analog path to settle.
+// No-op for directly wired channels and when the address is already selected.
+static void _select_mux_address(int mux_address) {
+    if (mux_address == MUX_ADDRESS_DIRECT || mux_address == s_current_mux_address || !s_mux_gpios_configured) {
+        return;
+    }
+    for (int b = 0; b < s_cached_mux_config.addr_bits; ++b) {
+        gpio_set_level(s_cached_mux_config.addr_gpios[b], (mux_address >> b) & 1);
+    }
+    s_current_mux_address = mux_address;
+    if (s_cached_mux_config.settle_us > 0) {
+        esp_rom_delay_us(s_cached_mux_config.settle_us);
+    }
+}
 
+static void _set_effective_interval(int interval_ms, const char *reason) {
+    int previous_ms = s_effective_interval_ms;
+    if (interval_ms == previous_ms) {
+        return;
+    }
+    s_effective_interval_ms = interval_ms;
+    ESP_LOGI(TAG, "Sampling interval %d -> %d ms (%s)", previous_ms, interval_ms, reason);
+    temp_rate_callback_t callback = s_rate_callback;
+    if (callback != NULL) {
+        TempRateEvent_t event = {
+            .interval_ms = interval_ms,
+            .previous_interval_ms = previous_ms,
+            .reason = reason,
+        };
+        callback(&event);
+    }
+}
+
+static void _refresh_timing(void) {
+    int previous_interval_ms = s_cached_sampling_interval_ms;
+    AdaptiveConfig_t previous_adaptive = s_cached_adaptive;
     s_cached_sampling_interval_ms = config_comp_get_sampling_interval();
     ESP_LOGI(TAG, "[CACHE REFRESH] Using sampling interval: %d ms", s_cached_sampling_interval_ms);
 
+    config_comp_get_adaptive_config(&s_cached_adaptive);
+    if (previous_interval_ms != s_cached_sampling_interval_ms ||
+        memcmp(&previous_adaptive, &s_cached_adaptive, sizeof(AdaptiveConfig_t)) != 0) {
+        // Restart the controller from the configured interval, clamped into the adaptive bounds
+        int interval_ms = s_cached_sampling_interval_ms;
+        if (s_cached_adaptive.enabled) {
+            if (interval_ms < s_cached_adaptive.min_interval_ms) interval_ms = s_cached_adaptive.min_interval_ms;
+            if (interval_ms > s_cached_adaptive.max_interval_ms) interval_ms = s_cached_adaptive.max_interval_ms;
+        }
+        s_adaptive_state.interval_ms = interval_ms;
+        s_adaptive_state.calm_streak = 0;
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            temp_adaptive_reset_channel(&s_adaptive_channels[i]);
+        }
+        _set_effective_interval(interval_ms, "config");
+    }
+}
+
+static void _refresh_stats_window(void) {
+    int stats_window_samples = config_comp_get_stats_window();
+    if (stats_window_samples != s_cached_stats_window_samples) {
+        s_cached_stats_window_samples = stats_window_samples;
+        _reset_stats_window();
+        ESP_LOGI(TAG, "[CACHE REFRESH] Statistics window set to %d samples, current window restarted.", stats_window_samples);
+    }
+}
+
+static void _refresh_low_power(void) {
+    bool low_power_mode = config_comp_get_low_power_mode();
+    if (low_power_mode != s_low_power_mode) {
+        esp_err_t ret = temp_power_set_mode(low_power_mode);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "[CACHE REFRESH] Failed to switch low-power mode %s: %s", low_power_mode ? "on" : "off", esp_err_to_name(ret));
+        } else {
+            s_low_power_mode = low_power_mode;
+        }
+    }
+}
+
+static void _refresh_mux(void) {
+    MuxConfig_t mux_config;
+    esp_err_t ret = config_comp_get_mux_config(&mux_config);
+    if (ret == ESP_OK && (!s_mux_gpios_configured || memcmp(&mux_config, &s_cached_mux_config, sizeof(MuxConfig_t)) != 0)) {
+        s_cached_mux_config = mux_config;
+        s_mux_gpios_configured = _configure_mux_gpios() == ESP_OK;
+    }
+}
+
+static void _refresh_log_temps(void) {
     s_log_temp_measurements = config_comp_get_log_temps_active();
     ESP_LOGI(TAG, "[CACHE REFRESH] Measured temperatures will%sbe logged to console", s_log_temp_measurements ? " " : " not ");
+}
 
+static void _refresh_thermistor_count(void) {
     s_cached_active_therm_count = config_comp_get_thermistor_count();
     if (s_cached_active_therm_count < 0 || s_cached_active_therm_count > MAX_THERMISTOR_COUNT) {
         ESP_LOGW(TAG, "[CACHE REFRESH] Invalid thermistor count from config: %d.", s_cached_active_therm_count);
         // Continue, but log warning. The loop below will correctly identify active ones.
     }
     ESP_LOGI(TAG, "[CACHE REFRESH] Expecting %d active thermistors.", s_cached_active_therm_count);
+}
 
-    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
-        ret = config_comp_get_thermistor_config(i, &s_cached_therm_configs[i]);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "[CACHE REFRESH] Failed to get config for thermistor %d: %s", i, esp_err_to_name(ret));
-            continue; // Skip this thermistor config if fetch fails
-        }
-        char *name = s_cached_therm_configs[i].name;
-        if (name[0] == '\0' || strcmp(name, "UNUSED") == 0) {
-            continue; // Skip also if UNUSED
-        }
+// Re-reads one thermistor and resets only the per-channel state its change invalidates.
+// Returns true if its name or wiring changed, i.e. the scan order and JSON template must be rebuilt.
+static bool _refresh_thermistor(int i, bool configure_adc) {
+    const ThermistorConfig_t *previous = &s_cached_therm_configs[i];
+    ThermistorConfig_t config;
+    esp_err_t ret = config_comp_get_thermistor_config(i, &config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "[CACHE REFRESH] Failed to get config for thermistor %d: %s", i, esp_err_to_name(ret));
+        return false; // Skip this thermistor config if fetch fails
+    }
+    bool reconverted = !s_conversion_ready || memcmp(&previous->model, &config.model, sizeof(ThermistorModel_t)) != 0;
+    ConversionState_t conversion = s_conversion_states[i];
+    if (reconverted) {
+        temp_model_build(&config.model, &conversion);
+    }
+    bool refiltered = memcmp(&previous->filter, &config.filter, sizeof(FilterConfig_t)) != 0;
+    bool realarmed = memcmp(&previous->alarm, &config.alarm, sizeof(AlarmConfig_t)) != 0;
+    bool rewired = previous->adc_channel != config.adc_channel ||
+                   previous->adc_unit != config.adc_unit ||
+                   previous->mux_address != config.mux_address ||
+                   previous->divider_resistor_value != config.divider_resistor_value ||
+                   strcmp(previous->name, config.name) != 0;
+    bool regenerated = reconverted || rewired || previous->calibration_resistance_offset != config.calibration_resistance_offset;
 
-        ret = adc_oneshot_config_channel(s_adc_handle, s_cached_therm_configs[i].adc_channel, &s_channel_config);
+    // Readers of the raw descriptor see the configuration, its conversion and the generation change together
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "[CACHE REFRESH] Failed to take temperature data mutex for thermistor %d", i);
+        return false;
+    }
+    s_cached_therm_configs[i] = config;
+    s_conversion_states[i] = conversion;
+    if (regenerated) {
+        s_conversion_generation++; // Raw streams resend their descriptor
+    }
+    xSemaphoreGive(s_temp_data_mutex);
+
+    if (refiltered) {
+        temp_filter_reset(&s_filter_states[i]); // Re-seed the chain with the new parameters
+        ESP_LOGI(TAG, "[CACHE REFRESH] Filter chain of thermistor %s reset.", s_cached_therm_configs[i].name);
+    }
+    if (rewired) {
+        temp_health_reset(&s_health_states[i]); // Different probe or path: forget faults and back-off
+    }
+    if (realarmed) {
+        temp_alarm_reset(&s_alarm_states[i]); // New rules start from a clean (all clear) state
+        ESP_LOGI(TAG, "[CACHE REFRESH] Alarm state of thermistor %s reset.", s_cached_therm_configs[i].name);
+    }
+    if ((configure_adc || rewired) && temp_scan_is_active(&s_cached_therm_configs[i])) {
+        adc_oneshot_unit_handle_t handle = s_adc_handles[s_cached_therm_configs[i].adc_unit];
+        ret = handle != NULL ? adc_oneshot_config_channel(handle, s_cached_therm_configs[i].adc_channel, &s_channel_config)
+                             : ESP_ERR_INVALID_STATE;
         if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "[CACHE REFRESH] Failed to configure ADC channel %d for thermistor %s: %s",
-                     s_cached_therm_configs[i].adc_channel, s_cached_therm_configs[i].name, esp_err_to_name(ret));
+            ESP_LOGE(TAG, "[CACHE REFRESH] Failed to configure ADC%d channel %d for thermistor %s: %s",
+                     s_cached_therm_configs[i].adc_unit + 1, s_cached_therm_configs[i].adc_channel,
+                     s_cached_therm_configs[i].name, esp_err_to_name(ret));
         }
     }
+    return rewired;
+}
+
+static void _rebuild_scan_schedule(void) {
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) == pdTRUE) {
+        temp_json_build_template(s_cached_therm_configs, &s_json_template);
+        xSemaphoreGive(s_temp_data_mutex);
+    }
+
+    int order[MAX_THERMISTOR_COUNT];
+    int count = temp_scan_build_order(s_cached_therm_configs, order);
+    s_scan_step_count = temp_scan_build_steps(s_cached_therm_configs, order, count, s_scan_steps);
+    ESP_LOGI(TAG, "[CACHE REFRESH] Scan order rebuilt: %d channels in %d steps, %d mux switches per scan.",
+             count, s_scan_step_count, temp_scan_count_mux_switches(s_cached_therm_configs, order, count));
+}
+
+esp_err_t temp_comp_refresh_cached_config_and_adc() {
+    esp_err_t ret;
+
+    // If ADC unit is re-initialized by config_comp, old handle is invalid.
+    ret = config_comp_get_adc_unit_handle(ADC_UNIT_1, &s_adc_handles[ADC_UNIT_1]);
+    if (ret != ESP_OK || s_adc_handles[ADC_UNIT_1] == NULL) {
+        ESP_LOGE(TAG, "[CACHE REFRESH] Failed to get ADC unit handle: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = config_comp_get_adc_unit_handle(ADC_UNIT_2, &s_adc_handles[ADC_UNIT_2]);
+    if (ret != ESP_OK) {
+        s_adc_handles[ADC_UNIT_2] = NULL; // Thermistors wired to ADC2 read as errors
+        ESP_LOGW(TAG, "[CACHE REFRESH] ADC2 unit handle unavailable: %s", esp_err_to_name(ret));
+    }
+    ESP_LOGI(TAG, "[CACHE REFRESH] ADC unit handles obtained.");
+
+    _refresh_timing();
+    _refresh_stats_window();
+    _refresh_low_power();
+    _refresh_mux();
+    _refresh_log_temps();
+    _refresh_thermistor_count();
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        _refresh_thermistor(i, true);
+    }
+    s_conversion_ready = true;
+    _rebuild_scan_schedule();
+
     ESP_LOGI(TAG, "[CACHE REFRESH] Complete");
     return ESP_OK;
 
 }
 
-static void handle_config_update_notification(void) {
-    ESP_LOGI(TAG, "Received configuration update notification.");
-    s_config_needs_refresh = true;
+// Applies the published configuration changes one by one, touching only what each of them changed.
+static void _apply_config_changes(void) {
+    ConfigChangeEvent_t event;
+    bool rebuild_scan = false;
+    bool full_refresh = false;
+    while (config_comp_next_change(&s_config_subscription, &event)) {
+        bool per_channel = event.channel >= 0 && event.channel < MAX_THERMISTOR_COUNT;
+        ESP_LOGD(TAG, "Config change %u: field %d, channel %d", (unsigned)event.seq, event.field, event.channel);
+        switch (event.field) {
+        case CONFIG_FIELD_SAMPLING_INTERVAL:
+        case CONFIG_FIELD_ADAPTIVE:
+            _refresh_timing();
+            break;
+        case CONFIG_FIELD_STATS_WINDOW:
+            _refresh_stats_window();
+            break;
+        case CONFIG_FIELD_LOW_POWER:
+            _refresh_low_power();
+            break;
+        case CONFIG_FIELD_LOG_TEMPS:
+            _refresh_log_temps();
+            break;
+        case CONFIG_FIELD_MUX:
+            _refresh_mux();
+            break;
+        case CONFIG_FIELD_THERMISTOR_COUNT:
+            _refresh_thermistor_count();
+            break;
+        case CONFIG_FIELD_THERMISTOR:
+            _refresh_thermistor_count(); // The setter recounts the used slots
+            /* fall through */
+        case CONFIG_FIELD_CALIBRATION:
+        case CONFIG_FIELD_MODEL:
+        case CONFIG_FIELD_FILTER:
+        case CONFIG_FIELD_ALARM:
+            if (per_channel) {
+                rebuild_scan |= _refresh_thermistor(event.channel, false);
+            } else {
+                full_refresh = true;
+            }
+            break;
+        default:
+            full_refresh = true; // CONFIG_FIELD_ALL: events were lost
+            break;
+        }
+    }
+    if (full_refresh) {
+        if (temp_comp_refresh_cached_config_and_adc() != ESP_OK) {
+            s_config_needs_refresh = true; // Retried at the start of every cycle
+        }
+    } else if (rebuild_scan) {
+        _rebuild_scan_schedule();
+    }
+}
+
+// Sleeps until the next sampling slot. Configuration changes wake the task and are applied at once;
+// a shorter interval moves the next slot forward, so 1 h -> 1 s does not wait out the old hour.
+static void _wait_next_cycle(TickType_t *last_wake_tick) {
+    while (1) {
+        TickType_t interval_ticks = pdMS_TO_TICKS(s_effective_interval_ms);
+        TickType_t due_tick = *last_wake_tick + interval_ticks;
+        TickType_t now_tick = xTaskGetTickCount();
+        if ((int32_t)(now_tick - due_tick) >= 0) {
+            // Overdue: stay on the drift-free grid unless a whole slot was missed, then restart it now
+            *last_wake_tick = now_tick - due_tick < interval_ticks ? due_tick : now_tick;
+            return;
+        }
+        uint32_t notified_bits = 0;
+        if (xTaskNotifyWait(0, CONFIG_EVENT_NOTIFY_BIT, &notified_bits, due_tick - now_tick) == pdTRUE &&
+            (notified_bits & CONFIG_EVENT_NOTIFY_BIT) != 0) {
+            _apply_config_changes();
+        }
+    }
+}
+
+static uint32_t get_max_adc_value_from_enum(adc_bitwidth_t bitwidth_enum) {
+    switch (bitwidth_enum) {
+        case ADC_BITWIDTH_9:  return (1 << 9) - 1;
+        case ADC_BITWIDTH_10: return (1 << 10) - 1;
+        case ADC_BITWIDTH_11: return (1 << 11) - 1;
+        case ADC_BITWIDTH_12: return (1 << 12) - 1;
+        // ADC_BITWIDTH_DEFAULT is usually 12 on ESP32 series
+        case ADC_BITWIDTH_DEFAULT: return (1 << 12) - 1;
+        default:
+            ESP_LOGW(TAG, "Unknown ADC bitwidth enum %d, assuming 12-bit (4095 max)", bitwidth_enum);
+            return (1 << 12) - 1; // Default to 12-bit max value
+    }
 }
 
 esp_err_t temp_comp_init() {
     ESP_LOGI(TAG, "Initializing temperature component...");
     esp_err_t ret;
 
-    s_temp_data_mutex = xSemaphoreCreateMutex();
+    s_temp_data_mutex = xSemaphoreCreateMutexStatic(&s_temp_data_mutex_struct);
     if (s_temp_data_mutex == NULL) {
         ESP_LOGE(TAG, "Failed to create temperature data mutex");
         return ESP_FAIL;
     }
 
+    ret = temp_power_init();
+    if (ret == ESP_OK) {
+        ret = temp_power_set_mode(s_low_power_mode);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Power management unavailable (%s), sampling without power locks.", esp_err_to_name(ret));
+    }
+
+    for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+        ret = temp_adc_cal_build(&s_adc_cal_tables[unit], (adc_unit_t)unit, s_channel_config.atten, s_channel_config.bitwidth,
+                                 get_max_adc_value_from_enum(s_channel_config.bitwidth));
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "ADC%d calibration unavailable (%s), converting the raw code ratio.", unit + 1, esp_err_to_name(ret));
+        }
+    }
+
     ret = temp_comp_refresh_cached_config_and_adc();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Initial configuration cache refresh failed.");
@@ -97,7 +524,7 @@ esp_err_t temp_comp_init() {
         return ESP_FAIL;
     }
 
-    ret = config_comp_register_update_callback(handle_config_update_notification);
+    ret = config_comp_subscribe(&s_config_subscription, TEMP_CONFIG_FIELDS, s_config_events, DEFAULT_CONFIG_EVENT_DEPTH);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to register for configuration updates.");
         // Not fatal if initial cache is good, but no updates.
@@ -135,59 +562,88 @@ esp_err_t temp_comp_init() {
     // }
 
     memset(s_latest_temperatures, 0, sizeof(s_latest_temperatures)); // Initialize temperatures
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        temp_filter_reset(&s_filter_states[i]);
+        temp_alarm_reset(&s_alarm_states[i]);
+        temp_health_reset(&s_health_states[i]);
+        s_health_snapshot[i] = s_health_states[i];
+    }
 
     ESP_LOGI(TAG, "Temperature component initialized successfully.");
     return ESP_OK;
 }
 
-static uint32_t get_max_adc_value_from_enum(adc_bitwidth_t bitwidth_enum) {
-    switch (bitwidth_enum) {
-        case ADC_BITWIDTH_9:  return (1 << 9) - 1;
-        case ADC_BITWIDTH_10: return (1 << 10) - 1;
-        case ADC_BITWIDTH_11: return (1 << 11) - 1;
-        case ADC_BITWIDTH_12: return (1 << 12) - 1;
-        // ADC_BITWIDTH_DEFAULT is usually 12 on ESP32 series
-        case ADC_BITWIDTH_DEFAULT: return (1 << 12) - 1;
-        default:
-            ESP_LOGW(TAG, "Unknown ADC bitwidth enum %d, assuming 12-bit (4095 max)", bitwidth_enum);
-            return (1 << 12) - 1; // Default to 12-bit max value
-    }
-}
-
 static esp_err_t _read_adc_value(ThermistorConfig_t *thermistor, int *out_raw_value) {
     if (out_raw_value == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (s_adc_handle == NULL) {
-        ESP_LOGE(TAG, "ADC handle is not initialized for reading.");
+    adc_oneshot_unit_handle_t handle = s_adc_handles[thermistor->adc_unit];
+    if (handle == NULL) {
+        LOGE_RL(TAG, "ADC%d handle is not initialized for reading.", thermistor->adc_unit + 1);
         return ESP_ERR_INVALID_STATE;
     }
 
     adc_channel_t channel = (adc_channel_t)thermistor->adc_channel;
-    esp_err_t ret = adc_oneshot_read(s_adc_handle, channel, out_raw_value);
+    s_adc_claimed[thermistor->adc_unit] = true;
+    esp_err_t ret = adc_oneshot_read(handle, channel, out_raw_value);
+    for (int attempt = 0; ret == ESP_ERR_TIMEOUT && attempt < ADC_BUSY_RETRIES; ++attempt) {
+        if (attempt < ADC_BUSY_SPINS) {
+            esp_rom_delay_us(ADC_BUSY_SPIN_US);
+        } else {
+            vTaskDelay(1);
+        }
+        ret = adc_oneshot_read(handle, channel, out_raw_value);
+    }
+    s_adc_claimed[thermistor->adc_unit] = false;
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ADC read failed on channel %d: %s", channel, esp_err_to_name(ret));
+        LOG_FAULT_RL(ESP_LOG_ERROR, TAG, LOG_MSG_ADC_READ_FAILED, ((uint32_t)(thermistor - s_cached_therm_configs) + 1, channel, ret),
+                     "ADC read failed on channel %d: %s", channel, esp_err_to_name(ret));
     }
     return ret;
 }
 
-static esp_err_t _measure_temperature(ThermistorConfig_t *thermistor, float *out_temperature) {
-    if (out_temperature == NULL) {
+// Divider resistance (incl. calibration offset) of a code strictly inside (0, max_adc_val).
+// Ratiometric in both cases: the full-scale code stands for the divider supply, so the actual rail voltage
+// cancels out. Calibration only linearizes the ratio, with the calibrated voltages of the code and of the
+// full-scale code. NAN if the calibrated voltage is not inside that range; *out_mv is -1 without calibration.
+static float _code_to_resistance(const ThermistorConfig_t *thermistor, int adc_value, uint32_t max_adc_val, int *out_mv) {
+    int divider_resistor = thermistor->divider_resistor_value;
+    int calibration_offset = thermistor->calibration_resistance_offset;
+    const AdcCalTable_t *cal_table = &s_adc_cal_tables[thermistor->adc_unit];
+    if (!cal_table->valid) {
+        *out_mv = -1;
+        return (float)divider_resistor * adc_value / (max_adc_val - adc_value) + calibration_offset;
+    }
+    int adc_mv = temp_adc_cal_to_mv(cal_table, adc_value);
+    int full_scale_mv = temp_adc_cal_to_mv(cal_table, (int)max_adc_val);
+    *out_mv = adc_mv;
+    if (adc_mv <= 0 || adc_mv >= full_scale_mv) {
+        return NAN;
+    }
+    return (float)divider_resistor * adc_mv / (full_scale_mv - adc_mv) + calibration_offset;
+}
+
+static esp_err_t _measure_temperature(ThermistorConfig_t *thermistor, const ConversionState_t *conversion,
+                                      float *out_temperature, float *out_resistance, int *out_raw) {
+    if (out_temperature == NULL || out_resistance == NULL || out_raw == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
     int adc_value;
+    *out_raw = -1;
     esp_err_t ret = _read_adc_value(thermistor, &adc_value);
     if (ret != ESP_OK) {
         *out_temperature = NAN;
         return ret;
     }
-    int divider_resistor = thermistor->divider_resistor_value;
+    *out_raw = adc_value;
+    uint32_t index = (uint32_t)(thermistor - s_cached_therm_configs) + 1; // 1-based in log records, as in commands
     int calibration_offset = thermistor->calibration_resistance_offset;
     uint32_t max_adc_val = get_max_adc_value_from_enum(s_channel_config.bitwidth);
 
     if (adc_value <= 0 || adc_value >= max_adc_val) {
-        ESP_LOGW(TAG, "ADC value %d for %s is at or beyond limits (0, %"PRIu32"). Temp calculation may be inaccurate or NAN.", adc_value, thermistor->name, max_adc_val);
+        LOG_FAULT_RL(ESP_LOG_WARN, TAG, LOG_MSG_ADC_OUT_OF_RANGE, (index, adc_value, (uint32_t)-1),
+                     "ADC value %d for %s is at or beyond limits (0, %"PRIu32"). Temp calculation may be inaccurate or NAN.", adc_value, thermistor->name, max_adc_val);
         // For adc_value == 0, Rth -> 0. For adc_value == max_adc_val, Rth -> infinity.
         // Steinhart-Hart is not well-behaved at these extremes.
         if (adc_value <= 0) *out_temperature = HUGE_VALF; // Effectively very cold (Rth near 0)
@@ -197,35 +653,276 @@ static esp_err_t _measure_temperature(ThermistorConfig_t *thermistor, float *out
         return ESP_ERR_INVALID_STATE;
     }
 
-    float Rth = (float)divider_resistor * adc_value / (max_adc_val - adc_value) + calibration_offset;
+    int adc_mv;
+    float Rth = _code_to_resistance(thermistor, adc_value, max_adc_val, &adc_mv);
+    if (isnan(Rth)) {
+        LOG_FAULT_RL(ESP_LOG_WARN, TAG, LOG_MSG_ADC_OUT_OF_RANGE, (index, adc_value, adc_mv),
+                     "Calibrated voltage %d mV for %s is outside (0, %d) mV.", adc_mv, thermistor->name,
+                     temp_adc_cal_to_mv(&s_adc_cal_tables[thermistor->adc_unit], (int)max_adc_val));
+        *out_temperature = NAN;
+        return ESP_ERR_INVALID_STATE;
+    }
+    *out_resistance = Rth;
 
     if (Rth <= 0) { // Should not happen if adc_value is within (0, max_adc_val)
-        ESP_LOGE(TAG, "Calculated Rth <= 0 (%.2f) for %s, cannot compute log.", Rth, thermistor->name);
+        LOGE_RL(TAG, "Calculated Rth <= 0 (%.2f) for %s, cannot compute log.", Rth, thermistor->name);
         *out_temperature = NAN;
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Steinhart-Hart coefficients
-    const float A = 0.001129148f;
-    const float B = 0.000234125f;
-    const float C = 0.0000000876741f;
+    // Per-channel Steinhart-Hart / Beta model, precomputed on config refresh
+    *out_temperature = temp_model_to_celsius(conversion, Rth);
 
-    float logRth = logf(Rth);
-    float temp_k = 1.0f / (A + B * logRth + C * logRth * logRth * logRth);
-    *out_temperature = temp_k - 273.15f; // Convert Kelvin to Celsius
+    if (s_log_temp_measurements && log_comp_binary_active()) {
+        // Queued as raw words and formatted by the host, so logging does not stretch the scan
+        LOG_BIN(LOG_MSG_TEMP_SAMPLE, index, adc_value, adc_mv, log_comp_f32(Rth), log_comp_f32(*out_temperature));
+    } else if (s_log_temp_measurements) {
+        ESP_LOGI(TAG, "Thermistor %s: ADC %d (%d mV), Rth %.2f Ohm (incl. calibration offset: %d Ohm), Temp: %.2f C", thermistor->name, adc_value, adc_mv, Rth, calibration_offset, *out_temperature);
+    }
 
-    if (s_log_temp_measurements) {
-        ESP_LOGI(TAG, "Thermistor %s: ADC %d, Rth %.2f Ohm (incl. calibration offset: %d Ohm), Temp: %.2f C", thermistor->name, adc_value, Rth, calibration_offset, *out_temperature);
+    return ESP_OK;
+}
+
+static void _evaluate_alarms(int index, float temperature) {
+    TempAlarmEvent_t events[TEMP_ALARM_TYPE_COUNT];
+    int count = temp_alarm_evaluate(&s_alarm_states[index], &s_cached_therm_configs[index].alarm, index,
+                                    temperature, esp_timer_get_time(), events);
+    temp_alarm_callback_t callback = s_alarm_callback;
+    for (int e = 0; e < count; ++e) {
+        ESP_LOGW(TAG, "Alarm %s %s on %s (value %.2f)", temp_alarm_type_to_str(events[e].type),
+                 events[e].raised ? "raised" : "cleared", s_cached_therm_configs[index].name, events[e].value);
+        if (callback != NULL) {
+            callback(&events[e]);
+        }
     }
+}
+
+esp_err_t temp_comp_register_alarm_callback(temp_alarm_callback_t callback) {
+    s_alarm_callback = callback;
+    ESP_LOGI(TAG, "Alarm callback %s", callback != NULL ? "registered" : "unregistered");
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_register_rate_callback(temp_rate_callback_t callback) {
+    s_rate_callback = callback;
+    ESP_LOGI(TAG, "Rate change callback %s", callback != NULL ? "registered" : "unregistered");
+    return ESP_OK;
+}
 
+esp_err_t temp_comp_register_cycle_callback(temp_cycle_callback_t callback) {
+    s_cycle_callback = callback;
+    ESP_LOGI(TAG, "Cycle callback %s", callback != NULL ? "registered" : "unregistered");
     return ESP_OK;
 }
 
+int temp_comp_get_sampling_interval_ms(void) {
+    return s_effective_interval_ms;
+}
+
+esp_err_t temp_comp_get_alarm_state(int index, bool *active) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1 || active == NULL) {
+        ESP_LOGE(TAG, "Invalid thermistor index %d or null output pointer", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(active, s_alarm_states[index].active, sizeof(s_alarm_states[index].active));
+    return ESP_OK;
+}
+
+static void _run_adc_job(AdcJob_t *job) {
+    job->temperature = NAN;
+    job->resistance = NAN;
+    job->raw = -1;
+    job->ret = _measure_temperature(&s_cached_therm_configs[job->index], &s_conversion_states[job->index],
+                                    &job->temperature, &job->resistance, &job->raw);
+}
+
+static void _adc2_worker_task(void *arg) {
+    while (1) {
+        xSemaphoreTake(s_adc2_start, portMAX_DELAY);
+        _run_adc_job(&s_adc2_job);
+        xSemaphoreGive(s_adc2_done);
+    }
+}
+
+static void _start_adc2_worker(void) {
+    s_adc2_start = xSemaphoreCreateBinaryStatic(&s_adc2_start_struct);
+    s_adc2_done = xSemaphoreCreateBinaryStatic(&s_adc2_done_struct);
+    if (s_adc2_start != NULL && s_adc2_done != NULL) {
+        s_adc2_worker = xTaskCreateStaticPinnedToCore(_adc2_worker_task, "temp_adc2_worker", TEMP_ADC_WORKER_STACK_SIZE, NULL,
+                                                      TEMP_ADC_WORKER_PRIORITY, s_adc2_worker_stack, &s_adc2_worker_tcb,
+                                                      TEMP_ADC_WORKER_CORE);
+    }
+    if (s_adc2_worker == NULL) {
+        ESP_LOGW(TAG, "ADC2 worker not started, both units are read in turn.");
+    }
+}
+
+static void _burst_pace_tick(void *arg) {
+    xTaskNotifyGive(s_burst_task);
+}
+
+// One conversion, unless a scan holds the unit or config_comp is re-creating it
+static bool _burst_read(adc_unit_t unit, adc_channel_t channel, int *raw) {
+    adc_oneshot_unit_handle_t handle = s_adc_handles[unit];
+    return !s_adc_claimed[unit] && handle != NULL && adc_oneshot_read(handle, channel, raw) == ESP_OK;
+}
+
+// Spins on one channel while a capture runs. The only pauses are the backing off from a scan on the
+// same unit and a tick every TEMP_BURST_YIELD_US for the idle task (and its watchdog) on this core.
+// Paced captures (the noise diagnostic) block between samples instead: the pace timer wakes the task
+// once per period, which keeps the samples on the timer's grid and leaves the core free in between.
+// A paced sample held off by a scan is retried for half a period, then noted as a gap.
+static void _burst_task(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (s_burst.state != BURST_ARMED) {
+            continue; // A pace tick that raced the end of the previous capture
+        }
+        adc_unit_t unit = (adc_unit_t)s_burst_channel.adc_unit;
+        adc_channel_t channel = (adc_channel_t)s_burst_channel.adc_channel;
+        uint32_t pace_us = s_burst_pace_us;
+        if (pace_us > 0) {
+            esp_timer_start_periodic(s_burst_pace_timer, pace_us);
+        }
+        int64_t resume_us = esp_timer_get_time();
+        uint32_t reads = 0;
+        while ((s_burst.state == BURST_ARMED || s_burst.state == BURST_TRIGGERED) && !s_burst_stop_request) {
+            int64_t due_us = 0;
+            if (pace_us > 0) {
+                if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TEMP_BURST_YIELD_US / 1000)) == 0) {
+                    continue; // No tick: look at the stop request again
+                }
+                due_us = esp_timer_get_time();
+            } else if ((++reads & BURST_YIELD_CHECK_MASK) == 0 && esp_timer_get_time() - resume_us >= TEMP_BURST_YIELD_US) {
+                vTaskDelay(1);
+                temp_burst_note_gap(&s_burst);
+                resume_us = esp_timer_get_time();
+            }
+            int raw;
+            bool read = _burst_read(unit, channel, &raw);
+            while (!read && pace_us > 0 && esp_timer_get_time() - due_us < pace_us / 2) {
+                esp_rom_delay_us(BURST_PACED_RETRY_US);
+                read = _burst_read(unit, channel, &raw);
+            }
+            if (!read) {
+                if (pace_us > 0) {
+                    temp_burst_note_gap(&s_burst); // This period's sample is lost
+                    resume_us = esp_timer_get_time();
+                }
+                continue;
+            }
+            bool trigger = s_burst_trigger_request;
+            if (temp_burst_push(&s_burst, (uint16_t)raw, trigger)) {
+                s_burst_period_ns = (uint32_t)((esp_timer_get_time() - resume_us) * 1000 / s_burst.since_gap);
+                ESP_LOGI(TAG, "Burst capture %u done: %" PRIu32 " samples, %" PRIu32 " ns apart", (unsigned)s_burst_capture_id,
+                         temp_burst_length(&s_burst), s_burst_period_ns);
+            }
+            if (trigger) {
+                s_burst_trigger_request = false;
+            }
+        }
+        if (pace_us > 0) {
+            esp_timer_stop(s_burst_pace_timer);
+        }
+        if (s_burst_stop_request) {
+            s_burst.state = BURST_IDLE;
+            s_burst_stop_request = false;
+        }
+    }
+}
+
+static void _start_burst_sampler(void) {
+#if CONFIG_SPIRAM
+    s_burst_codes = heap_caps_malloc(TEMP_BURST_PSRAM_SAMPLES * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    temp_burst_init(&s_burst, s_burst_codes, TEMP_BURST_PSRAM_SAMPLES);
+#else
+    temp_burst_init(&s_burst, s_burst_codes, TEMP_BURST_INTERNAL_SAMPLES);
+#endif
+    if (s_burst.capacity == 0) {
+        ESP_LOGW(TAG, "No memory for the burst capture ring, burst capture disabled.");
+        return;
+    }
+    s_burst_task = xTaskCreateStaticPinnedToCore(_burst_task, "temp_burst", TEMP_BURST_STACK_SIZE, NULL, TEMP_BURST_PRIORITY,
+                                                 s_burst_task_stack, &s_burst_task_tcb, TEMP_BURST_CORE);
+    const esp_timer_create_args_t pace_timer_args = {
+        .callback = _burst_pace_tick,
+        .name = "temp_burst_pace",
+    };
+    if (s_burst_task != NULL && esp_timer_create(&pace_timer_args, &s_burst_pace_timer) != ESP_OK) {
+        ESP_LOGW(TAG, "No pace timer, the noise diagnostic is unavailable.");
+    }
+    ESP_LOGI(TAG, "Burst capture ring: %" PRIu32 " samples", s_burst.capacity);
+}
+
+// Caller holds s_temp_data_mutex
+static void _fill_output_locked(TemperatureOutputData_t *out) {
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (temp_scan_is_active(&s_cached_therm_configs[i])) {
+            strncpy(out->thermistor_names[i], s_cached_therm_configs[i].name, sizeof(out->thermistor_names[i]));
+            out->thermistor_names[i][sizeof(out->thermistor_names[i]) - 1] = '\0';
+        } else {
+            out->thermistor_names[i][0] = '\0';
+        }
+        out->temperatures[i] = s_latest_temperatures[i];
+        out->health[i] = s_health_snapshot[i].state;
+        out->raw_codes[i] = s_latest_raw_codes[i];
+    }
+    out->conversion_generation = s_conversion_generation;
+    out->cycle = s_cycle_count;
+}
+
+// Health, filter, adaptive rate, alarms, stats and the published values for one finished conversion
+static AdaptiveActivity_t _process_sample(const AdcJob_t *job, int max_adc_code, AdaptiveActivity_t activity) {
+    int i = job->index;
+    float current_temp_val = job->temperature;
+    ChannelHealth_t previous_health = s_health_states[i].state;
+    if (temp_health_update(&s_health_states[i], temp_health_classify(job->raw, max_adc_code), current_temp_val)) {
+        ESP_LOGW(TAG, "Thermistor %s health %s -> %s (next probe in %d cycles)", s_cached_therm_configs[i].name,
+                 temp_health_to_str(previous_health), temp_health_to_str(s_health_states[i].state),
+                 s_health_states[i].skip_remaining);
+    }
+
+    if (job->ret != ESP_OK) {
+        LOG_FAULT_RL(ESP_LOG_ERROR, TAG, LOG_MSG_MEASURE_FAILED, (i + 1, job->ret),
+                     "Failed to measure temperature for %s: %s. Storing NAN.",
+                     s_cached_therm_configs[i].name, esp_err_to_name(job->ret));
+        // current_temp_val is already NAN or set by _measure_temperature on error
+    }
+    current_temp_val = temp_filter_apply(&s_filter_states[i], &s_cached_therm_configs[i].filter, current_temp_val);
+    if (s_cached_adaptive.enabled && s_health_states[i].state == HEALTH_OK) { // Faulty or noisy probes must not pin the rate
+        activity = temp_adaptive_combine(activity, temp_adaptive_observe(&s_adaptive_channels[i], &s_cached_adaptive,
+                                                                         current_temp_val, esp_timer_get_time()));
+    }
+    _evaluate_alarms(i, current_temp_val);
+    temp_stats_add(&s_stats_accumulators[i], current_temp_val);
+
+    s_cycle_raw_codes[i] = job->raw >= 0 ? (uint16_t)job->raw : TEMP_RAW_CODE_NONE;
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) == pdTRUE) {
+        s_latest_temperatures[i] = current_temp_val;
+        s_latest_resistances[i] = job->resistance;
+        s_health_snapshot[i] = s_health_states[i];
+        xSemaphoreGive(s_temp_data_mutex);
+    }
+    return activity;
+}
+
 void temp_comp_measurement_task(void *arg) {
     ESP_LOGI(TAG, "Temperature measurement task started");
+
+    // Drift-free schedule: with automatic light sleep the delay below is a timer wakeup,
+    // and the distance between the due time and the actual start is the wake latency.
+    TickType_t last_wake_tick = xTaskGetTickCount();
+    const TickType_t base_tick = last_wake_tick;
+    const int64_t base_us = esp_timer_get_time();
+    const int max_adc_code = (int)get_max_adc_value_from_enum(s_channel_config.bitwidth);
+    config_comp_subscription_set_task(&s_config_subscription, xTaskGetCurrentTaskHandle(), CONFIG_EVENT_NOTIFY_BIT);
+    _start_adc2_worker();
+    _start_burst_sampler();
     while (1) {
+        temp_power_sample_begin(base_us + (int64_t)(last_wake_tick - base_tick) * portTICK_PERIOD_MS * 1000);
+
         if (s_config_needs_refresh) {
-            ESP_LOGI(TAG, "Configuration change detected, refreshing cache...");
+            ESP_LOGI(TAG, "Retrying configuration cache refresh...");
             if (temp_comp_refresh_cached_config_and_adc() == ESP_OK) {
                 s_config_needs_refresh = false; // Clear the flag only on success
                 ESP_LOGI(TAG, "Cache refreshed successfully.");
@@ -234,33 +931,223 @@ void temp_comp_measurement_task(void *arg) {
             }
         }
 
+        AdaptiveActivity_t activity = ADAPTIVE_CALM;
         for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
-
-            char *name = s_cached_therm_configs[i].name;
-            if (name[0] == '\0' || strcmp(name, "UNUSED") == 0) {
-                continue;
+            s_cycle_raw_codes[i] = TEMP_RAW_CODE_NONE;
+        }
+        for (int k = 0; k < s_scan_step_count; ++k) {
+            const ScanStep_t *step = &s_scan_steps[k];
+            AdcJob_t jobs[ADC_UNIT_COUNT];
+            bool any = false;
+            for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+                int i = step->index[unit];
+                // Open/short probe waiting for its re-probe: no conversion, stays NAN
+                jobs[unit].index = (i >= 0 && temp_health_should_sample(&s_health_states[i])) ? i : -1;
+                any |= jobs[unit].index >= 0;
             }
+            if (!any) {
+                continue; // No mux switch either
+            }
+            _select_mux_address(step->mux_address);
 
-            float current_temp_val = NAN; // Default to NAN
-            esp_err_t meas_ret = _measure_temperature(&s_cached_therm_configs[i], &current_temp_val);
-
-            if (meas_ret != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to measure temperature for %s: %s. Storing NAN.",
-                         s_cached_therm_configs[i].name, esp_err_to_name(meas_ret));
-                // current_temp_val is already NAN or set by _measure_temperature on error
+            bool offloaded = jobs[ADC_UNIT_2].index >= 0 && s_adc2_worker != NULL;
+            if (offloaded) {
+                s_adc2_job = jobs[ADC_UNIT_2];
+                xSemaphoreGive(s_adc2_start);
+            }
+            if (jobs[ADC_UNIT_1].index >= 0) {
+                _run_adc_job(&jobs[ADC_UNIT_1]);
+            }
+            if (offloaded) {
+                xSemaphoreTake(s_adc2_done, portMAX_DELAY);
+                jobs[ADC_UNIT_2] = s_adc2_job;
+            } else if (jobs[ADC_UNIT_2].index >= 0) {
+                _run_adc_job(&jobs[ADC_UNIT_2]);
             }
 
-            if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) == pdTRUE) {
-                s_latest_temperatures[i] = current_temp_val;
-                xSemaphoreGive(s_temp_data_mutex);
+            for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+                if (jobs[unit].index >= 0) {
+                    activity = _process_sample(&jobs[unit], max_adc_code, activity);
+                }
+            }
+        }
+        temp_cycle_callback_t cycle_callback = s_cycle_callback;
+        if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) == pdTRUE) {
+            memcpy(s_latest_raw_codes, s_cycle_raw_codes, sizeof(s_latest_raw_codes)); // The codes of exactly this cycle
+            s_cycle_count++;
+            if (cycle_callback != NULL) {
+                _fill_output_locked(&s_cycle_snapshot);
+            }
+            xSemaphoreGive(s_temp_data_mutex);
+            if (cycle_callback != NULL) {
+                cycle_callback(&s_cycle_snapshot);
             }
         }
+        boot_prof_mark(BOOT_PHASE_FIRST_SAMPLE);
+        _advance_stats_window();
+        if (s_cached_adaptive.enabled) {
+            int previous_ms = s_effective_interval_ms;
+            int interval_ms = temp_adaptive_next_interval(&s_adaptive_state, &s_cached_adaptive, activity);
+            _set_effective_interval(interval_ms, interval_ms < previous_ms ? "activity" : "calm");
+        }
         // if (s_log_temp_measurements) {
         //     temp_comp_get_latest_temps_json(temp_buffer, 2048);
         //     ESP_LOGI(TAG, "Latest temperatures JSON: %s", temp_buffer);
         // }
-        vTaskDelay(pdMS_TO_TICKS(s_cached_sampling_interval_ms));
+        temp_power_sample_end(s_effective_interval_ms);
+        _wait_next_cycle(&last_wake_tick);
+    }
+}
+
+esp_err_t temp_comp_get_latest_temps(TemperatureOutputData_t *out) {
+    if (out == NULL) {
+        ESP_LOGE(TAG, "Provided output data pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed to take temperature data mutex");
+        return ESP_FAIL;
+    }
+    _fill_output_locked(out);
+    xSemaphoreGive(s_temp_data_mutex);
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_get_raw_descriptor(TempRawDescriptor_t *out) {
+    if (out == NULL) {
+        ESP_LOGE(TAG, "Provided descriptor pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed to take temperature data mutex");
+        return ESP_FAIL;
     }
+    out->generation = s_conversion_generation;
+    out->max_code = (int)get_max_adc_value_from_enum(s_channel_config.bitwidth);
+    for (int unit = 0; unit < ADC_UNIT_COUNT; ++unit) {
+        out->adc_calibrated[unit] = s_adc_cal_tables[unit].valid;
+    }
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        TempRawChannel_t *channel = &out->channels[i];
+        channel->adc_unit = s_cached_therm_configs[i].adc_unit;
+        channel->divider_r = s_cached_therm_configs[i].divider_resistor_value;
+        channel->calibration_offset = s_cached_therm_configs[i].calibration_resistance_offset;
+        channel->model = s_cached_therm_configs[i].model;
+        channel->conversion = s_conversion_states[i];
+    }
+    xSemaphoreGive(s_temp_data_mutex);
+    return ESP_OK;
+}
+
+uint32_t temp_comp_get_adc_cal_mv(int unit, uint32_t offset, uint16_t *mv, uint32_t max) {
+    if (unit < 0 || unit >= ADC_UNIT_COUNT || mv == NULL || !s_adc_cal_tables[unit].valid) {
+        return 0;
+    }
+    const AdcCalTable_t *table = &s_adc_cal_tables[unit]; // Built once in init, read-only afterwards
+    uint32_t entries = (uint32_t)table->max_code + 1;
+    if (offset >= entries) {
+        return 0;
+    }
+    uint32_t count = entries - offset < max ? entries - offset : max;
+    memcpy(mv, &table->mv[offset], count * sizeof(uint16_t));
+    return count;
+}
+
+esp_err_t temp_comp_get_health(HealthState_t *out) {
+    if (out == NULL) {
+        ESP_LOGE(TAG, "Provided health output pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed to take temperature data mutex");
+        return ESP_FAIL;
+    }
+    memcpy(out, s_health_snapshot, sizeof(s_health_snapshot));
+    xSemaphoreGive(s_temp_data_mutex);
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_get_stats(TemperatureStatsData_t *out) {
+    if (out == NULL) {
+        ESP_LOGE(TAG, "Provided stats data pointer is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed to take temperature data mutex");
+        return ESP_FAIL;
+    }
+    memcpy(out, &s_completed_stats, sizeof(TemperatureStatsData_t));
+    xSemaphoreGive(s_temp_data_mutex);
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_cal_add_point(int index, float reference_c, float resistance_ohm) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1 || !isfinite(reference_c)) {
+        ESP_LOGE(TAG, "Invalid calibration point for thermistor index %d", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_cal_point_counts[index] >= MAX_CAL_POINTS) {
+        ESP_LOGE(TAG, "Thermistor %d already has %d calibration points, solve or clear first", index + 1, MAX_CAL_POINTS);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (isnan(resistance_ohm)) {
+        // Pair the reference with what the probe reads right now
+        if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) == pdTRUE) {
+            resistance_ohm = s_latest_resistances[index];
+            xSemaphoreGive(s_temp_data_mutex);
+        }
+    }
+    if (!(resistance_ohm > 0.0f)) {
+        ESP_LOGE(TAG, "No valid resistance reading for thermistor %d", index + 1);
+        return ESP_ERR_INVALID_STATE;
+    }
+    CalPoint_t *point = &s_cal_points[index][s_cal_point_counts[index]++];
+    point->resistance_ohm = resistance_ohm;
+    point->temperature_c = reference_c;
+    ESP_LOGI(TAG, "Calibration point %d for thermistor %d: %.2f Ohm at %.3f C",
+             s_cal_point_counts[index], index + 1, resistance_ohm, reference_c);
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_cal_get_points(int index, CalPoint_t *points, int *count) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1 || points == NULL || count == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *count = s_cal_point_counts[index];
+    memcpy(points, s_cal_points[index], sizeof(CalPoint_t) * (*count));
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_cal_clear(int index) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_cal_point_counts[index] = 0;
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_cal_solve(int index, ThermistorModel_t *model) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1 || model == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = config_comp_get_thermistor_model(index, model); // Keeps the fields the fit does not touch
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = temp_model_fit(s_cal_points[index], s_cal_point_counts[index], model);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Calibration fit for thermistor %d failed with %d points: %s",
+                 index + 1, s_cal_point_counts[index], esp_err_to_name(ret));
+        return ret;
+    }
+    ret = config_comp_set_thermistor_model(index, model); // Conversion state is rebuilt on the config refresh
+    if (ret == ESP_OK) {
+        s_cal_point_counts[index] = 0;
+    }
+    return ret;
 }
 
 esp_err_t temp_comp_get_latest_temps_json(char *buffer, size_t buffer_size) {
@@ -269,79 +1156,263 @@ esp_err_t temp_comp_get_latest_temps_json(char *buffer, size_t buffer_size) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    buffer[0] = '\0'; // Start with an empty string
-    size_t current_len = 0;
-    int written = 0;
-
-    // Acquire mutex to read latest temperatures
+    // Acquire mutex to read latest temperatures (and the template, rebuilt on config refresh)
     if (xSemaphoreTake(s_temp_data_mutex, portMAX_DELAY) != pdTRUE) {
         ESP_LOGE(TAG, "Failed to take temperature data mutex");
         return ESP_FAIL; // Or appropriate error
     }
+    ChannelHealth_t health[MAX_THERMISTOR_COUNT];
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        health[i] = s_health_snapshot[i].state;
+    }
+    esp_err_t ret = temp_json_format_frame(&s_json_template, s_latest_temperatures, health, buffer, buffer_size);
+    xSemaphoreGive(s_temp_data_mutex);
 
-    // Start the main JSON object
-    written = snprintf(buffer + current_len, buffer_size - current_len, "{\"names\":[");
-    if (written < 0 || written >= buffer_size - current_len) {
-        goto fail_buffer_too_small;
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Buffer too small for JSON output");
     }
-    current_len += written;
+    return ret;
+}
 
-    // Add thermistor names
-    bool first_name = true;
-    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
-        char *name = s_cached_therm_configs[i].name;
-        if (name[0] != '\0' && strcmp(name, "UNUSED") != 0) {
-            if (!first_name) {
-                written = snprintf(buffer + current_len, buffer_size - current_len, ",");
-                if (written < 0 || written >= buffer_size - current_len) goto fail_buffer_too_small;
-                current_len += written;
-            }
-            written = snprintf(buffer + current_len, buffer_size - current_len, "\"%s\"", name);
-            if (written < 0 || written >= buffer_size - current_len) goto fail_buffer_too_small;
-            current_len += written;
-            first_name = false;
+// First code past the crossing of level_c, by bisection over the monotonic code -> temperature curve of the channel.
+// The edge follows from which end of the code range is the hotter one (NTC below or above the divider).
+static esp_err_t _burst_level_to_code(const ThermistorConfig_t *thermistor, float level_c, bool rising,
+                                      BurstEdge_t *edge, int *level_code) {
+    ConversionState_t conversion;
+    temp_model_build(&thermistor->model, &conversion);
+    uint32_t max_adc_val = get_max_adc_value_from_enum(s_channel_config.bitwidth);
+    int mv;
+    int lo = 1;
+    int hi = (int)max_adc_val - 1;
+    float t_lo = temp_model_to_celsius(&conversion, _code_to_resistance(thermistor, lo, max_adc_val, &mv));
+    while (!isfinite(t_lo) && lo < hi) { // Codes the calibration maps outside the supply range
+        t_lo = temp_model_to_celsius(&conversion, _code_to_resistance(thermistor, ++lo, max_adc_val, &mv));
+    }
+    float t_hi = temp_model_to_celsius(&conversion, _code_to_resistance(thermistor, hi, max_adc_val, &mv));
+    while (!isfinite(t_hi) && hi > lo) {
+        t_hi = temp_model_to_celsius(&conversion, _code_to_resistance(thermistor, --hi, max_adc_val, &mv));
+    }
+    if (!((level_c - t_lo) * (level_c - t_hi) < 0.0f)) {
+        return ESP_ERR_INVALID_ARG; // Not inside the measurable range (or non-finite)
+    }
+    while (hi - lo > 1) {
+        int mid = lo + (hi - lo) / 2;
+        float t = temp_model_to_celsius(&conversion, _code_to_resistance(thermistor, mid, max_adc_val, &mv));
+        if ((t < level_c) == (t_lo < level_c)) {
+            lo = mid;
+        } else {
+            hi = mid;
         }
     }
+    *level_code = hi;
+    *edge = rising == (t_hi > t_lo) ? BURST_EDGE_UP : BURST_EDGE_DOWN;
+    return ESP_OK;
+}
 
-    // Close names array and start temperatures array
-    written = snprintf(buffer + current_len, buffer_size - current_len, "],\"temperatures\":[");
-    if (written < 0 || written >= buffer_size - current_len) goto fail_buffer_too_small;
-    current_len += written;
-
-    // Add temperatures
-    bool first_temp = true;
-    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
-         char *name = s_cached_therm_configs[i].name;
-        if (name[0] != '\0' && strcmp(name, "UNUSED") != 0) {
-            if (!first_temp) {
-                written = snprintf(buffer + current_len, buffer_size - current_len, ",");
-                if (written < 0 || written >= buffer_size - current_len) goto fail_buffer_too_small;
-                current_len += written;
-            }
-            // Use %.2f for temperature formatting (2 decimal places)
-            written = snprintf(buffer + current_len, buffer_size - current_len, "%.2f", s_latest_temperatures[i]);
-            if (written < 0 || written >= buffer_size - current_len) goto fail_buffer_too_small;
-            current_len += written;
-            first_temp = false;
+static esp_err_t _burst_arm(int index, uint32_t pre, uint32_t post, TempBurstTrigger_t trigger, float level_c, uint32_t pace_us) {
+    if (index < 0 || index > MAX_THERMISTOR_COUNT - 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_burst_task == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (s_burst.state == BURST_ARMED || s_burst.state == BURST_TRIGGERED) {
+        ESP_LOGE(TAG, "Burst capture already running, stop it first");
+        return ESP_ERR_INVALID_STATE;
+    }
+    ThermistorConfig_t thermistor;
+    esp_err_t ret = config_comp_get_thermistor_config(index, &thermistor);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (!temp_scan_is_active(&thermistor) || s_adc_handles[thermistor.adc_unit] == NULL) {
+        ESP_LOGE(TAG, "Thermistor %d is unused or its ADC unit is unavailable", index + 1);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (thermistor.mux_address != MUX_ADDRESS_DIRECT) {
+        ESP_LOGE(TAG, "Burst capture needs a directly wired channel, thermistor %d is on mux input %d", index + 1, thermistor.mux_address);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    BurstEdge_t edge = BURST_EDGE_NONE;
+    int level_code = 0;
+    if (trigger != TEMP_BURST_TRIGGER_COMMAND) {
+        ret = _burst_level_to_code(&thermistor, level_c, trigger == TEMP_BURST_TRIGGER_RISE, &edge, &level_code);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Trigger level %.2f C is outside the range of thermistor %d", level_c, index + 1);
+            return ret;
         }
     }
+    s_burst_channel = thermistor;
+    s_burst_pace_us = pace_us;
+    ret = temp_burst_arm(&s_burst, pre, post, edge, level_code);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Burst of %" PRIu32 " + %" PRIu32 " samples does not fit the %" PRIu32 "-sample ring", pre, post, s_burst.capacity);
+        return ret;
+    }
+    s_burst_index = index;
+    s_burst_trigger_mode = trigger;
+    s_burst_level_c = trigger != TEMP_BURST_TRIGGER_COMMAND ? level_c : 0.0f;
+    s_burst_capture_id++;
+    s_burst_dumped = false;
+    s_burst_period_ns = 0;
+    s_burst_trigger_request = false;
+    s_burst_stop_request = false;
+    xTaskNotifyGive(s_burst_task);
+    ESP_LOGI(TAG, "Burst capture %u armed on thermistor %d (level code %d)", (unsigned)s_burst_capture_id, index + 1, level_code);
+    return ESP_OK;
+}
 
-    // Close temperatures array and main object
-    written = snprintf(buffer + current_len, buffer_size - current_len, "]}");
-    if (written < 0 || written >= buffer_size - current_len) goto fail_buffer_too_small;
-    current_len += written;
+esp_err_t temp_comp_burst_arm(int index, uint32_t pre, uint32_t post, TempBurstTrigger_t trigger, float level_c) {
+    return _burst_arm(index, pre, post, trigger, level_c, 0);
+}
 
-    // Release mutex
-    xSemaphoreGive(s_temp_data_mutex);
+esp_err_t temp_comp_burst_trigger(void) {
+    if (s_burst.state != BURST_ARMED) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_burst_trigger_request = true;
+    return ESP_OK;
+}
 
-    // ESP_LOGD(TAG, "Generated JSON: %s", buffer);
+esp_err_t temp_comp_burst_stop(void) {
+    if (s_burst.state != BURST_ARMED && s_burst.state != BURST_TRIGGERED) {
+        s_burst.state = BURST_IDLE;
+        return ESP_OK;
+    }
+    s_burst_stop_request = true;
+    for (TickType_t waited = 0; s_burst_stop_request && waited < pdMS_TO_TICKS(100); ++waited) {
+        vTaskDelay(1);
+    }
+    return s_burst_stop_request ? ESP_ERR_TIMEOUT : ESP_OK;
+}
+
+esp_err_t temp_comp_burst_get_status(TempBurstStatus_t *out) {
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(TempBurstStatus_t));
+    out->state = s_burst.state;
+    out->index = s_burst_index;
+    out->capture_id = s_burst_capture_id;
+    out->capacity = s_burst.capacity;
+    out->pre = s_burst.pre;
+    out->post = s_burst.post;
+    out->trigger = s_burst_trigger_mode;
+    out->level_c = s_burst_level_c;
+    if (out->state == BURST_DONE) {
+        out->manual = s_burst.manual;
+        out->samples = temp_burst_length(&s_burst);
+        out->trigger_offset = s_burst.pre_count;
+        out->gap_free_from = out->samples - s_burst.gap_free;
+        out->period_ns = s_burst_period_ns;
+    } else if (out->state != BURST_IDLE) {
+        out->samples = s_burst.filled; // Progress only, updated by the sampler
+    }
     return ESP_OK;
+}
 
-    fail_buffer_too_small:
-        xSemaphoreGive(s_temp_data_mutex);
-        ESP_LOGE(TAG, "Buffer too small for JSON output");
-        // Ensure buffer is null-terminated even on failure if possible
-        if (buffer_size > 0) buffer[0] = '\0';
+uint32_t temp_comp_burst_read(uint32_t offset, uint16_t *codes, uint32_t max) {
+    if (codes == NULL) {
+        return 0;
+    }
+    uint32_t count = temp_burst_read(&s_burst, offset, codes, max);
+    if (count > 0 && offset + count >= temp_burst_length(&s_burst)) {
+        s_burst_dumped = true;
+    }
+    return count;
+}
+
+esp_err_t temp_comp_diag_noise_start(int index) {
+    if (s_burst.state == BURST_DONE && !s_burst_dumped) {
+        ESP_LOGE(TAG, "Burst capture %u has not been dumped, dump or stop it first", (unsigned)s_burst_capture_id);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_burst_task != NULL && s_burst_pace_timer == NULL) {
         return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = _burst_arm(index, 0, TEMP_NOISE_SAMPLES, TEMP_BURST_TRIGGER_COMMAND, 0.0f, TEMP_NOISE_PERIOD_US);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    s_burst_trigger_request = true; // The block starts with the next sample
+    s_noise_pending = true;
+    s_noise_capture_id = s_burst_capture_id;
+    s_noise_start_tick = xTaskGetTickCount();
+    return ESP_OK;
+}
+
+esp_err_t temp_comp_diag_noise_result(NoiseAnalysis_t *out) {
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_noise_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    int index = s_burst_index;
+    if (s_burst_capture_id != s_noise_capture_id || s_burst.state == BURST_IDLE) {
+        s_noise_pending = false;
+        ESP_LOGE(TAG, "Noise capture on thermistor %d was stopped", index + 1);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_burst.state != BURST_DONE) {
+        const TickType_t timeout = pdMS_TO_TICKS(2 * TEMP_NOISE_SAMPLES * TEMP_NOISE_PERIOD_US / 1000 + 100);
+        if (xTaskGetTickCount() - s_noise_start_tick < timeout) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+        s_noise_pending = false;
+        temp_comp_burst_stop();
+        ESP_LOGE(TAG, "Noise capture on thermistor %d timed out", index + 1);
+        return ESP_ERR_TIMEOUT;
+    }
+    s_noise_pending = false;
+
+    // Codes are read in chunks straight into the sample half of the work buffer
+    uint16_t codes[64];
+    uint32_t count = 0;
+    for (uint32_t n; (n = temp_burst_read(&s_burst, count, codes, 64)) > 0; count += n) {
+        for (uint32_t k = 0; k < n; ++k) {
+            s_noise_work[count + k] = codes[k];
+        }
+    }
+    s_burst_dumped = true; // Consumed by the analysis: a later diagnostic may replace it
+    float rate_hz = s_burst_period_ns > 0 ? 1e9f / s_burst_period_ns : 1e6f / TEMP_NOISE_PERIOD_US;
+    int bits = 0;
+    for (uint32_t max_code = get_max_adc_value_from_enum(s_channel_config.bitwidth); max_code > 0; max_code >>= 1) {
+        bits++;
+    }
+    esp_err_t ret = temp_noise_analyze(s_noise_work, (int)count, rate_hz, bits, out);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Temperature noise: the code noise through the local slope of the channel's curve
+    ConversionState_t conversion;
+    temp_model_build(&s_burst_channel.model, &conversion);
+    uint32_t max_adc_val = get_max_adc_value_from_enum(s_channel_config.bitwidth);
+    int code = (int)lroundf(out->mean_code);
+    if (code > 1 && code < (int)max_adc_val - 1) {
+        int mv;
+        float t_below = temp_model_to_celsius(&conversion, _code_to_resistance(&s_burst_channel, code - 1, max_adc_val, &mv));
+        float t_above = temp_model_to_celsius(&conversion, _code_to_resistance(&s_burst_channel, code + 1, max_adc_val, &mv));
+        out->rms_c = out->rms_lsb * fabsf(t_above - t_below) / 2.0f;
+    }
+    ESP_LOGI(TAG, "Noise on thermistor %d: %.2f LSB rms (%.4f C), ENOB %.1f, %d tones", index + 1, out->rms_lsb, out->rms_c,
+             out->enob, out->peak_count);
+    return ESP_OK;
+}
 
+size_t temp_comp_get_static_ram_bytes(void) {
+    // Per-channel state dominates; scalars and the small temp_* module statics are left out
+    return sizeof(s_cached_therm_configs) + sizeof(s_adaptive_channels) + sizeof(s_scan_steps) +
+           sizeof(s_latest_temperatures) + sizeof(s_latest_resistances) + sizeof(s_conversion_states) +
+           sizeof(s_cycle_raw_codes) + sizeof(s_latest_raw_codes) +
+           sizeof(s_cal_points) + sizeof(s_cal_point_counts) + sizeof(s_filter_states) + sizeof(s_alarm_states) +
+           sizeof(s_health_states) + sizeof(s_health_snapshot) + sizeof(s_stats_accumulators) +
+           sizeof(s_completed_stats) + sizeof(s_json_template) + sizeof(s_cycle_snapshot) + sizeof(s_adc_cal_tables) +
+           sizeof(s_config_subscription) + sizeof(s_config_events) + sizeof(s_temp_data_mutex_struct) +
+           sizeof(s_adc2_worker_tcb) + sizeof(s_adc2_worker_stack) + sizeof(s_adc2_start_struct) + sizeof(s_adc2_done_struct) +
+#if !CONFIG_SPIRAM
+           sizeof(s_burst_codes) +
+#endif
+           sizeof(s_burst) + sizeof(s_burst_channel) + sizeof(s_burst_task_tcb) + sizeof(s_burst_task_stack) + sizeof(s_noise_work);
 }
@@ -0,0 +1,73 @@
+#include "temp_filter.h"
+#include <string.h>
+#include <math.h>
+
+void temp_filter_reset(FilterState_t *state) {
+    memset(state, 0, sizeof(FilterState_t));
+}
+
+static float _median_stage(FilterState_t *state, int window, float sample) {
+    state->median_buf[state->median_head] = sample;
+    state->median_head = (state->median_head + 1) % window;
+    if (state->median_count < window) {
+        state->median_count++;
+    }
+
+    // Insertion sort of at most MAX_FILTER_MEDIAN_WINDOW values on the stack
+    float sorted[MAX_FILTER_MEDIAN_WINDOW];
+    int n = state->median_count;
+    for (int i = 0; i < n; ++i) {
+        float v = state->median_buf[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    // While the window is still filling, n may be even: average the middle pair
+    return (n % 2) ? sorted[n / 2] : 0.5f * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+static float _iir_stage(FilterState_t *state, float alpha, float sample) {
+    if (!state->iir_primed) {
+        state->iir_value = sample;
+        state->iir_primed = true;
+    } else {
+        state->iir_value += alpha * (sample - state->iir_value);
+    }
+    return state->iir_value;
+}
+
+static float _kalman_stage(FilterState_t *state, float q, float r, float sample) {
+    if (!state->kalman_primed) {
+        state->kalman_x = sample;
+        state->kalman_p = r;
+        state->kalman_primed = true;
+        return sample;
+    }
+    // Random-walk model: predict, then correct with the new measurement
+    float p = state->kalman_p + q;
+    float k = p / (p + r);
+    state->kalman_x += k * (sample - state->kalman_x);
+    state->kalman_p = (1.0f - k) * p;
+    return state->kalman_x;
+}
+
+float temp_filter_apply(FilterState_t *state, const FilterConfig_t *config, float sample) {
+    if (!isfinite(sample)) {
+        return sample;
+    }
+
+    float value = sample;
+    if (config->median_window > 1) {
+        value = _median_stage(state, config->median_window, value);
+    }
+    if (config->iir_alpha > 0.0f) {
+        value = _iir_stage(state, config->iir_alpha, value);
+    }
+    if (config->kalman_q > 0.0f) {
+        value = _kalman_stage(state, config->kalman_q, config->kalman_r, value);
+    }
+    return value;
+}
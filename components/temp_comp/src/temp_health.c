@@ -0,0 +1,128 @@
+#include "temp_health.h"
+#include <string.h>
+#include <math.h>
+
+void temp_health_reset(HealthState_t *state) {
+    memset(state, 0, sizeof(*state));
+    state->state = HEALTH_OK;
+    state->pending = HEALTH_OBS_VALID;
+}
+
+HealthObservation_t temp_health_classify(int raw, int max_code) {
+    if (raw < 0) {
+        return HEALTH_OBS_NONE;
+    }
+    if (raw == 0) {
+        return HEALTH_OBS_SHORT;    // Rth -> 0
+    }
+    if (raw >= max_code) {
+        return HEALTH_OBS_OPEN;     // Rth -> infinity
+    }
+    return HEALTH_OBS_VALID;
+}
+
+bool temp_health_should_sample(HealthState_t *state) {
+    if (state->skip_remaining == 0) {
+        return true;
+    }
+    state->skip_remaining--;
+    return false;
+}
+
+static void _enter_fault(HealthState_t *state, HealthObservation_t obs, bool new_fault) {
+    state->state = obs == HEALTH_OBS_OPEN ? HEALTH_OPEN : HEALTH_SHORT;
+    state->streak = 0;
+    state->has_previous = false;
+    if (new_fault) {
+        state->fault_count++;
+    }
+    // Exponential back-off: a probe that keeps failing costs less and less ADC time
+    if (state->backoff_cycles == 0) {
+        state->backoff_cycles = HEALTH_BACKOFF_MIN_CYCLES;
+    } else if (state->backoff_cycles < HEALTH_BACKOFF_MAX_CYCLES) {
+        state->backoff_cycles *= 2;
+    }
+    state->skip_remaining = state->backoff_cycles;
+}
+
+static void _update_noise(HealthState_t *state, float temp) {
+    if (state->has_previous && fabsf(temp - state->previous_temp) > HEALTH_NOISY_STEP_C) {
+        state->noise_score = state->noise_score + 2 > HEALTH_NOISY_SCORE ? HEALTH_NOISY_SCORE : state->noise_score + 2;
+    } else if (state->noise_score > 0) {
+        state->noise_score--;
+    }
+    state->has_previous = true;
+    state->previous_temp = temp;
+}
+
+bool temp_health_update(HealthState_t *state, HealthObservation_t obs, float temp) {
+    ChannelHealth_t before = state->state;
+    if (obs == HEALTH_OBS_NONE) {
+        return false;
+    }
+
+    switch (state->state) {
+        case HEALTH_OK:
+        case HEALTH_NOISY:
+            if (obs != HEALTH_OBS_VALID) {
+                state->state = HEALTH_SUSPECT;
+                state->pending = obs;
+                state->streak = 1;
+                break;
+            }
+            if (isfinite(temp)) {
+                _update_noise(state, temp);
+            }
+            if (state->noise_score >= HEALTH_NOISY_SCORE) {
+                state->state = HEALTH_NOISY;
+            } else if (state->noise_score == 0) {
+                state->state = HEALTH_OK;
+            }
+            break;
+
+        case HEALTH_SUSPECT:
+            if (obs == state->pending) {
+                // Debouncing a fault (pending OPEN/SHORT) or a recovery (pending VALID)
+                if (++state->streak >= HEALTH_DEBOUNCE_SAMPLES) {
+                    if (obs == HEALTH_OBS_VALID) {
+                        state->state = HEALTH_OK;
+                        state->backoff_cycles = 0;
+                        state->noise_score = 0;
+                        state->has_previous = false;
+                    } else {
+                        _enter_fault(state, obs, true);
+                    }
+                }
+            } else if (obs != HEALTH_OBS_VALID && state->backoff_cycles > 0) {
+                _enter_fault(state, obs, true); // Relapse while recovering: back to the (longer) back-off
+            } else {
+                state->pending = obs;
+                state->streak = 1;
+            }
+            break;
+
+        case HEALTH_OPEN:
+        case HEALTH_SHORT:
+            // Re-probe after the back-off
+            if (obs == HEALTH_OBS_VALID) {
+                state->state = HEALTH_SUSPECT;
+                state->pending = HEALTH_OBS_VALID;
+                state->streak = 1;
+            } else {
+                _enter_fault(state, obs, false); // Still faulted: double the back-off
+            }
+            break;
+    }
+    return state->state != before;
+}
+
+const char *temp_health_to_str(ChannelHealth_t state) {
+    switch (state) {
+        case HEALTH_OK:      return "ok";
+        case HEALTH_SUSPECT: return "suspect";
+        case HEALTH_OPEN:    return "open";
+        case HEALTH_SHORT:   return "short";
+        case HEALTH_NOISY:   return "noisy";
+        default:             return "unknown";
+    }
+}
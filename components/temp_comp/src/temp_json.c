@@ -0,0 +1,157 @@
+#include "temp_json.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "temp_scan.h"
+
+#define CENTI_FAST_PATH_LIMIT   1e9 // |value * 100| below this fits an int32 with room to spare
+
+static size_t _append(char *dst, size_t pos, const char *src, size_t len) {
+    memcpy(dst + pos, src, len);
+    return pos + len;
+}
+
+static size_t _template_add(JsonFrameTemplate_t *tpl, size_t len, int index, const char *name, size_t name_size) {
+    if (tpl->count > 0) {
+        tpl->prefix[len++] = ',';
+    }
+    tpl->prefix[len++] = '"';
+    len = _append(tpl->prefix, len, name, strnlen(name, name_size));
+    tpl->prefix[len++] = '"';
+    tpl->indices[tpl->count++] = index;
+    return len;
+}
+
+static void _template_close(JsonFrameTemplate_t *tpl, size_t len) {
+    len = _append(tpl->prefix, len, "],\"temperatures\":[", 18);
+    tpl->prefix[len] = '\0';
+    tpl->prefix_len = len;
+}
+
+void temp_json_build_template(const ThermistorConfig_t *configs, JsonFrameTemplate_t *tpl) {
+    size_t len = _append(tpl->prefix, 0, "{\"names\":[", 10);
+    tpl->count = 0;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (temp_scan_is_active(&configs[i])) {
+            len = _template_add(tpl, len, i, configs[i].name, sizeof(configs[i].name));
+        }
+    }
+    _template_close(tpl, len);
+}
+
+void temp_json_build_template_names(const char (*names)[TEMP_JSON_NAME_SIZE], const bool *mask, JsonFrameTemplate_t *tpl) {
+    size_t len = _append(tpl->prefix, 0, "{\"names\":[", 10);
+    tpl->count = 0;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (names[i][0] != '\0' && (mask == NULL || mask[i])) {
+            len = _template_add(tpl, len, i, names[i], TEMP_JSON_NAME_SIZE);
+        }
+    }
+    _template_close(tpl, len);
+}
+
+size_t temp_json_format_centi(float value, char *out) {
+    // value * 100 is exact in double (24 + 7 significant bits), so rounding it half-to-even
+    // reproduces the correctly rounded "%.2f" of the float.
+    double scaled = (double)value * 100.0;
+    if (!isfinite(value) || fabs(scaled) >= CENTI_FAST_PATH_LIMIT) {
+        char tmp[TEMP_JSON_VALUE_MAX];
+        int written = snprintf(tmp, sizeof(tmp), "%.2f", value);
+        if (written < 0) {
+            return 0;
+        }
+        size_t n = (size_t)written < sizeof(tmp) ? (size_t)written : sizeof(tmp) - 1;
+        memcpy(out, tmp, n);
+        return n;
+    }
+
+    uint32_t centi = (uint32_t)nearbyint(fabs(scaled)); // Default rounding mode: half to even
+    char digits[12];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + centi % 10);
+        centi /= 10;
+    } while (centi > 0 || n < 3); // At least "0.00"
+
+    size_t len = 0;
+    if (signbit(value)) {
+        out[len++] = '-'; // printf keeps the sign of negative values that round to zero
+    }
+    while (n > 2) {
+        out[len++] = digits[--n];
+    }
+    out[len++] = '.';
+    out[len++] = digits[1];
+    out[len++] = digits[0];
+    return len;
+}
+
+int temp_json_append_health(const ChannelHealth_t *health, const int *indices, int count,
+                            char *buffer, size_t buffer_size, size_t len) {
+    bool all_ok = true;
+    for (int k = 0; k < count && all_ok; ++k) {
+        all_ok = health[indices[k]] == HEALTH_OK;
+    }
+    if (all_ok) {
+        return (int)len; // Healthy frames stay byte-identical to the plain layout
+    }
+    int written = snprintf(buffer + len, buffer_size - len, ",\"health\":[");
+    if (written < 0 || (size_t)written >= buffer_size - len) return -1;
+    len += written;
+    for (int k = 0; k < count; ++k) {
+        written = snprintf(buffer + len, buffer_size - len, "%s\"%s\"", k ? "," : "", temp_health_to_str(health[indices[k]]));
+        if (written < 0 || (size_t)written >= buffer_size - len) return -1;
+        len += written;
+    }
+    written = snprintf(buffer + len, buffer_size - len, "]");
+    if (written < 0 || (size_t)written >= buffer_size - len) return -1;
+    return (int)(len + written);
+}
+
+esp_err_t temp_json_format_frame(const JsonFrameTemplate_t *tpl, const float *temps, const ChannelHealth_t *health,
+                                 char *buffer, size_t buffer_size) {
+    // Worst case per value is TEMP_JSON_VALUE_MAX plus a comma; the closing "]}" and terminator need 3
+    if (buffer_size < tpl->prefix_len + 3) {
+        goto fail_buffer_too_small;
+    }
+    size_t len = _append(buffer, 0, tpl->prefix, tpl->prefix_len);
+
+    for (int k = 0; k < tpl->count; ++k) {
+        if (buffer_size - len < TEMP_JSON_VALUE_MAX + 1 + 3) {
+            // Near the end of the buffer: format aside and copy only if it fits
+            char tmp[TEMP_JSON_VALUE_MAX + 1];
+            size_t n = 0;
+            if (k > 0) {
+                tmp[n++] = ',';
+            }
+            n += temp_json_format_centi(temps[tpl->indices[k]], tmp + n);
+            if (buffer_size - len < n + 3) {
+                goto fail_buffer_too_small;
+            }
+            len = _append(buffer, len, tmp, n);
+            continue;
+        }
+        if (k > 0) {
+            buffer[len++] = ',';
+        }
+        len += temp_json_format_centi(temps[tpl->indices[k]], buffer + len);
+    }
+
+    if (health != NULL) {
+        buffer[len++] = ']';
+        // One byte is kept for the closing '}'; the terminator fits where append_health ends its own
+        int health_len = temp_json_append_health(health, tpl->indices, tpl->count, buffer, buffer_size - 1, len);
+        if (health_len < 0) {
+            goto fail_buffer_too_small;
+        }
+        _append(buffer, health_len, "}", 2);
+        return ESP_OK;
+    }
+    _append(buffer, len, "]}", 3); // Includes the terminator
+    return ESP_OK;
+
+    fail_buffer_too_small:
+        if (buffer_size > 0) buffer[0] = '\0';
+        return ESP_ERR_NO_MEM;
+}
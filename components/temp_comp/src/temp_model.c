@@ -0,0 +1,82 @@
+#include "temp_model.h"
+#include <math.h>
+
+#define KELVIN_OFFSET   273.15
+#define T25_K           (25.0 + KELVIN_OFFSET)
+
+void temp_model_build(const ThermistorModel_t *model, ConversionState_t *state) {
+    if (model->type == THERM_MODEL_BETA) {
+        // 1/T = 1/T25 + (ln R - ln R25) / beta
+        state->k0 = (float)(1.0 / T25_K - log((double)model->r25) / (double)model->beta);
+        state->k1 = 1.0f / model->beta;
+        state->k3 = 0.0f;
+    } else {
+        state->k0 = model->a;
+        state->k1 = model->b;
+        state->k3 = model->c;
+    }
+}
+
+float temp_model_to_celsius(const ConversionState_t *state, float resistance_ohm) {
+    if (!(resistance_ohm > 0.0f)) {
+        return NAN;
+    }
+    float log_r = logf(resistance_ohm);
+    return 1.0f / (state->k0 + state->k1 * log_r + state->k3 * log_r * log_r * log_r) - (float)KELVIN_OFFSET;
+}
+
+static esp_err_t _fit_beta(const CalPoint_t *p, ThermistorModel_t *model) {
+    double y1 = 1.0 / (p[0].temperature_c + KELVIN_OFFSET);
+    double y2 = 1.0 / (p[1].temperature_c + KELVIN_OFFSET);
+    if (y1 == y2 || p[0].resistance_ohm == p[1].resistance_ohm) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    double beta = log((double)p[0].resistance_ohm / p[1].resistance_ohm) / (y1 - y2);
+    double r25 = p[0].resistance_ohm * exp(beta * (1.0 / T25_K - y1));
+    if (!(beta > 0.0) || !isfinite(beta) || !(r25 > 0.0) || !isfinite(r25)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    model->type = THERM_MODEL_BETA;
+    model->beta = (float)beta;
+    model->r25 = (float)r25;
+    return ESP_OK;
+}
+
+static esp_err_t _fit_steinhart_hart(const CalPoint_t *p, ThermistorModel_t *model) {
+    // Closed-form solution of the 3x3 system in double precision (runs once per calibration)
+    double l1 = log(p[0].resistance_ohm), l2 = log(p[1].resistance_ohm), l3 = log(p[2].resistance_ohm);
+    double y1 = 1.0 / (p[0].temperature_c + KELVIN_OFFSET);
+    double y2 = 1.0 / (p[1].temperature_c + KELVIN_OFFSET);
+    double y3 = 1.0 / (p[2].temperature_c + KELVIN_OFFSET);
+    if (l1 == l2 || l1 == l3 || l2 == l3 || l1 + l2 + l3 == 0.0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    double g2 = (y2 - y1) / (l2 - l1);
+    double g3 = (y3 - y1) / (l3 - l1);
+    double c = (g3 - g2) / (l3 - l2) / (l1 + l2 + l3);
+    double b = g2 - c * (l1 * l1 + l1 * l2 + l2 * l2);
+    double a = y1 - (b + l1 * l1 * c) * l1;
+    if (!isfinite(a) || !isfinite(b) || !isfinite(c) || !(b > 0.0)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    model->type = THERM_MODEL_STEINHART_HART;
+    model->a = (float)a;
+    model->b = (float)b;
+    model->c = (float)c;
+    return ESP_OK;
+}
+
+esp_err_t temp_model_fit(const CalPoint_t *points, int count, ThermistorModel_t *model) {
+    for (int i = 0; i < count; ++i) {
+        if (!(points[i].resistance_ohm > 0.0f) || !(points[i].temperature_c > -KELVIN_OFFSET)) {
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    if (count == 2) {
+        return _fit_beta(points, model);
+    }
+    if (count == 3) {
+        return _fit_steinhart_hart(points, model);
+    }
+    return ESP_ERR_INVALID_ARG;
+}
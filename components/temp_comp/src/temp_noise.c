@@ -0,0 +1,146 @@
+#include "temp_noise.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#if CONFIG_THERMISTRON_NOISE_ESP_DSP
+#include "dsps_fft2r.h"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// In-place DIT radix-2 FFT of n interleaved complex values, natural order in and out
+static void _fft_portable(float *data, int n) {
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float re = data[2 * i], im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        float angle = -2.0f * (float)M_PI / len;
+        float wr = cosf(angle), wi = sinf(angle);
+        for (int i = 0; i < n; i += len) {
+            float cr = 1.0f, ci = 0.0f;
+            for (int k = 0; k < len / 2; ++k) {
+                float *a = &data[2 * (i + k)];
+                float *b = &data[2 * (i + k + len / 2)];
+                float tr = b[0] * cr - b[1] * ci;
+                float ti = b[0] * ci + b[1] * cr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+                float next = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = next;
+            }
+        }
+    }
+}
+
+static void _fft(float *data, int n) {
+#if CONFIG_THERMISTRON_NOISE_ESP_DSP
+    static bool s_dsp_ready = false;
+    if (!s_dsp_ready) {
+        s_dsp_ready = dsps_fft2r_init_fc32(NULL, TEMP_NOISE_SAMPLES) == ESP_OK; // Twiddle table allocated once
+    }
+    if (s_dsp_ready && dsps_fft2r_fc32(data, n) == ESP_OK && dsps_bit_rev_fc32(data, n) == ESP_OK) {
+        return;
+    }
+#endif
+    _fft_portable(data, n);
+}
+
+static float _power(const float *spectrum, int k) {
+    return spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1];
+}
+
+esp_err_t temp_noise_analyze(float *work, int count, float sample_rate_hz, int bits, NoiseAnalysis_t *out) {
+    if (work == NULL || out == NULL || count < 8 || count > TEMP_NOISE_SAMPLES || (count & (count - 1)) != 0 ||
+        !(sample_rate_hz > 0.0f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(NoiseAnalysis_t));
+    out->samples = count;
+    out->sample_rate_hz = sample_rate_hz;
+    out->rms_c = NAN;
+
+    float sum = 0.0f, lo = work[0], hi = work[0];
+    for (int n = 0; n < count; ++n) {
+        sum += work[n];
+        lo = fminf(lo, work[n]);
+        hi = fmaxf(hi, work[n]);
+    }
+    float mean = sum / count;
+    float m2 = 0.0f;
+    for (int n = 0; n < count; ++n) {
+        m2 += (work[n] - mean) * (work[n] - mean);
+    }
+    out->mean_code = mean;
+    out->rms_lsb = sqrtf(m2 / count);
+    out->p2p_lsb = (int)(hi - lo);
+    float quantization_rms = out->rms_lsb * sqrtf(12.0f);
+    out->enob = quantization_rms > 1.0f ? bits - log2f(quantization_rms) : bits;
+    if (out->enob < 0.0f) out->enob = 0.0f;
+
+    // Mean-free, Hann-windowed, expanded backwards into interleaved complex so no second buffer is needed
+    for (int n = count - 1; n >= 0; --n) {
+        float window = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * n / count);
+        work[2 * n] = (work[n] - mean) * window;
+        work[2 * n + 1] = 0.0f;
+    }
+    _fft(work, count);
+
+    int half = count / 2;
+    float total_power = 0.0f;
+    for (int k = 1; k < half; ++k) {
+        total_power += _power(work, k);
+    }
+    if (!(total_power > 0.0f)) {
+        return ESP_OK; // Constant input: no tones
+    }
+    float threshold = TEMP_NOISE_PEAK_RATIO * total_power / (half - 1);
+    int peak_bins[TEMP_NOISE_PEAKS];
+    float peak_powers[TEMP_NOISE_PEAKS];
+    for (int k = 2; k < half - 1; ++k) { // Bins 0 and 1 hold the window's DC leakage
+        float p = _power(work, k);
+        if (p <= threshold || p <= _power(work, k - 1) || p < _power(work, k + 1)) {
+            continue;
+        }
+        int slot = out->peak_count < TEMP_NOISE_PEAKS ? out->peak_count++ : TEMP_NOISE_PEAKS;
+        while (slot > 0 && peak_powers[slot - 1] < p) { // Insertion keeps the strongest first
+            if (slot < TEMP_NOISE_PEAKS) {
+                peak_bins[slot] = peak_bins[slot - 1];
+                peak_powers[slot] = peak_powers[slot - 1];
+            }
+            --slot;
+        }
+        if (slot < TEMP_NOISE_PEAKS) {
+            peak_bins[slot] = k;
+            peak_powers[slot] = p;
+        }
+    }
+
+    float tone_power = 0.0f;
+    for (int i = 0; i < out->peak_count; ++i) {
+        int k = peak_bins[i];
+        float left = sqrtf(_power(work, k - 1)), center = sqrtf(peak_powers[i]), right = sqrtf(_power(work, k + 1));
+        float denominator = left - 2.0f * center + right;
+        float delta = denominator != 0.0f ? 0.5f * (left - right) / denominator : 0.0f; // Parabolic vertex, within +-0.5 bin
+        out->peaks[i].frequency_hz = (k + delta) * sample_rate_hz / count;
+        out->peaks[i].amplitude_lsb = 4.0f * center / count; // 2 / (sum of the Hann window = count / 2)
+        tone_power += _power(work, k - 1) + peak_powers[i] + _power(work, k + 1);
+    }
+    out->tone_fraction = fminf(tone_power / total_power, 1.0f);
+    return ESP_OK;
+}
@@ -0,0 +1,117 @@
+#include "temp_power.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_pm.h"
+#include <string.h>
+
+static const char *TAG = "temp_power";
+
+static esp_pm_lock_handle_t s_no_sleep_lock = NULL;
+static esp_pm_lock_handle_t s_cpu_freq_lock = NULL;
+
+static bool s_low_power = false;
+static int64_t s_sample_start_us = 0;
+static uint32_t s_samples = 0;
+static uint64_t s_wake_latency_sum_us = 0;
+static uint32_t s_wake_latency_max_us = 0;
+static uint64_t s_awake_sum_us = 0;
+static int s_last_interval_ms = 0;
+
+esp_err_t temp_power_init(void) {
+#if CONFIG_PM_ENABLE
+    esp_err_t ret = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "temp_no_sleep", &s_no_sleep_lock);
+    if (ret == ESP_OK) {
+        ret = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "temp_cpu_max", &s_cpu_freq_lock);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create power management locks: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#if !CONFIG_USJ_NO_AUTO_LS_ON_CONNECTION
+    ESP_LOGW(TAG, "CONFIG_USJ_NO_AUTO_LS_ON_CONNECTION is off, low-power mode is unavailable (light sleep drops the USB link)");
+#endif
+#else
+    ESP_LOGW(TAG, "CONFIG_PM_ENABLE is off, low-power mode is unavailable");
+#endif
+    return ESP_OK;
+}
+
+bool temp_power_low_power_supported(void) {
+    // Light sleep drops the USB Serial/JTAG link on the S3, and with it the host that would turn the mode off.
+    // CONFIG_USJ_NO_AUTO_LS_ON_CONNECTION makes the driver hold a no-light-sleep lock while a host is connected.
+#if CONFIG_PM_ENABLE && CONFIG_USJ_NO_AUTO_LS_ON_CONNECTION
+    return true;
+#else
+    return false;
+#endif
+}
+
+esp_err_t temp_power_set_mode(bool low_power) {
+    if (low_power && !temp_power_low_power_supported()) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#if CONFIG_PM_ENABLE
+    // Normal mode pins the CPU at the default frequency (the behaviour without power management);
+    // low-power mode lets DFS drop to XTAL and the idle task enter light sleep between samples.
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = low_power ? CONFIG_XTAL_FREQ : CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .light_sleep_enable = low_power,
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure power management: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#endif
+    s_low_power = low_power;
+    s_samples = 0;
+    s_wake_latency_sum_us = 0;
+    s_wake_latency_max_us = 0;
+    s_awake_sum_us = 0;
+    ESP_LOGI(TAG, "Automatic light sleep %s", low_power ? "enabled" : "disabled");
+    return ESP_OK;
+}
+
+void temp_power_sample_begin(int64_t scheduled_us) {
+    if (s_no_sleep_lock != NULL) {
+        esp_pm_lock_acquire(s_no_sleep_lock);
+        esp_pm_lock_acquire(s_cpu_freq_lock);
+    }
+    s_sample_start_us = esp_timer_get_time();
+    int64_t latency_us = s_sample_start_us - scheduled_us;
+    if (latency_us < 0) latency_us = 0;
+    s_wake_latency_sum_us += (uint64_t)latency_us;
+    if (latency_us > s_wake_latency_max_us) s_wake_latency_max_us = (uint32_t)latency_us;
+}
+
+void temp_power_sample_end(int interval_ms) {
+    s_awake_sum_us += (uint64_t)(esp_timer_get_time() - s_sample_start_us);
+    s_samples++;
+    s_last_interval_ms = interval_ms;
+    if (s_no_sleep_lock != NULL) {
+        esp_pm_lock_release(s_cpu_freq_lock);
+        esp_pm_lock_release(s_no_sleep_lock);
+    }
+}
+
+void temp_power_get_stats(TempPowerStats_t *out) {
+    memset(out, 0, sizeof(TempPowerStats_t));
+    out->low_power = s_low_power;
+    out->samples = s_samples;
+    if (s_samples == 0 || s_last_interval_ms <= 0) {
+        return;
+    }
+    out->wake_latency_avg_us = (uint32_t)(s_wake_latency_sum_us / s_samples);
+    out->wake_latency_max_us = s_wake_latency_max_us;
+    out->awake_avg_us = (uint32_t)(s_awake_sum_us / s_samples);
+
+    // Outside acquisition the chip idles at full current unless light sleep is enabled
+    uint64_t period_us = (uint64_t)s_last_interval_ms * 1000;
+    uint64_t awake_us = out->awake_avg_us < period_us ? out->awake_avg_us : period_us;
+    uint32_t idle_current_ua = s_low_power ? POWER_EST_SLEEP_CURRENT_UA : POWER_EST_ACTIVE_CURRENT_UA;
+    uint64_t charge_pc = (uint64_t)POWER_EST_ACTIVE_CURRENT_UA * awake_us + (uint64_t)idle_current_ua * (period_us - awake_us); // uA*us = pC
+    out->est_charge_per_sample_uc = (uint32_t)(charge_pc / 1000000);
+    out->est_avg_current_ua = (uint32_t)(charge_pc / period_us);
+}
@@ -0,0 +1,76 @@
+#include "temp_scan.h"
+#include <string.h>
+
+bool temp_scan_is_active(const ThermistorConfig_t *config) {
+    return config->name[0] != '\0' && strcmp(config->name, "UNUSED") != 0;
+}
+
+static bool _scans_before(const ThermistorConfig_t *a, const ThermistorConfig_t *b) {
+    if (a->mux_address != b->mux_address) {
+        return a->mux_address < b->mux_address; // MUX_ADDRESS_DIRECT (-1) sorts first
+    }
+    if (a->adc_unit != b->adc_unit) {
+        return a->adc_unit < b->adc_unit;
+    }
+    return a->adc_channel < b->adc_channel;
+}
+
+int temp_scan_build_order(const ThermistorConfig_t *configs, int *order_out) {
+    int count = 0;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!temp_scan_is_active(&configs[i])) {
+            continue;
+        }
+        // Stable insertion sort: at most 64 entries, rebuilt only on config changes
+        int j = count - 1;
+        while (j >= 0 && _scans_before(&configs[i], &configs[order_out[j]])) {
+            order_out[j + 1] = order_out[j];
+            j--;
+        }
+        order_out[j + 1] = i;
+        count++;
+    }
+    return count;
+}
+
+int temp_scan_build_steps(const ThermistorConfig_t *configs, const int *order, int count, ScanStep_t *steps_out) {
+    int steps = 0;
+    int group_start = 0;
+    while (group_start < count) {
+        int address = configs[order[group_start]].mux_address;
+        int group_end = group_start;
+        while (group_end < count && configs[order[group_end]].mux_address == address) {
+            group_end++;
+        }
+        // The group is sorted by unit: fill each unit's column of the group's steps in turn
+        int first_step = steps;
+        int filled[ADC_UNIT_COUNT] = {0};
+        for (int k = group_start; k < group_end; ++k) {
+            int unit = configs[order[k]].adc_unit;
+            int s = first_step + filled[unit]++;
+            if (s == steps) {
+                for (int u = 0; u < ADC_UNIT_COUNT; ++u) {
+                    steps_out[s].index[u] = -1;
+                }
+                steps_out[s].mux_address = address;
+                steps++;
+            }
+            steps_out[s].index[unit] = order[k];
+        }
+        group_start = group_end;
+    }
+    return steps;
+}
+
+int temp_scan_count_mux_switches(const ThermistorConfig_t *configs, const int *order, int count) {
+    int switches = 0;
+    int current = MUX_ADDRESS_DIRECT;
+    for (int k = 0; k < count; ++k) {
+        int address = configs[order[k]].mux_address;
+        if (address != MUX_ADDRESS_DIRECT && address != current) {
+            switches++;
+            current = address;
+        }
+    }
+    return switches;
+}
@@ -0,0 +1,36 @@
+#include "temp_stats.h"
+#include <string.h>
+#include <math.h>
+
+void temp_stats_reset(StatsAccumulator_t *acc) {
+    memset(acc, 0, sizeof(StatsAccumulator_t));
+}
+
+void temp_stats_add(StatsAccumulator_t *acc, float sample) {
+    if (!isfinite(sample)) {
+        return;
+    }
+    acc->count++;
+    if (acc->count == 1) {
+        acc->min = sample;
+        acc->max = sample;
+    } else {
+        if (sample < acc->min) acc->min = sample;
+        if (sample > acc->max) acc->max = sample;
+    }
+    float delta = sample - acc->mean;
+    acc->mean += delta / (float)acc->count;
+    acc->m2 += delta * (sample - acc->mean);
+}
+
+void temp_stats_summarize(const StatsAccumulator_t *acc, ChannelStats_t *out) {
+    out->count = acc->count;
+    if (acc->count == 0) {
+        out->min = out->max = out->mean = out->stddev = NAN;
+        return;
+    }
+    out->min = acc->min;
+    out->max = acc->max;
+    out->mean = acc->mean;
+    out->stddev = acc->count > 1 ? sqrtf(acc->m2 / (float)(acc->count - 1)) : 0.0f;
+}
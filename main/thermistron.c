@@ -13,12 +13,43 @@
 #include "esp_flash.h"
 #include "esp_system.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "log_comp.h"
+#include "boot_prof.h"
 #include "config_comp.h"
 #include "temp_comp.h"
 #include "serial_comp.h"
 
 static const char *TAG = "thermistron_main";
 
+#define SERIAL_BOOT_CORE (1 - TEMP_MEASUREMENT_CORE) // Link bring-up runs beside the config/ADC init, not behind it
+
+// Application tasks are created from static storage, so their stacks never come from (or fragment) the heap
+static StaticTask_t s_measurement_task_tcb;
+static StackType_t s_measurement_task_stack[TEMP_MEASUREMENT_STACK_SIZE];
+static StaticTask_t s_serial_task_tcb;
+static StackType_t s_serial_task_stack[SERIAL_STACK_SIZE];
+
+// Boot-time memory budget: RAM each component reserved at build time, then what is left on the heap
+static void log_memory_budget(void) {
+    size_t main_bytes = sizeof(s_measurement_task_tcb) + sizeof(s_measurement_task_stack) +
+                        sizeof(s_serial_task_tcb) + sizeof(s_serial_task_stack);
+    size_t config_bytes = config_comp_get_static_ram_bytes();
+    size_t temp_bytes = temp_comp_get_static_ram_bytes();
+    size_t serial_bytes = serial_comp_get_static_ram_bytes();
+    size_t log_bytes = log_comp_get_static_ram_bytes();
+    ESP_LOGI(TAG, "Memory budget (static, %d thermistor slots):", MAX_THERMISTOR_COUNT);
+    ESP_LOGI(TAG, "  config_comp %7u B", (unsigned)config_bytes);
+    ESP_LOGI(TAG, "  temp_comp   %7u B", (unsigned)temp_bytes);
+    ESP_LOGI(TAG, "  serial_comp %7u B", (unsigned)serial_bytes);
+    ESP_LOGI(TAG, "  log_comp    %7u B", (unsigned)log_bytes);
+    ESP_LOGI(TAG, "  main tasks  %7u B", (unsigned)main_bytes);
+    ESP_LOGI(TAG, "  total       %7u B", (unsigned)(config_bytes + temp_bytes + serial_bytes + log_bytes + main_bytes));
+    ESP_LOGI(TAG, "Heap: %u B free of %u B, largest block %u B, minimum free %u B",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT), (unsigned)heap_caps_get_total_size(MALLOC_CAP_8BIT),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT), (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+}
+
 void task_temperature_measurement(void *arg) {
     while (1) {
         // implement measurement business logic here
@@ -26,8 +57,37 @@ void task_temperature_measurement(void *arg) {
     }
 }
 
-void app_main(void)
-{
+// Serial link bring-up, concurrent with the config/ADC init in app_main: installs the USB driver and
+// starts the RX task, then waits for app_main's notification before processing commands
+// (serial_comp_task reads config_comp and temp_comp). The notification value is app_main's init
+// result: on failure the error is reported on the link instead, as commands would use uninitialized components.
+static void serial_boot_task(void *arg) {
+    esp_err_t ret = serial_comp_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize serial communication component: %s", esp_err_to_name(ret));
+    } else {
+        boot_prof_mark(BOOT_PHASE_SERIAL_INIT);
+        ESP_LOGI(TAG, "Serial communication component initialized successfully");
+    }
+
+    uint32_t init_result = ESP_OK;
+    xTaskNotifyWait(0, UINT32_MAX, &init_result, portMAX_DELAY); // app_main always notifies, so the task outlives it
+    if (ret != ESP_OK) {
+        vTaskDelete(NULL);
+        return;
+    }
+    if (init_result != ESP_OK) {
+        char report[64];
+        snprintf(report, sizeof(report), "{\"boot\":{\"error\":\"%s\"}}", esp_err_to_name((esp_err_t)init_result));
+        serial_comp_send(report);
+        vTaskDelete(NULL);
+        return;
+    }
+    boot_prof_mark(BOOT_PHASE_SERIAL_READY);
+    serial_comp_task(arg);
+}
+
+static void print_chip_info(void) {
     printf("Hello world!\n");
 
     /* Print chip information */
@@ -43,32 +103,48 @@ void app_main(void)
            (chip_info.features & CHIP_FEATURE_IEEE802154) ? ", 802.15.4 (Zigbee/Thread)" : "");
 
     fflush(stdout);
+}
+
+// Boot order is set by the time to the first sample: config and ADC, then temp_comp and the
+// measurement task. The serial link comes up on the other core meanwhile, and everything
+// informational (chip info, memory budget) waits until acquisition runs.
+void app_main(void)
+{
+    boot_prof_mark(BOOT_PHASE_APP_MAIN);
+
+    esp_err_t ret = log_comp_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to initialize log component, binary logging unavailable: %s", esp_err_to_name(ret));
+    }
+    boot_prof_mark(BOOT_PHASE_LOG);
 
-    esp_err_t ret = config_comp_init();
+    TaskHandle_t serial_task = xTaskCreateStaticPinnedToCore(serial_boot_task, "serial_comp_task", SERIAL_STACK_SIZE, NULL, 4,
+                                                             s_serial_task_stack, &s_serial_task_tcb, SERIAL_BOOT_CORE);
+
+    ret = config_comp_init();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize config component: %s", esp_err_to_name(ret));
+        xTaskNotify(serial_task, (uint32_t)ret, eSetValueWithOverwrite);
         return;
     }
+    boot_prof_mark(BOOT_PHASE_CONFIG);
     ESP_LOGI(TAG, "Configuration component initialized successfully");
 
     ret = temp_comp_init();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize temperature measurement component: %s", esp_err_to_name(ret));
+        xTaskNotify(serial_task, (uint32_t)ret, eSetValueWithOverwrite);
         return;
     }
+    boot_prof_mark(BOOT_PHASE_TEMP);
     ESP_LOGI(TAG, "Temperature measurement component initialized successfully");
 
-    ret = serial_comp_init();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize serial communication component: %s", esp_err_to_name(ret));
-        return;
-    }
-    ESP_LOGI(TAG, "Serial communication component initialized successfully");
-
+    xTaskCreateStaticPinnedToCore(temp_comp_measurement_task, "temperature_measurement_task", TEMP_MEASUREMENT_STACK_SIZE, NULL, 5,
+                                  s_measurement_task_stack, &s_measurement_task_tcb, TEMP_MEASUREMENT_CORE);
+    boot_prof_mark(BOOT_PHASE_ACQUISITION);
+    xTaskNotify(serial_task, ESP_OK, eSetValueWithOverwrite);
 
     ESP_LOGI(TAG, "Initialization complete");
-
-    xTaskCreate(temp_comp_measurement_task, "temperature_measurement_task", 4096, NULL, 5, NULL);
-    xTaskCreate(serial_comp_task, "serial_comp_task", SERIAL_STACK_SIZE, NULL, 4, NULL);
-
+    print_chip_info();
+    log_memory_budget();
 }
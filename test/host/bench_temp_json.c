@@ -0,0 +1,47 @@
+// Host benchmark: template serializer vs the snprintf frame it replaced, MAX_THERMISTOR_COUNT channels
+//   bench_temp_json [frames]
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "json_reference.h"
+
+static double _now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    long frames = argc > 1 ? atol(argv[1]) : 1000000;
+    static ThermistorConfig_t configs[MAX_THERMISTOR_COUNT];
+    static float temps[MAX_THERMISTOR_COUNT];
+    static ChannelHealth_t health[MAX_THERMISTOR_COUNT];
+    static char buffer[4096];
+    JsonFrameTemplate_t tpl;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        snprintf(configs[i].name, sizeof(configs[i].name), "probe_%d", i + 1);
+        temps[i] = 20.0f + 0.37f * i;
+    }
+    temp_json_build_template(configs, &tpl);
+
+    size_t sink = 0; // Keeps the loops from being optimized out
+    double start = _now_s();
+    for (long n = 0; n < frames; ++n) {
+        temps[n % MAX_THERMISTOR_COUNT] += 0.01f;
+        ref_format_frame(configs, temps, health, buffer, sizeof(buffer));
+        sink += (unsigned char)buffer[20];
+    }
+    double ref_s = _now_s() - start;
+
+    start = _now_s();
+    for (long n = 0; n < frames; ++n) {
+        temps[n % MAX_THERMISTOR_COUNT] += 0.01f;
+        temp_json_format_frame(&tpl, temps, health, buffer, sizeof(buffer));
+        sink += (unsigned char)buffer[20];
+    }
+    double tpl_s = _now_s() - start;
+
+    printf("%d channels, %ld frames: snprintf %.1f ns/frame, template %.1f ns/frame, %.1fx (%zu)\n",
+           MAX_THERMISTOR_COUNT, frames, ref_s * 1e9 / frames, tpl_s * 1e9 / frames, ref_s / tpl_s, sink % 10);
+    return 0;
+}
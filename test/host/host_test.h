@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal checks for the host tests: report every failure, exit non-zero if any failed
+static int s_host_test_failures = 0;
+
+#define CHECK(cond) do {                                                                    \
+        if (!(cond)) {                                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);        \
+            s_host_test_failures++;                                                         \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) do {                                                     \
+        long long _a = (long long)(actual), _e = (long long)(expected);                     \
+        if (_a != _e) {                                                                     \
+            fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__,       \
+                    #actual, _a, _e);                                                       \
+            s_host_test_failures++;                                                         \
+        }                                                                                   \
+    } while (0)
+
+#define HOST_TEST_RESULT(name) (fprintf(stderr, "%s: %s (%d failed checks)\n", name,        \
+                                        s_host_test_failures ? "FAILED" : "passed",         \
+                                        s_host_test_failures), s_host_test_failures != 0)
@@ -0,0 +1,55 @@
+#pragma once
+
+// The snprintf serializer temp_json replaced (one snprintf per token), kept as the reference the
+// host test and benchmark compare against. The health suffix is the one temp_json_append_health writes.
+#include <stdio.h>
+#include <string.h>
+#include "temp_json.h"
+#include "temp_scan.h"
+
+#define REF_APPEND(...) do {                                                                    \
+        int _w = snprintf(buffer + len, buffer_size - len, __VA_ARGS__);                        \
+        if (_w < 0 || (size_t)_w >= buffer_size - len) goto fail_buffer_too_small;              \
+        len += _w;                                                                              \
+    } while (0)
+
+static inline esp_err_t ref_format_frame(const ThermistorConfig_t *configs, const float *temps, const ChannelHealth_t *health,
+                                         char *buffer, size_t buffer_size) {
+    size_t len = 0;
+    if (buffer_size == 0) {
+        return ESP_ERR_NO_MEM;
+    }
+    REF_APPEND("{\"names\":[");
+    bool first = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!temp_scan_is_active(&configs[i])) continue;
+        REF_APPEND("%s\"%s\"", first ? "" : ",", configs[i].name);
+        first = false;
+    }
+    REF_APPEND("],\"temperatures\":[");
+    first = true;
+    bool all_ok = true;
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (!temp_scan_is_active(&configs[i])) continue;
+        REF_APPEND("%s%.2f", first ? "" : ",", temps[i]);
+        first = false;
+        all_ok = all_ok && (health == NULL || health[i] == HEALTH_OK);
+    }
+    REF_APPEND("]");
+    if (!all_ok) {
+        REF_APPEND(",\"health\":[");
+        first = true;
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            if (!temp_scan_is_active(&configs[i])) continue;
+            REF_APPEND("%s\"%s\"", first ? "" : ",", temp_health_to_str(health[i]));
+            first = false;
+        }
+        REF_APPEND("]");
+    }
+    REF_APPEND("}");
+    return ESP_OK;
+
+fail_buffer_too_small:
+    buffer[0] = '\0';
+    return ESP_ERR_NO_MEM;
+}
@@ -0,0 +1,5 @@
+#include "esp_err.h"
+
+const char *esp_err_to_name(esp_err_t code) {
+    return code == ESP_OK ? "ESP_OK" : "ESP_ERR";
+}
@@ -0,0 +1,3 @@
+#pragma once
+// Host build: the Kconfig values the tested modules read
+#define CONFIG_THERMISTRON_MAX_THERMISTORS 8
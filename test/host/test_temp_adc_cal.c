@@ -0,0 +1,131 @@
+// Host test of the calibration table: every entry against the (stubbed) driver conversion
+#include <string.h>
+#include "host_test.h"
+#include "temp_adc_cal.h"
+#include "esp_adc/adc_cali_scheme.h"
+
+// Fake curve-fitting scheme: a non-linear response that goes negative at the bottom codes, like a
+// real fit with its offset below zero
+static struct {
+    esp_err_t create_ret;
+    int       fail_at_code;         // adc_cali_raw_to_voltage fails from this code on, -1: never
+    int       created;
+    int       deleted;
+    int       max_code_seen;
+    adc_cali_curve_fitting_config_t config;
+} s_fake;
+
+static int _driver_mv(int raw) {
+    return -12 + raw * 3 / 4 + (raw * raw) / 40000;
+}
+
+esp_err_t adc_cali_create_scheme_curve_fitting(const adc_cali_curve_fitting_config_t *config, adc_cali_handle_t *handle) {
+    if (s_fake.create_ret != ESP_OK) {
+        return s_fake.create_ret;
+    }
+    s_fake.config = *config;
+    s_fake.created++;
+    *handle = (adc_cali_handle_t)&s_fake;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_delete_scheme_curve_fitting(adc_cali_handle_t handle) {
+    s_fake.deleted++;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage) {
+    if (handle != (adc_cali_handle_t)&s_fake) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (raw > s_fake.max_code_seen) {
+        s_fake.max_code_seen = raw;
+    }
+    if (s_fake.fail_at_code >= 0 && raw >= s_fake.fail_at_code) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *voltage = _driver_mv(raw);
+    return ESP_OK;
+}
+
+static AdcCalTable_t s_table;
+
+static void _reset(void) {
+    memset(&s_fake, 0, sizeof(s_fake));
+    s_fake.fail_at_code = -1;
+    s_fake.max_code_seen = -1;
+    memset(&s_table, 0xA5, sizeof(s_table)); // Entries past max_code must stay untouched
+    s_table.valid = true;
+}
+
+static void test_table_matches_driver(void) {
+    _reset();
+    CHECK_EQ(temp_adc_cal_build(&s_table, ADC_UNIT_2, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, 4095), ESP_OK);
+    CHECK(s_table.valid);
+    CHECK_EQ(s_table.unit, ADC_UNIT_2);
+    CHECK_EQ(s_table.atten, ADC_ATTEN_DB_12);
+    CHECK_EQ(s_table.max_code, 4095);
+    CHECK_EQ(s_fake.config.unit_id, ADC_UNIT_2);
+    CHECK_EQ(s_fake.config.atten, ADC_ATTEN_DB_12);
+    CHECK_EQ(s_fake.config.bitwidth, ADC_BITWIDTH_12);
+    CHECK_EQ(s_fake.max_code_seen, 4095);
+    CHECK_EQ(s_fake.created, 1);
+    CHECK_EQ(s_fake.deleted, 1); // The handle only lives while the table is filled
+
+    int mismatches = 0;
+    for (int raw = 0; raw <= 4095; ++raw) {
+        int expected = _driver_mv(raw) < 0 ? 0 : _driver_mv(raw); // Negative fits clamp to 0 mV
+        if (temp_adc_cal_to_mv(&s_table, raw) != expected) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK(_driver_mv(0) < 0);
+    CHECK_EQ(temp_adc_cal_to_mv(&s_table, 0), 0);
+}
+
+static void test_narrow_width_stops_at_max_code(void) {
+    _reset();
+    CHECK_EQ(temp_adc_cal_build(&s_table, ADC_UNIT_1, ADC_ATTEN_DB_6, ADC_BITWIDTH_10, 1023), ESP_OK);
+    CHECK(s_table.valid);
+    CHECK_EQ(s_table.max_code, 1023);
+    CHECK_EQ(s_fake.max_code_seen, 1023);
+    CHECK_EQ(temp_adc_cal_to_mv(&s_table, 1023), _driver_mv(1023));
+    CHECK_EQ(s_table.mv[1024], 0xA5A5);
+    CHECK_EQ(s_table.mv[ADC_CAL_TABLE_SIZE - 1], 0xA5A5);
+}
+
+static void test_conversion_failure_leaves_table_invalid(void) {
+    _reset();
+    s_fake.fail_at_code = 2000;
+    CHECK_EQ(temp_adc_cal_build(&s_table, ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, 4095), ESP_ERR_INVALID_STATE);
+    CHECK(!s_table.valid);
+    CHECK_EQ(s_fake.max_code_seen, 2000); // Stops at the first failing code
+    CHECK_EQ(s_fake.deleted, 1);          // and still releases the handle
+}
+
+static void test_missing_calibration(void) {
+    _reset();
+    s_fake.create_ret = ESP_ERR_NOT_SUPPORTED; // eFuses not burnt
+    CHECK_EQ(temp_adc_cal_build(&s_table, ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, 4095), ESP_ERR_NOT_SUPPORTED);
+    CHECK(!s_table.valid);
+    CHECK_EQ(s_fake.max_code_seen, -1);
+    CHECK_EQ(s_fake.deleted, 0);
+}
+
+static void test_invalid_arguments(void) {
+    _reset();
+    CHECK_EQ(temp_adc_cal_build(NULL, ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, 4095), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(temp_adc_cal_build(&s_table, ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, 0), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(temp_adc_cal_build(&s_table, ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, ADC_CAL_TABLE_SIZE), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(s_fake.created, 0);
+}
+
+int main(void) {
+    test_table_matches_driver();
+    test_narrow_width_stops_at_max_code();
+    test_conversion_failure_leaves_table_invalid();
+    test_missing_calibration();
+    test_invalid_arguments();
+    return HOST_TEST_RESULT("test_temp_adc_cal");
+}
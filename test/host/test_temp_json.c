@@ -0,0 +1,205 @@
+// Host test of the template serializer: byte-exact against "%.2f" and against the snprintf frame
+//   test_temp_json [values]   (default 2000000 random floats; the full check used 50000000)
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "host_test.h"
+#include "json_reference.h"
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t _next_u32(void) {
+    s_rng ^= s_rng << 13; // xorshift64: deterministic, so a failure reproduces
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return (uint32_t)(s_rng >> 32);
+}
+
+static float _bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Mostly the range thermistors report, plus arbitrary bit patterns (NaN, inf, huge, subnormal)
+static float _random_value(void) {
+    uint32_t r = _next_u32();
+    switch (r & 3) {
+        case 0:  return _bits_to_float(_next_u32());
+        case 1:  return ((float)_next_u32() / 4294967296.0f) * 400.0f - 100.0f;
+        case 2:  return (float)((int)(_next_u32() % 2000001) - 1000000) / 1000.0f + 0.005f; // Near ties
+        default: return ((float)_next_u32() / 4294967296.0f) * 2.0e7f - 1.0e7f;              // Around the fast-path limit
+    }
+}
+
+static int _check_value(float value) {
+    char expected[TEMP_JSON_VALUE_MAX + 8];
+    char actual[TEMP_JSON_VALUE_MAX + 8];
+    int expected_len = snprintf(expected, sizeof(expected), "%.2f", value);
+    size_t actual_len = temp_json_format_centi(value, actual);
+    if ((size_t)expected_len != actual_len || memcmp(expected, actual, actual_len) != 0) {
+        fprintf(stderr, "value %a: \"%s\" expected, got \"%.*s\"\n", value, expected, (int)actual_len, actual);
+        return 1;
+    }
+    return 0;
+}
+
+static void test_centi_edge_cases(void) {
+    static const float edges[] = {
+        0.0f, -0.0f, 0.001f, -0.001f, 0.004999f, -0.004999f, 0.005f, -0.005f, 0.015f, 0.125f, 0.375f, 2.675f,
+        1.005f, -1.005f, 99.995f, 100.0f, -273.15f, 25.0f, 0.1f, 0.01f, 9999999.0f, -9999999.0f, 1.0e7f, -1.0e7f,
+        1.0e9f, 3.4028235e38f, -3.4028235e38f, 1.0e-45f, -1.0e-45f, INFINITY, -INFINITY, NAN, -NAN,
+    };
+    int mismatches = 0;
+    for (size_t k = 0; k < sizeof(edges) / sizeof(edges[0]); ++k) {
+        mismatches += _check_value(edges[k]);
+    }
+    // Every value within +-2^16 ulps of the centi-degree ties around the usual range
+    for (int centi = -30000; centi <= 30000; centi += 7) {
+        float tie = (float)((centi + 0.5) / 100.0);
+        uint32_t bits;
+        memcpy(&bits, &tie, sizeof(bits));
+        for (int d = -3; d <= 3; ++d) {
+            mismatches += _check_value(_bits_to_float(bits + d));
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void test_centi_random(long count) {
+    long mismatches = 0;
+    for (long n = 0; n < count; ++n) {
+        mismatches += _check_value(_random_value());
+        if (mismatches > 20) break; // Enough to diagnose
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static ThermistorConfig_t s_configs[MAX_THERMISTOR_COUNT];
+static float s_temps[MAX_THERMISTOR_COUNT];
+static ChannelHealth_t s_health[MAX_THERMISTOR_COUNT];
+
+// Slot i active when bit i of mask is set, with a name of 1..9 characters
+static void _setup(unsigned mask, JsonFrameTemplate_t *tpl) {
+    memset(s_configs, 0, sizeof(s_configs));
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        if (mask & (1u << i)) {
+            int n = 1 + (int)(_next_u32() % (sizeof(s_configs[i].name) - 1));
+            for (int c = 0; c < n; ++c) s_configs[i].name[c] = (char)('a' + _next_u32() % 26);
+        } else if (_next_u32() & 1) {
+            strcpy(s_configs[i].name, "UNUSED");
+        }
+        s_temps[i] = _random_value();
+        s_health[i] = HEALTH_OK;
+    }
+    temp_json_build_template(s_configs, tpl);
+}
+
+// Formats into every buffer size from 0 to past the frame length and checks the result, the
+// emptied buffer on failure, and that nothing is written past buffer_size
+static int _check_frame_all_sizes(const JsonFrameTemplate_t *tpl, const ChannelHealth_t *health) {
+    static char expected[8192];
+    static char actual[8192 + 64];
+    if (ref_format_frame(s_configs, s_temps, health, expected, sizeof(expected)) != ESP_OK) {
+        fprintf(stderr, "reference frame does not fit\n");
+        return 1;
+    }
+    size_t frame_len = strlen(expected);
+    int failures = 0;
+    for (size_t size = 0; size <= frame_len + TEMP_JSON_VALUE_MAX + 8 && failures < 5; ++size) {
+        memset(actual, 0x5A, sizeof(actual));
+        esp_err_t ret = temp_json_format_frame(tpl, s_temps, health, actual, size);
+        bool fits = size > frame_len;
+        bool ok = fits ? ret == ESP_OK && strcmp(actual, expected) == 0
+                       : ret == ESP_ERR_NO_MEM && (size == 0 || actual[0] == '\0');
+        for (size_t b = size; b < sizeof(actual); ++b) {
+            ok = ok && actual[b] == 0x5A;
+        }
+        if (!ok) {
+            fprintf(stderr, "size %zu of %zu: ret %d, \"%s\" expected \"%s\"\n", size, frame_len + 1, ret,
+                    ret == ESP_OK ? actual : "", fits ? expected : "");
+            failures++;
+        }
+    }
+    return failures;
+}
+
+static void test_frame_matches_reference(void) {
+    JsonFrameTemplate_t tpl;
+    int failures = 0;
+    static const unsigned masks[] = {0x0, 0x1, 0x80, 0x5A, 0xFF};
+    for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]); ++m) {
+        for (int round = 0; round < 50; ++round) {
+            _setup(masks[m], &tpl);
+            failures += _check_frame_all_sizes(&tpl, NULL);
+            failures += _check_frame_all_sizes(&tpl, s_health); // All OK: no health suffix
+        }
+    }
+    CHECK_EQ(failures, 0);
+}
+
+static void test_frame_health_suffix(void) {
+    JsonFrameTemplate_t tpl;
+    char frame[2048];
+    int failures = 0;
+    for (int round = 0; round < 200; ++round) {
+        _setup(0xFF & ~(1u << (round % 8)), &tpl);
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            s_health[i] = (ChannelHealth_t)(_next_u32() % 5);
+        }
+        failures += _check_frame_all_sizes(&tpl, s_health);
+    }
+    CHECK_EQ(failures, 0);
+
+    // A fault on an unused slot does not add the suffix; one on a serialized slot does
+    _setup(0x3, &tpl);
+    s_temps[0] = 21.5f;
+    s_temps[1] = -0.004f;
+    s_health[5] = HEALTH_OPEN;
+    CHECK_EQ(temp_json_format_frame(&tpl, s_temps, s_health, frame, sizeof(frame)), ESP_OK);
+    CHECK(strstr(frame, "\"health\"") == NULL);
+    CHECK(strstr(frame, "\"temperatures\":[21.50,-0.00]}") != NULL);
+    s_health[1] = HEALTH_SHORT;
+    CHECK_EQ(temp_json_format_frame(&tpl, s_temps, s_health, frame, sizeof(frame)), ESP_OK);
+    CHECK(strstr(frame, "\"temperatures\":[21.50,-0.00],\"health\":[\"ok\",\"short\"]}") != NULL);
+}
+
+static bool _same_template(const JsonFrameTemplate_t *a, const JsonFrameTemplate_t *b) {
+    return a->prefix_len == b->prefix_len && memcmp(a->prefix, b->prefix, a->prefix_len + 1) == 0 &&
+           a->count == b->count && memcmp(a->indices, b->indices, a->count * sizeof(a->indices[0])) == 0;
+}
+
+// Templates from snapshot names (unused slots empty) match the ones built from the table, also for a subset
+static void test_template_from_names(void) {
+    JsonFrameTemplate_t expected, actual;
+    char names[MAX_THERMISTOR_COUNT][TEMP_JSON_NAME_SIZE];
+    int failures = 0;
+    for (int round = 0; round < 200; ++round) {
+        _setup(_next_u32() & 0xFF, &expected);
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            strcpy(names[i], temp_scan_is_active(&s_configs[i]) ? s_configs[i].name : "");
+        }
+        temp_json_build_template_names(names, NULL, &actual);
+        failures += !_same_template(&expected, &actual);
+
+        bool mask[MAX_THERMISTOR_COUNT];
+        for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+            mask[i] = _next_u32() & 1;
+            if (!mask[i]) s_configs[i].name[0] = '\0';
+        }
+        temp_json_build_template(s_configs, &expected);
+        temp_json_build_template_names(names, mask, &actual);
+        failures += !_same_template(&expected, &actual);
+    }
+    CHECK_EQ(failures, 0);
+}
+
+int main(int argc, char **argv) {
+    long count = argc > 1 ? atol(argv[1]) : 2000000;
+    test_centi_edge_cases();
+    test_centi_random(count);
+    test_frame_matches_reference();
+    test_frame_health_suffix();
+    test_template_from_names();
+    return HOST_TEST_RESULT("test_temp_json");
+}
@@ -0,0 +1,172 @@
+// Host test of the scan scheduler: acquisition order, both-unit steps and mux switch count
+#include <string.h>
+#include "host_test.h"
+#include "temp_scan.h"
+
+static ThermistorConfig_t s_configs[MAX_THERMISTOR_COUNT];
+
+static void _reset(void) {
+    memset(s_configs, 0, sizeof(s_configs)); // Empty names: every slot unused
+}
+
+static void _set(int i, const char *name, int unit, int channel, int mux_address) {
+    strncpy(s_configs[i].name, name, sizeof(s_configs[i].name) - 1);
+    s_configs[i].adc_unit = unit;
+    s_configs[i].adc_channel = channel;
+    s_configs[i].mux_address = mux_address;
+}
+
+static void _check_step(const ScanStep_t *step, int adc1, int adc2, int mux_address) {
+    CHECK_EQ(step->index[ADC_UNIT_1], adc1);
+    CHECK_EQ(step->index[ADC_UNIT_2], adc2);
+    CHECK_EQ(step->mux_address, mux_address);
+}
+
+static void test_empty_table(void) {
+    int order[MAX_THERMISTOR_COUNT];
+    ScanStep_t steps[MAX_THERMISTOR_COUNT];
+    _reset();
+    _set(0, "UNUSED", ADC_UNIT_1, 0, MUX_ADDRESS_DIRECT);
+    CHECK(!temp_scan_is_active(&s_configs[0]));
+    CHECK(!temp_scan_is_active(&s_configs[1]));
+    CHECK_EQ(temp_scan_build_order(s_configs, order), 0);
+    CHECK_EQ(temp_scan_build_steps(s_configs, order, 0, steps), 0);
+    CHECK_EQ(temp_scan_count_mux_switches(s_configs, order, 0), 0);
+}
+
+// Direct channels first, then mux groups; unit then channel within a group; unused slots skipped
+static void test_order_groups_by_mux_address(void) {
+    int order[MAX_THERMISTOR_COUNT];
+    _reset();
+    _set(0, "d_u1c3", ADC_UNIT_1, 3, MUX_ADDRESS_DIRECT);
+    _set(1, "UNUSED", ADC_UNIT_1, 0, MUX_ADDRESS_DIRECT);
+    _set(2, "m1_u1", ADC_UNIT_1, 0, 1);
+    _set(3, "d_u2c5", ADC_UNIT_2, 5, MUX_ADDRESS_DIRECT);
+    _set(4, "m0_u2", ADC_UNIT_2, 1, 0);
+    _set(5, "m1_u2", ADC_UNIT_2, 1, 1);
+    _set(6, "d_u1c1", ADC_UNIT_1, 1, MUX_ADDRESS_DIRECT);
+
+    static const int expected[] = {6, 0, 3, 4, 2, 5};
+    int count = temp_scan_build_order(s_configs, order);
+    CHECK_EQ(count, 6);
+    for (int k = 0; k < count && k < 6; ++k) {
+        CHECK_EQ(order[k], expected[k]);
+    }
+    // Every mux address is selected once per scan
+    CHECK_EQ(temp_scan_count_mux_switches(s_configs, order, count), 2);
+
+    // Same channels in slot order: mux 1, 0, 1 -> three switches
+    static const int interleaved[] = {2, 4, 5};
+    CHECK_EQ(temp_scan_count_mux_switches(s_configs, interleaved, 3), 3);
+    // Direct channels never switch the address lines
+    static const int direct_only[] = {0, 3, 6};
+    CHECK_EQ(temp_scan_count_mux_switches(s_configs, direct_only, 3), 0);
+}
+
+// Equal keys keep their slot order
+static void test_order_is_stable(void) {
+    int order[MAX_THERMISTOR_COUNT];
+    _reset();
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        char name[8];
+        snprintf(name, sizeof(name), "t%d", i);
+        _set(i, name, ADC_UNIT_1, 0, i % 2); // Two mux addresses, same unit and channel
+    }
+    int count = temp_scan_build_order(s_configs, order);
+    CHECK_EQ(count, MAX_THERMISTOR_COUNT);
+    for (int k = 0; k < count; ++k) {
+        int expected = k < MAX_THERMISTOR_COUNT / 2 ? 2 * k : 2 * (k - MAX_THERMISTOR_COUNT / 2) + 1;
+        CHECK_EQ(order[k], expected);
+    }
+    CHECK_EQ(temp_scan_count_mux_switches(s_configs, order, count), 2);
+}
+
+// Within an address the n-th channel of ADC1 pairs with the n-th of ADC2; groups never share a step
+static void test_steps_pair_units_per_address(void) {
+    int order[MAX_THERMISTOR_COUNT];
+    ScanStep_t steps[MAX_THERMISTOR_COUNT];
+    _reset();
+    _set(0, "d_u1c3", ADC_UNIT_1, 3, MUX_ADDRESS_DIRECT);
+    _set(2, "m1_u1", ADC_UNIT_1, 0, 1);
+    _set(3, "d_u2c5", ADC_UNIT_2, 5, MUX_ADDRESS_DIRECT);
+    _set(4, "m0_u2", ADC_UNIT_2, 1, 0);
+    _set(5, "m1_u2", ADC_UNIT_2, 1, 1);
+    _set(6, "d_u1c1", ADC_UNIT_1, 1, MUX_ADDRESS_DIRECT);
+
+    int count = temp_scan_build_order(s_configs, order);
+    int step_count = temp_scan_build_steps(s_configs, order, count, steps);
+    CHECK_EQ(step_count, 4);
+    if (step_count == 4) {
+        _check_step(&steps[0], 6, 3, MUX_ADDRESS_DIRECT);
+        _check_step(&steps[1], 0, -1, MUX_ADDRESS_DIRECT);     // ADC1 surplus of the direct group
+        _check_step(&steps[2], -1, 4, 0);                        // Alone on its address, not paired with slot 0
+        _check_step(&steps[3], 2, 5, 1);
+    }
+}
+
+// The busier unit's surplus gets steps of its own, in scan order, with the other unit idle
+static void test_steps_unbalanced_unit(void) {
+    int order[MAX_THERMISTOR_COUNT];
+    ScanStep_t steps[MAX_THERMISTOR_COUNT];
+    _reset();
+    _set(0, "a", ADC_UNIT_2, 0, MUX_ADDRESS_DIRECT);
+    _set(1, "b", ADC_UNIT_2, 1, MUX_ADDRESS_DIRECT);
+    _set(2, "c", ADC_UNIT_1, 4, MUX_ADDRESS_DIRECT);
+    _set(3, "d", ADC_UNIT_2, 2, MUX_ADDRESS_DIRECT);
+    _set(4, "e", ADC_UNIT_2, 3, 2);
+    _set(5, "f", ADC_UNIT_2, 4, 2);
+
+    int count = temp_scan_build_order(s_configs, order);
+    CHECK_EQ(count, 6);
+    int step_count = temp_scan_build_steps(s_configs, order, count, steps);
+    CHECK_EQ(step_count, 5);
+    if (step_count == 5) {
+        _check_step(&steps[0], 2, 0, MUX_ADDRESS_DIRECT);
+        _check_step(&steps[1], -1, 1, MUX_ADDRESS_DIRECT);
+        _check_step(&steps[2], -1, 3, MUX_ADDRESS_DIRECT);
+        _check_step(&steps[3], -1, 4, 2);
+        _check_step(&steps[4], -1, 5, 2);
+    }
+
+    // Every active channel is read exactly once
+    int seen[MAX_THERMISTOR_COUNT] = {0};
+    for (int s = 0; s < step_count; ++s) {
+        for (int u = 0; u < ADC_UNIT_COUNT; ++u) {
+            if (steps[s].index[u] >= 0) seen[steps[s].index[u]]++;
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        CHECK_EQ(seen[i], 1);
+    }
+}
+
+// A balanced wiring halves the steps
+static void test_steps_balanced_halves(void) {
+    int order[MAX_THERMISTOR_COUNT];
+    ScanStep_t steps[MAX_THERMISTOR_COUNT];
+    _reset();
+    for (int i = 0; i < MAX_THERMISTOR_COUNT; ++i) {
+        char name[8];
+        snprintf(name, sizeof(name), "t%d", i);
+        _set(i, name, i % 2 ? ADC_UNIT_2 : ADC_UNIT_1, i / 2, i / 4); // Two mux addresses, two channels per unit each
+    }
+    int count = temp_scan_build_order(s_configs, order);
+    CHECK_EQ(count, MAX_THERMISTOR_COUNT);
+    CHECK_EQ(temp_scan_build_steps(s_configs, order, count, steps), MAX_THERMISTOR_COUNT / 2);
+    CHECK_EQ(temp_scan_count_mux_switches(s_configs, order, count), 2);
+    for (int s = 0; s < MAX_THERMISTOR_COUNT / 2; ++s) {
+        CHECK(steps[s].index[ADC_UNIT_1] >= 0 && steps[s].index[ADC_UNIT_2] >= 0);
+        CHECK_EQ(s_configs[steps[s].index[ADC_UNIT_1]].mux_address, steps[s].mux_address);
+        CHECK_EQ(s_configs[steps[s].index[ADC_UNIT_2]].mux_address, steps[s].mux_address);
+    }
+}
+
+int main(void) {
+    test_empty_table();
+    test_order_groups_by_mux_address();
+    test_order_is_stable();
+    test_steps_pair_units_per_address();
+    test_steps_unbalanced_unit();
+    test_steps_balanced_halves();
+    return HOST_TEST_RESULT("test_temp_scan");
+}